@@ -0,0 +1,158 @@
+#include "bitboards.h"
+#include "sliding_attack_tables.h"
+#include <string.h>
+
+// ---------------------------
+// Leaper attack tables
+// ---------------------------
+// Built once at startup (1.5KB RAM total). Sliding attacks are computed by
+// ray scanning over the occupancy mask.
+
+namespace {
+
+uint64_t KNIGHT_ATTACKS[64];
+uint64_t KING_ATTACKS[64];
+uint64_t PAWN_ATTACKS[2][64]; // [0] = White pawn on sq, [1] = Black pawn on sq
+bool tablesReady = false;
+
+inline bool validSquare(int row, int col) {
+  return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+} // namespace
+
+namespace Bitboards {
+
+void init() {
+  if (tablesReady)
+    return;
+
+  static const int knightDeltas[8][2] = {{2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
+  static const int kingDeltas[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+  for (int sq = 0; sq < 64; sq++) {
+    int row = sq >> 3;
+    int col = sq & 7;
+
+    uint64_t knight = 0, king = 0;
+    for (int i = 0; i < 8; i++) {
+      if (validSquare(row + knightDeltas[i][0], col + knightDeltas[i][1]))
+        knight |= squareBit(row + knightDeltas[i][0], col + knightDeltas[i][1]);
+      if (validSquare(row + kingDeltas[i][0], col + kingDeltas[i][1]))
+        king |= squareBit(row + kingDeltas[i][0], col + kingDeltas[i][1]);
+    }
+    KNIGHT_ATTACKS[sq] = knight;
+    KING_ATTACKS[sq] = king;
+
+    // White pawns capture toward row - 1, Black pawns toward row + 1
+    uint64_t whitePawn = 0, blackPawn = 0;
+    if (validSquare(row - 1, col - 1)) whitePawn |= squareBit(row - 1, col - 1);
+    if (validSquare(row - 1, col + 1)) whitePawn |= squareBit(row - 1, col + 1);
+    if (validSquare(row + 1, col - 1)) blackPawn |= squareBit(row + 1, col - 1);
+    if (validSquare(row + 1, col + 1)) blackPawn |= squareBit(row + 1, col + 1);
+    PAWN_ATTACKS[0][sq] = whitePawn;
+    PAWN_ATTACKS[1][sq] = blackPawn;
+  }
+
+  tablesReady = true;
+}
+
+uint64_t knightAttacks(int sq) {
+  return KNIGHT_ATTACKS[sq];
+}
+
+uint64_t kingAttacks(int sq) {
+  return KING_ATTACKS[sq];
+}
+
+uint64_t pawnAttacks(char color, int sq) {
+  return PAWN_ATTACKS[(color == 'w') ? 0 : 1][sq];
+}
+
+// Classic blocked-ray lookup: take the full empty-board ray from the table,
+// find the first blocker with a bitscan toward the ray direction, and mask
+// off everything behind it by XORing the blocker's own ray.
+static inline uint64_t positiveRayAttack(int dir, int sq, uint64_t occupied) {
+  uint64_t attacks = RAY_ATTACKS[dir][sq];
+  uint64_t blockers = attacks & occupied;
+  if (blockers)
+    attacks ^= RAY_ATTACKS[dir][Bitboards::lsb(blockers)];
+  return attacks;
+}
+
+static inline uint64_t negativeRayAttack(int dir, int sq, uint64_t occupied) {
+  uint64_t attacks = RAY_ATTACKS[dir][sq];
+  uint64_t blockers = attacks & occupied;
+  if (blockers)
+    attacks ^= RAY_ATTACKS[dir][63 - __builtin_clzll(blockers)];
+  return attacks;
+}
+
+uint64_t rookAttacks(int sq, uint64_t occupied) {
+  return negativeRayAttack(RAY_N, sq, occupied) |
+         positiveRayAttack(RAY_S, sq, occupied) |
+         positiveRayAttack(RAY_E, sq, occupied) |
+         negativeRayAttack(RAY_W, sq, occupied);
+}
+
+uint64_t bishopAttacks(int sq, uint64_t occupied) {
+  return negativeRayAttack(RAY_NE, sq, occupied) |
+         negativeRayAttack(RAY_NW, sq, occupied) |
+         positiveRayAttack(RAY_SE, sq, occupied) |
+         positiveRayAttack(RAY_SW, sq, occupied);
+}
+
+uint64_t queenAttacks(int sq, uint64_t occupied) {
+  return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+} // namespace Bitboards
+
+// ---------------------------
+// PieceBitboards
+// ---------------------------
+
+void PieceBitboards::clear() {
+  memset(pieces, 0, sizeof(pieces));
+  occupied[0] = occupied[1] = 0;
+  all = 0;
+}
+
+void PieceBitboards::buildFromBoard(const char board[8][8]) {
+  Bitboards::init();
+  clear();
+  for (int row = 0; row < 8; row++)
+    for (int col = 0; col < 8; col++) {
+      char piece = board[row][col];
+      if (piece == ' ')
+        continue;
+      int idx = Bitboards::pieceIndex(piece);
+      if (idx < 0)
+        continue;
+      uint64_t bit = Bitboards::squareBit(row, col);
+      pieces[idx] |= bit;
+      occupied[idx < 6 ? 0 : 1] |= bit;
+    }
+  all = occupied[0] | occupied[1];
+}
+
+void PieceBitboards::setPiece(int pieceIdx, int sq) {
+  uint64_t bit = Bitboards::squareBit(sq);
+  pieces[pieceIdx] |= bit;
+  occupied[pieceIdx < 6 ? 0 : 1] |= bit;
+  all |= bit;
+}
+
+void PieceBitboards::clearPiece(int pieceIdx, int sq) {
+  uint64_t bit = Bitboards::squareBit(sq);
+  pieces[pieceIdx] &= ~bit;
+  occupied[pieceIdx < 6 ? 0 : 1] &= ~bit;
+  all = occupied[0] | occupied[1];
+}
+
+void PieceBitboards::movePiece(int pieceIdx, int fromSq, int toSq) {
+  uint64_t fromTo = Bitboards::squareBit(fromSq) | Bitboards::squareBit(toSq);
+  pieces[pieceIdx] ^= fromTo;
+  occupied[pieceIdx < 6 ? 0 : 1] ^= fromTo;
+  all = occupied[0] | occupied[1];
+}
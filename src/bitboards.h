@@ -0,0 +1,75 @@
+#ifndef BITBOARDS_H
+#define BITBOARDS_H
+
+#include <stdint.h>
+
+// ---------------------------
+// Bitboard position representation
+// ---------------------------
+// One uint64_t per piece type, kept parallel to the char[8][8] mailbox board.
+// Square mapping matches the Zobrist table: sq = row * 8 + col
+// (row 0 = rank 8, col 0 = file a), so bit (row * 8 + col) = that square.
+// Piece index order also matches the Zobrist table:
+// P=0, N=1, B=2, R=3, Q=4, K=5, p=6, n=7, b=8, r=9, q=10, k=11
+
+namespace Bitboards {
+
+inline constexpr uint64_t squareBit(int sq) {
+  return 1ULL << sq;
+}
+inline constexpr uint64_t squareBit(int row, int col) {
+  return 1ULL << (row * 8 + col);
+}
+inline int popcount(uint64_t bb) {
+  return __builtin_popcountll(bb);
+}
+// Index of the least significant set bit (bb must be non-zero)
+inline int lsb(uint64_t bb) {
+  return __builtin_ctzll(bb);
+}
+// Clear the least significant set bit
+inline uint64_t clearLsb(uint64_t bb) {
+  return bb & (bb - 1);
+}
+
+// Map a piece character to its bitboard/Zobrist index (-1 for ' ')
+inline int pieceIndex(char piece) {
+  const char* pieces = "PNBRQKpnbrqk";
+  const char* p = __builtin_strchr(pieces, piece);
+  return p ? (int)(p - pieces) : -1;
+}
+
+// Build the leaper attack tables (idempotent, called automatically)
+void init();
+
+// Attack set accessors. For pawns, `color` is the color of the pawn standing
+// on sq ('w' or 'b') and the result is the two capture squares.
+uint64_t knightAttacks(int sq);
+uint64_t kingAttacks(int sq);
+uint64_t pawnAttacks(char color, int sq);
+
+// Sliding attacks over an occupancy mask (attacks stop at and include the
+// first occupied square in each direction)
+uint64_t rookAttacks(int sq, uint64_t occupied);
+uint64_t bishopAttacks(int sq, uint64_t occupied);
+uint64_t queenAttacks(int sq, uint64_t occupied);
+
+} // namespace Bitboards
+
+// Per-piece-type bitboards plus derived occupancy masks
+struct PieceBitboards {
+  uint64_t pieces[12]; // indexed by Bitboards::pieceIndex
+  uint64_t occupied[2]; // [0] = White, [1] = Black
+  uint64_t all;
+
+  void clear();
+  // Rebuild all bitboards from the mailbox board (64 reads)
+  void buildFromBoard(const char board[8][8]);
+
+  // Incremental updates (callers must keep the mailbox in sync themselves)
+  void setPiece(int pieceIdx, int sq);
+  void clearPiece(int pieceIdx, int sq);
+  void movePiece(int pieceIdx, int fromSq, int toSq);
+};
+
+#endif // BITBOARDS_H
@@ -1,9 +1,14 @@
 #include "board_driver.h"
 #include "chess_utils.h"
+#include "core_layout.h"
 #include "led_colors.h"
+#include "perf_stats.h"
+#include "settings_cache.h"
 #include <Arduino.h>
 #include <Preferences.h>
+#include <esp_timer.h>
 #include <math.h>
+#include <soc/gpio_struct.h>
 
 // 74HC595 shift register pin mapping: bits are sent MSB first, so bit 7 shifts to QH, bit 0 stays at QA
 // col 0 -> QA (pin 15), col 1 -> QB (pin 1), ..., col 7 -> QH (pin 7)
@@ -17,10 +22,55 @@ static char shiftRegOutput(int col) {
 
 // Static members for animation queue system
 QueueHandle_t BoardDriver::animationQueue = nullptr;
+QueueHandle_t BoardDriver::feedbackQueue = nullptr;
+std::atomic<bool> BoardDriver::feedbackPending(false);
 TaskHandle_t BoardDriver::animationTaskHandle = nullptr;
 SemaphoreHandle_t BoardDriver::ledMutex = nullptr;
 BoardDriver* BoardDriver::instance = nullptr;
 
+// ---------------------------
+// Queued-blink dedup registry
+// ---------------------------
+// FreeRTOS queues can't be peeked entry by entry, so signatures of blinks
+// that are queued but not yet started live in this small set. A blinkSquare
+// call identical to one already waiting is dropped instead of queued twice.
+static portMUX_TYPE blinkSigMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t queuedBlinkSigs[8];
+static int queuedBlinkSigCount = 0;
+
+static uint32_t blinkSignature(const AnimationJob& job) {
+  const auto& b = job.params.blink;
+  uint32_t sig = ((uint32_t)b.row << 27) ^ ((uint32_t)b.col << 23) ^ ((uint32_t)b.color.r << 15) ^ ((uint32_t)b.color.g << 7) ^ ((uint32_t)b.color.b << 3) ^ ((uint32_t)b.times << 1) ^ (uint32_t)b.clearAfter;
+  return sig | 1; // Never zero so empty slots can't match
+}
+
+// Returns false when an identical blink is already waiting
+static bool registerBlink(uint32_t sig) {
+  bool fresh = true;
+  portENTER_CRITICAL(&blinkSigMux);
+  for (int i = 0; i < queuedBlinkSigCount; i++)
+    if (queuedBlinkSigs[i] == sig)
+      fresh = false;
+  if (fresh && queuedBlinkSigCount < (int)(sizeof(queuedBlinkSigs) / sizeof(queuedBlinkSigs[0])))
+    queuedBlinkSigs[queuedBlinkSigCount++] = sig;
+  portEXIT_CRITICAL(&blinkSigMux);
+  return fresh;
+}
+
+static void unregisterBlink(uint32_t sig) {
+  portENTER_CRITICAL(&blinkSigMux);
+  for (int i = 0; i < queuedBlinkSigCount; i++)
+    if (queuedBlinkSigs[i] == sig) {
+      queuedBlinkSigs[i] = queuedBlinkSigs[--queuedBlinkSigCount];
+      break;
+    }
+  portEXIT_CRITICAL(&blinkSigMux);
+}
+
+// Static members for sensor scanning task
+QueueHandle_t BoardDriver::sensorEventQueue = nullptr;
+TaskHandle_t BoardDriver::sensorTaskHandle = nullptr;
+
 // ---------------------------
 // LED Strip Col/Row to Pixel index mapping (default)
 // ---------------------------
@@ -35,7 +85,7 @@ static constexpr int DefaultRowColToLEDindexMap[NUM_ROWS][NUM_COLS] = {
     {63, 62, 61, 60, 59, 58, 57, 56},
 };
 
-BoardDriver::BoardDriver() : strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800), lastEnabledCol(-2), brightness(BRIGHTNESS), dimMultiplier(70), swapAxes(0), calibrationLoaded(false), hwConfig(HardwareConfig::defaults()) {
+BoardDriver::BoardDriver() : strip(LED_COUNT, LED_PIN), lastEnabledCol(-2), brightness(BRIGHTNESS), dimMultiplier(70), frameDirty(true), lastFrameMs(0), scanSettleUs(SENSOR_SETTLE_MAX_US), scanFrameTimeUs(0), swapAxes(0), calibrationLoaded(false), hwConfig(HardwareConfig::defaults()) {
   for (int i = 0; i < NUM_ROWS; i++)
     toLogicalRow[i] = i;
   for (int i = 0; i < NUM_COLS; i++)
@@ -44,7 +94,14 @@ BoardDriver::BoardDriver() : strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800), la
     for (int col = 0; col < NUM_COLS; col++) {
       ledIndexMap[row][col] = DefaultRowColToLEDindexMap[row][col];
       currentColors[row][col] = LedColors::Off;
+      renderedColors[row][col] = 0;
     }
+  rebuildDimLut();
+}
+
+void BoardDriver::rebuildDimLut() {
+  for (int i = 0; i < 256; i++)
+    dimLut[i] = (uint8_t)(i * dimMultiplier / 100);
 }
 
 void BoardDriver::begin() {
@@ -52,7 +109,7 @@ void BoardDriver::begin() {
   loadHardwareConfig();
   // Re-initialize strip with the (possibly NVS-overridden) LED pin
   strip.setPin(hwConfig.ledPin);
-  // Initialize NeoPixel strip
+  // Initialize LED strip (RMT hardware transmission, see rmt_led_strip.h)
   strip.begin();
   showLEDs();        // turn off all LEDs
   loadLedSettings(); // Load LED settings from NVS (brightness, dim multiplier)
@@ -72,13 +129,18 @@ void BoardDriver::begin() {
       sensorPrev[row][col] = false;
       sensorRaw[row][col] = false;
       sensorDebounceTime[row][col] = 0;
+      stableFrames[row][col] = 0;
+      chatterScore[row][col] = 0;
+      slowDebounce[row][col] = false;
     }
+  lastChatterDecay = millis();
 
   // Initialize animation queue system
   instance = this;
   ledMutex = xSemaphoreCreateMutex();
   animationQueue = xQueueCreate(8, sizeof(AnimationJob));
-  xTaskCreatePinnedToCore(animationWorkerTask, "AnimWorker", 4096, nullptr, 1, &animationTaskHandle, 1);
+  feedbackQueue = xQueueCreate(8, sizeof(AnimationJob));
+  xTaskCreatePinnedToCore(animationWorkerTask, "AnimWorker", 4096, nullptr, 1, &animationTaskHandle, CORE_REALTIME);
 
   // Load calibration or run first-time calibration
   if (!loadCalibration()) {
@@ -87,13 +149,41 @@ void BoardDriver::begin() {
       saveCalibration();
     }
   }
+
+  // Start continuous sensor scanning on the realtime core (core_layout.h).
+  // Must start after calibration: calibration drives the shift register and
+  // row pins directly and can't share them with the scan task.
+  sensorEventQueue = xQueueCreate(SENSOR_EVENT_QUEUE_LEN, sizeof(SensorEvent));
+  xTaskCreatePinnedToCore(sensorScanTask, "SensorScan", 2048, nullptr, 2, &sensorTaskHandle, CORE_REALTIME);
+}
+
+// Sensor scanning task - sweeps the matrix continuously so debounced state
+// stays fresh even while the main loop is blocked (network requests, file
+// I/O), and every transition is captured in the event queue with a timestamp
+void BoardDriver::sensorScanTask(void* param) {
+  instance->calibrateScanSettle();
+  while (true) {
+    instance->scanMatrix();
+    vTaskDelay(pdMS_TO_TICKS(SENSOR_SCAN_PERIOD_MS));
+  }
 }
 
-// Animation worker task - processes jobs from queue
+// Animation worker task - drains both queues whenever queueAnimation
+// notifies it, always emptying the feedback queue before touching a
+// decorative job
 void BoardDriver::animationWorkerTask(void* param) {
   AnimationJob job;
   while (true) {
-    if (xQueueReceive(animationQueue, &job, portMAX_DELAY) == pdTRUE) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (true) {
+      if (xQueueReceive(feedbackQueue, &job, 0) == pdTRUE) {
+        if (job.type == AnimationType::BLINK)
+          unregisterBlink(blinkSignature(job));
+        if (uxQueueMessagesWaiting(feedbackQueue) == 0)
+          feedbackPending.store(false);
+      } else if (xQueueReceive(animationQueue, &job, 0) != pdTRUE) {
+        break;
+      }
       xSemaphoreTake(ledMutex, portMAX_DELAY);
       instance->executeAnimation(job);
       xSemaphoreGive(ledMutex);
@@ -101,6 +191,32 @@ void BoardDriver::animationWorkerTask(void* param) {
   }
 }
 
+// Route a job to the right queue and wake the worker
+void BoardDriver::queueAnimation(const AnimationJob& job) {
+  if (job.type == AnimationType::BLINK && !registerBlink(blinkSignature(job)))
+    return; // Identical blink already waiting
+  if (job.type == AnimationType::BLINK || job.type == AnimationType::FLASH) {
+    feedbackPending.store(true);
+    xQueueSend(feedbackQueue, &job, portMAX_DELAY);
+  } else {
+    xQueueSend(animationQueue, &job, portMAX_DELAY);
+  }
+  xTaskNotifyGive(animationTaskHandle);
+}
+
+// Run queued feedback jobs immediately. Called from within the long
+// cancellable animations (waiting, thinking), which already hold the LED
+// mutex and would otherwise sit on it for seconds.
+void BoardDriver::serviceFeedbackJobs() {
+  AnimationJob job;
+  while (xQueueReceive(feedbackQueue, &job, 0) == pdTRUE) {
+    if (job.type == AnimationType::BLINK)
+      unregisterBlink(blinkSignature(job));
+    executeAnimation(job);
+  }
+  feedbackPending.store(false);
+}
+
 void BoardDriver::executeAnimation(const AnimationJob& job) {
   switch (job.type) {
     case AnimationType::CAPTURE:
@@ -321,6 +437,7 @@ bool BoardDriver::waitForSingleRawPress(int& rawRow, int& rawCol, unsigned long
 void BoardDriver::showCalibrationError() {
   for (int i = 0; i < LED_COUNT; i++)
     strip.setPixelColor(i, strip.Color(LedColors::Red.r, LedColors::Red.g, LedColors::Red.b));
+  frameDirty = true; // Raw strip writes bypass the framebuffer tracking
   showLEDs();
   delay(500);
   waitForBoardEmpty();
@@ -454,6 +571,7 @@ bool BoardDriver::runCalibration() {
   // Calibration animation - light up each pixel sequentially
   for (int i = 0; i < LED_COUNT; i++) {
     strip.setPixelColor(i, strip.Color(LedColors::White.r, LedColors::White.g, LedColors::White.b));
+    frameDirty = true; // Raw strip write, not visible to the framebuffer
     showLEDs();
     delay(50);
   }
@@ -520,6 +638,7 @@ bool BoardDriver::runCalibration() {
           strip.setPixelColor(ledIndexMap[r][c], strip.Color(LedColors::Green.r, LedColors::Green.g, LedColors::Green.b));
     if (currentPixel < LED_COUNT)
       strip.setPixelColor(currentPixel, strip.Color(LedColors::White.r, LedColors::White.g, LedColors::White.b));
+    frameDirty = true; // Raw strip writes, not visible to the framebuffer
     showLEDs();
   };
 
@@ -598,30 +717,140 @@ void BoardDriver::enableCol(int col) {
   delayMicroseconds(100); // Allow time for the column to stabilize, otherwise random readings might occur
 }
 
-void BoardDriver::readSensors() {
+// Single clock-and-latch step for the scan sweep: shifts `bit` into QA,
+// moving the walking enable bit one output along. No explicit delays — the
+// digitalWrite overhead alone comfortably exceeds the 74HC595's minimum
+// pulse widths.
+void BoardDriver::shiftWalkingBit(bool bit) {
+  digitalWrite(hwConfig.srDataPin, bit != hwConfig.srInvertOutputs);
+  digitalWrite(hwConfig.srClkPin, HIGH);
+  digitalWrite(hwConfig.srClkPin, LOW);
+  digitalWrite(hwConfig.srLatchPin, HIGH);
+  digitalWrite(hwConfig.srLatchPin, LOW);
+}
+
+// One raw full-matrix sweep in physical coordinates. The enable bit walks
+// through the register one clock per column, and all eight row pins are read
+// from a single snapshot of the GPIO input registers instead of eight
+// digitalRead calls. Assumes the register holds all zeros on entry and
+// leaves it that way.
+void BoardDriver::rawScanFrame(bool out[NUM_ROWS][NUM_COLS], uint16_t settleUs) {
+  for (int col = 0; col < NUM_COLS; col++) {
+    shiftWalkingBit(col == 0);
+    delayMicroseconds(settleUs);
+    uint32_t in0 = GPIO.in;       // GPIO 0-31
+    uint32_t in1 = GPIO.in1.val;  // GPIO 32+
+    for (int row = 0; row < NUM_ROWS; row++) {
+      uint8_t rowPin = hwConfig.rowPins[row];
+      uint32_t level = (rowPin < 32) ? (in0 >> rowPin) : (in1 >> (rowPin - 32));
+      out[row][col] = (level & 1) == 0; // Active low
+    }
+  }
+  shiftWalkingBit(false); // Push the bit out of QH: register back to all zeros
+  lastEnabledCol = -1;
+}
+
+// Find the smallest column settle delay whose raw reads match a
+// conservatively settled reference sweep. Run once when the scan task
+// starts; the result depends on the sensor wiring, not on piece positions,
+// but each candidate is checked against a fresh reference so pieces moving
+// during the check can't corrupt it.
+void BoardDriver::calibrateScanSettle() {
+  static const uint16_t candidates[] = {50, 25, 15, 10, 5};
+  bool ref[NUM_ROWS][NUM_COLS];
+  bool test[NUM_ROWS][NUM_COLS];
+  for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+    bool match = true;
+    for (int pass = 0; pass < 3 && match; pass++) {
+      rawScanFrame(ref, SENSOR_SETTLE_MAX_US);
+      rawScanFrame(test, candidates[i]);
+      match = memcmp(ref, test, sizeof(ref)) == 0;
+    }
+    if (!match)
+      break;
+    scanSettleUs = candidates[i];
+  }
+  scanMatrix();
+  Serial.printf("Sensor scan settle: %u us, full frame: %lu us\n", scanSettleUs, (unsigned long)scanFrameTimeUs.load());
+}
+
+// One matrix sweep with debounce, run only by the sensor task. Debounced
+// transitions are published to the event queue with a microsecond timestamp.
+void BoardDriver::scanMatrix() {
+  PERF_SCOPE(PERF_SENSOR_SWEEP);
   unsigned long currentTime = millis();
+  int64_t frameStart = esp_timer_get_time();
+  bool frame[NUM_ROWS][NUM_COLS];
+  rawScanFrame(frame, scanSettleUs);
+  scanFrameTimeUs.store((uint32_t)(esp_timer_get_time() - frameStart));
+
+  bool decayTick = currentTime - lastChatterDecay >= CHATTER_DECAY_MS;
+  if (decayTick)
+    lastChatterDecay = currentTime;
 
   for (int col = 0; col < NUM_COLS; col++) {
-    enableCol(col);
     for (int row = 0; row < NUM_ROWS; row++) {
-      bool newReading = digitalRead(hwConfig.rowPins[row]) == LOW;
+      bool newReading = frame[row][col];
       uint8_t logicalRow = toLogicalRow[swapAxes ? col : row];
       uint8_t logicalCol = toLogicalCol[swapAxes ? row : col];
-      // Debounce logic
+
+      // Quiet squares slowly earn back the fast confirm window
+      if (decayTick && chatterScore[logicalRow][logicalCol] > 0) {
+        chatterScore[logicalRow][logicalCol]--;
+        if (chatterScore[logicalRow][logicalCol] <= CHATTER_SLOW_EXIT)
+          slowDebounce[logicalRow][logicalCol] = false;
+      }
+
+      // Adaptive debounce: clean squares confirm after a few consistent
+      // sweeps, squares with recent chatter keep the long window
       if (newReading != sensorState[logicalRow][logicalCol]) {
         if (newReading != sensorRaw[logicalRow][logicalCol]) {
           sensorRaw[logicalRow][logicalCol] = newReading;
           sensorDebounceTime[logicalRow][logicalCol] = currentTime;
-        } else if (currentTime - sensorDebounceTime[logicalRow][logicalCol] >= DEBOUNCE_MS) {
-          sensorState[logicalRow][logicalCol] = newReading;
+          stableFrames[logicalRow][logicalCol] = 1;
+        } else {
+          if (stableFrames[logicalRow][logicalCol] < 255)
+            stableFrames[logicalRow][logicalCol]++;
+          bool confirmed = slowDebounce[logicalRow][logicalCol]
+                               ? currentTime - sensorDebounceTime[logicalRow][logicalCol] >= DEBOUNCE_MS
+                               : stableFrames[logicalRow][logicalCol] >= SENSOR_CONFIRM_FRAMES;
+          if (confirmed) {
+            sensorState[logicalRow][logicalCol] = newReading;
+            SensorEvent event = {logicalRow, logicalCol, newReading, esp_timer_get_time()};
+            if (xQueueSend(sensorEventQueue, &event, 0) != pdTRUE) {
+              // Queue full: drop the oldest event, the newest transition matters more
+              SensorEvent discarded;
+              xQueueReceive(sensorEventQueue, &discarded, 0);
+              xQueueSend(sensorEventQueue, &event, 0);
+            }
+          }
         }
       } else {
+        if (newReading != sensorRaw[logicalRow][logicalCol]) {
+          // A pending transition collapsed back before confirming: chatter
+          uint8_t score = chatterScore[logicalRow][logicalCol];
+          chatterScore[logicalRow][logicalCol] = score >= CHATTER_SCORE_MAX - 2 ? CHATTER_SCORE_MAX : score + 2;
+          if (chatterScore[logicalRow][logicalCol] >= CHATTER_SLOW_ENTER)
+            slowDebounce[logicalRow][logicalCol] = true;
+        }
         sensorRaw[logicalRow][logicalCol] = newReading;
         sensorDebounceTime[logicalRow][logicalCol] = currentTime;
+        stableFrames[logicalRow][logicalCol] = 0;
       }
     }
   }
-  disableAllCols();
+}
+
+void BoardDriver::readSensors() {
+  // Scanning runs continuously on the sensor task, so the debounced state
+  // this call used to refresh is already current. Kept as a no-op sync point
+  // for the many existing poll loops.
+}
+
+bool BoardDriver::getSensorEvent(SensorEvent& event) {
+  if (sensorEventQueue == nullptr)
+    return false;
+  return xQueueReceive(sensorEventQueue, &event, 0) == pdTRUE;
 }
 
 bool BoardDriver::getSensorState(int row, int col) {
@@ -652,8 +881,13 @@ void BoardDriver::releaseLEDs() {
 
 void BoardDriver::clearAllLEDs(bool show) {
   for (int row = 0; row < NUM_ROWS; row++)
-    for (int col = 0; col < NUM_COLS; col++)
+    for (int col = 0; col < NUM_COLS; col++) {
       currentColors[row][col] = LedColors::Off;
+      if (renderedColors[row][col] != 0) {
+        renderedColors[row][col] = 0;
+        frameDirty = true;
+      }
+    }
   for (int i = 0; i < LED_COUNT; i++)
     strip.setPixelColor(i, 0);
   if (show)
@@ -662,14 +896,31 @@ void BoardDriver::clearAllLEDs(bool show) {
 
 void BoardDriver::setSquareLED(int row, int col, LedRGB color) {
   currentColors[row][col] = color; // Track the intended color
-  float multiplier = 1.0f;
-  if ((row + col) % 2 == 1)
-    multiplier = dimMultiplier / 100.0f; // Dim dark squares based on user setting
-  strip.setPixelColor(getPixelIndex(row, col), strip.Color(color.r * multiplier, color.g * multiplier, color.b * multiplier));
+  // Dark squares go through the dim LUT instead of per-channel float math
+  uint32_t rendered = ((row + col) % 2 == 1)
+                          ? strip.Color(dimLut[color.r], dimLut[color.g], dimLut[color.b])
+                          : strip.Color(color.r, color.g, color.b);
+  // Compare the rendered value (not the intent) so dim multiplier changes
+  // still propagate while repeated identical writes stay free
+  if (rendered == renderedColors[row][col])
+    return;
+  renderedColors[row][col] = rendered;
+  frameDirty = true;
+  strip.setPixelColor(getPixelIndex(row, col), rendered);
 }
 
 void BoardDriver::showLEDs() {
+  // Coalesce: skip the transmission when nothing changed since the last
+  // frame, and space dirty frames at least LED_FRAME_MIN_INTERVAL_MS apart
+  if (!frameDirty)
+    return;
+  PERF_SCOPE(PERF_SHOW_LEDS);
+  unsigned long elapsed = millis() - lastFrameMs;
+  if (elapsed < LED_FRAME_MIN_INTERVAL_MS)
+    delay(LED_FRAME_MIN_INTERVAL_MS - elapsed);
   strip.show();
+  lastFrameMs = millis();
+  frameDirty = false;
 }
 
 void BoardDriver::showConnectingAnimation() {
@@ -688,7 +939,7 @@ void BoardDriver::showConnectingAnimation() {
 void BoardDriver::blinkSquare(int row, int col, LedRGB color, int times, bool clearAfter) {
   AnimationJob job = {AnimationType::BLINK, nullptr, {}};
   job.params.blink = {row, col, color, times, clearAfter};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
 }
 
 void BoardDriver::doBlink(int row, int col, LedRGB color, int times, bool clearAfter) {
@@ -709,7 +960,7 @@ void BoardDriver::doBlink(int row, int col, LedRGB color, int times, bool clearA
 void BoardDriver::fireworkAnimation(LedRGB color) {
   AnimationJob job = {AnimationType::FIREWORK, nullptr, {}};
   job.params.firework = {color};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
 }
 
 void BoardDriver::doFirework(LedRGB color) {
@@ -719,6 +970,9 @@ void BoardDriver::doFirework(LedRGB color) {
 
   // Contraction phase:
   for (float radius = 6; radius > 0; radius -= 0.5) {
+    if (feedbackPending.load())
+      break; // Yield to move feedback
+
     for (int row = 0; row < 8; row++)
       for (int col = 0; col < 8; col++) {
         float dx = col - centerX;
@@ -735,6 +989,9 @@ void BoardDriver::doFirework(LedRGB color) {
 
   // Expansion phase:
   for (float radius = 0; radius < 6; radius += 0.5) {
+    if (feedbackPending.load())
+      break; // Yield to move feedback
+
     for (int row = 0; row < 8; row++)
       for (int col = 0; col < 8; col++) {
         float dx = col - centerX;
@@ -755,7 +1012,7 @@ void BoardDriver::doFirework(LedRGB color) {
 void BoardDriver::captureAnimation(int row, int col) {
   AnimationJob job = {AnimationType::CAPTURE, nullptr, {}};
   job.params.capture = {row, col};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
 }
 
 void BoardDriver::doCapture(int centerRow, int centerCol) {
@@ -770,6 +1027,8 @@ void BoardDriver::doCapture(int centerRow, int centerCol) {
 
   clearAllLEDs(false);
   for (int frame = 0; frame < totalFrames; frame++) {
+    if (feedbackPending.load())
+      break; // Yield to move feedback
     for (int row = 0; row < 8; row++) {
       for (int col = 0; col < 8; col++) {
         float dx = col - centerX;
@@ -823,13 +1082,15 @@ void BoardDriver::doCapture(int centerRow, int centerCol) {
 void BoardDriver::promotionAnimation(int col) {
   AnimationJob job = {AnimationType::PROMOTION, nullptr, {}};
   job.params.promotion.col = col;
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
 }
 
 void BoardDriver::doPromotion(int col) {
   clearAllLEDs(false);
   // Column-based waterfall animation
   for (int step = 0; step < 16; step++) {
+    if (feedbackPending.load())
+      break; // Yield to move feedback
     for (int row = 0; row < 8; row++) {
       // Create a golden wave moving up and down the column
       if ((step + row) % 8 < 4)
@@ -846,7 +1107,7 @@ void BoardDriver::doPromotion(int col) {
 void BoardDriver::flashBoardAnimation(LedRGB color, int times) {
   AnimationJob job = {AnimationType::FLASH, nullptr, {}};
   job.params.flash = {color, times};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
 }
 
 void BoardDriver::doFlash(LedRGB color, int times) {
@@ -866,7 +1127,7 @@ void BoardDriver::doFlash(LedRGB color, int times) {
 std::atomic<bool>* BoardDriver::startThinkingAnimation() {
   auto* stopFlag = new std::atomic<bool>(false);
   AnimationJob job = {AnimationType::THINKING, stopFlag, {}};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
   return stopFlag;
 }
 
@@ -884,6 +1145,10 @@ void BoardDriver::doThinking(std::atomic<bool>* stopFlag) {
 
   clearAllLEDs(false);
   while (!stopFlag || !stopFlag->load()) {
+    // Feedback can't wait for the whole think — run it inline and resume
+    if (feedbackPending.load())
+      serviceFeedbackJobs();
+
     // Smooth sine wave for breathing (0 to 1)
     float breathe = (sinf(phase) + 1.0f) * 0.5f;
 
@@ -953,7 +1218,7 @@ void BoardDriver::doThinking(std::atomic<bool>* stopFlag) {
 std::atomic<bool>* BoardDriver::startWaitingAnimation() {
   auto* stopFlag = new std::atomic<bool>(false);
   AnimationJob job = {AnimationType::WAITING, stopFlag, {}};
-  xQueueSend(animationQueue, &job, portMAX_DELAY);
+  queueAnimation(job);
   return stopFlag;
 }
 
@@ -963,6 +1228,9 @@ void BoardDriver::doWaiting(std::atomic<bool>* stopFlag) {
 
   int frame = 0;
   while (!stopFlag || !stopFlag->load()) {
+    // Feedback can't wait for the opponent — run it inline and resume
+    if (feedbackPending.load())
+      serviceFeedbackJobs();
     clearAllLEDs(false);
     // Light up consecutive LEDs moving around the board
     for (int i = 0; i < 4; i++) {
@@ -983,11 +1251,13 @@ void BoardDriver::doWaiting(std::atomic<bool>* stopFlag) {
 void BoardDriver::setBrightness(uint8_t value) {
   brightness = value > 255 ? 255 : (value < 10 ? 10 : value);
   strip.setBrightness(brightness);
+  frameDirty = true; // Brightness is applied at frame render, force a resend
   showLEDs();
 }
 
 void BoardDriver::setDimMultiplier(uint8_t value) {
   dimMultiplier = value > 100 ? 100 : (value < 20 ? 20 : value);
+  rebuildDimLut();
   // Re-apply all current colors with new dim multiplier
   for (int row = 0; row < NUM_ROWS; row++)
     for (int col = 0; col < NUM_COLS; col++)
@@ -996,28 +1266,16 @@ void BoardDriver::setDimMultiplier(uint8_t value) {
 }
 
 void BoardDriver::loadLedSettings() {
-  if (!ChessUtils::ensureNvsInitialized()) {
-    Serial.println("NVS init failed - LED settings not loaded");
-    return;
-  }
-  Preferences prefs;
-  prefs.begin("ledSettings", false);
-  brightness = prefs.getUChar("brightness", BRIGHTNESS);
-  dimMultiplier = prefs.getUChar("dimMult", 70);
-  prefs.end();
+  LedSettingsNV s = SettingsCache::getLed();
+  brightness = s.valid ? s.brightness : BRIGHTNESS;
+  dimMultiplier = s.valid ? s.dimMultiplier : 70;
+  rebuildDimLut();
   Serial.printf("LED settings loaded: brightness=%d, dimMultiplier=%d\n", brightness, dimMultiplier);
 }
 
 void BoardDriver::saveLedSettings() {
-  if (!ChessUtils::ensureNvsInitialized()) {
-    Serial.println("NVS init failed - LED settings not saved");
-    return;
-  }
-  Preferences prefs;
-  prefs.begin("ledSettings", false);
-  prefs.putUChar("brightness", brightness);
-  prefs.putUChar("dimMult", dimMultiplier);
-  prefs.end();
+  // Commit happens on the settings task — callers run in web handlers
+  SettingsCache::setLed(brightness, dimMultiplier);
   Serial.printf("LED settings saved: brightness=%d, dimMultiplier=%d\n", brightness, dimMultiplier);
 }
 
@@ -1037,46 +1295,33 @@ void BoardDriver::triggerCalibration() {
 
 void BoardDriver::loadHardwareConfig() {
   hwConfig = HardwareConfig::defaults();
-  if (!ChessUtils::ensureNvsInitialized()) return;
-
-  Preferences prefs;
-  prefs.begin("hwConfig", false);
-  if (!prefs.isKey("ver")) {
-    prefs.end();
+  HwConfigNV s = SettingsCache::getHw();
+  if (!s.valid) {
     Serial.println("No saved hardware config, using compile-time defaults");
     return;
   }
-  hwConfig.ledPin = prefs.getUChar("ledPin", LED_PIN);
-  hwConfig.srClkPin = prefs.getUChar("srClk", SR_CLK_PIN);
-  hwConfig.srLatchPin = prefs.getUChar("srLatch", SR_LATCH_PIN);
-  hwConfig.srDataPin = prefs.getUChar("srData", SR_SER_DATA_PIN);
-  hwConfig.srInvertOutputs = prefs.getBool("srInvert", SR_INVERT_OUTPUTS != 0);
-  uint8_t savedRows[NUM_ROWS];
-  size_t len = prefs.getBytesLength("rowPins");
-  if (len == NUM_ROWS) {
-    prefs.getBytes("rowPins", savedRows, NUM_ROWS);
+  hwConfig.ledPin = s.ledPin;
+  hwConfig.srClkPin = s.srClkPin;
+  hwConfig.srLatchPin = s.srLatchPin;
+  hwConfig.srDataPin = s.srDataPin;
+  hwConfig.srInvertOutputs = s.srInvertOutputs;
+  if (s.rowPinsValid)
     for (int i = 0; i < NUM_ROWS; i++)
-      hwConfig.rowPins[i] = savedRows[i];
-  }
-  prefs.end();
+      hwConfig.rowPins[i] = s.rowPins[i];
   Serial.printf("Hardware config loaded: LED=%d, SR_CLK=%d, SR_LATCH=%d, SR_DATA=%d, SR_INVERT=%d\n", hwConfig.ledPin, hwConfig.srClkPin, hwConfig.srLatchPin, hwConfig.srDataPin, hwConfig.srInvertOutputs);
 }
 
 void BoardDriver::saveHardwareConfig(const HardwareConfig& config) {
-  if (!ChessUtils::ensureNvsInitialized()) {
-    Serial.println("NVS init failed - hardware config not saved");
-    return;
-  }
-  Preferences prefs;
-  prefs.begin("hwConfig", false);
-  prefs.putUChar("ver", 1);
-  prefs.putUChar("ledPin", config.ledPin);
-  prefs.putUChar("srClk", config.srClkPin);
-  prefs.putUChar("srLatch", config.srLatchPin);
-  prefs.putUChar("srData", config.srDataPin);
-  prefs.putBool("srInvert", config.srInvertOutputs);
-  prefs.putBytes("rowPins", config.rowPins, NUM_ROWS);
-  prefs.end();
+  HwConfigNV s = {};
+  s.ledPin = config.ledPin;
+  s.srClkPin = config.srClkPin;
+  s.srLatchPin = config.srLatchPin;
+  s.srDataPin = config.srDataPin;
+  s.srInvertOutputs = config.srInvertOutputs;
+  for (int i = 0; i < NUM_ROWS; i++)
+    s.rowPins[i] = config.rowPins[i];
+  s.rowPinsValid = true;
+  SettingsCache::setHw(s);
   hwConfig = config;
   Serial.println("Hardware config saved - reboot required to apply");
 }
\ No newline at end of file
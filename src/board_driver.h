@@ -2,7 +2,7 @@
 #define BOARD_DRIVER_H
 
 #include "led_colors.h"
-#include <Adafruit_NeoPixel.h>
+#include "rmt_led_strip.h"
 #include <atomic>
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
@@ -77,9 +77,39 @@ struct HardwareConfig {
 // Sensor Polling Delay and Debounce
 // ---------------------------
 #define SENSOR_READ_DELAY_MS 40
-#define DEBOUNCE_MS 125
+// Scan task sweep period. The batched scan completes a full frame in well
+// under a millisecond, so sweeps can run much tighter than the consumer polls
+#define SENSOR_SCAN_PERIOD_MS 10
+// With sub-millisecond frames the debounce window no longer needs to absorb
+// 40 ms sampling granularity on top of contact bounce. Only squares that
+// have shown chatter use this long window; clean squares confirm after
+// SENSOR_CONFIRM_FRAMES consistent sweeps (~30 ms registration latency).
+#define DEBOUNCE_MS 60
+#define SENSOR_CONFIRM_FRAMES 3
+// Chatter scoring with hysteresis: a square enters slow-debounce mode at
+// the enter threshold and only leaves once decay brings it to the exit
+// threshold, so it can't flap between the two windows
+#define CHATTER_SLOW_ENTER 4
+#define CHATTER_SLOW_EXIT 1
+#define CHATTER_SCORE_MAX 10
+#define CHATTER_DECAY_MS 5000
+// Column settle ceiling; the scan task calibrates the real value downward
+#define SENSOR_SETTLE_MAX_US 100
 #define CALIBRATION_WARNING_INTERVAL_MS 4000
 
+// Minimum spacing between LED frame transmissions; bursts of showLEDs()
+// calls coalesce into at most one frame per interval
+#define LED_FRAME_MIN_INTERVAL_MS 15
+
+// Debounced sensor transition published by the scanning task
+struct SensorEvent {
+  uint8_t row;
+  uint8_t col;
+  bool present;        // true = piece placed, false = piece lifted
+  int64_t timestampUs; // esp_timer_get_time() at the debounced edge
+};
+#define SENSOR_EVENT_QUEUE_LEN 32
+
 // Animation job types for async queue
 enum class AnimationType : uint8_t { CAPTURE,
                                      PROMOTION,
@@ -122,14 +152,32 @@ struct AnimationJob {
 // ---------------------------
 class BoardDriver {
  private:
-  Adafruit_NeoPixel strip;
+  RmtLedStrip strip;
 
-  // Animation queue system
-  static QueueHandle_t animationQueue;
+  // Animation queue system. Feedback jobs (the LED response to a physical
+  // action: blinks, error flashes) run before queued decorative ones, and
+  // long decorative animations yield to them mid-run so feedback latency
+  // stays bounded no matter what eye-candy is in flight.
+  static QueueHandle_t animationQueue; // Decorative: capture, promotion, firework, waiting, thinking
+  static QueueHandle_t feedbackQueue;  // Move feedback: blink, flash
+  static std::atomic<bool> feedbackPending;
   static TaskHandle_t animationTaskHandle;
   static SemaphoreHandle_t ledMutex;
   static BoardDriver* instance;
   static void animationWorkerTask(void* param);
+  void queueAnimation(const AnimationJob& job);
+  void serviceFeedbackJobs();
+
+  // Sensor scanning task (realtime core — see core_layout.h)
+  static QueueHandle_t sensorEventQueue;
+  static TaskHandle_t sensorTaskHandle;
+  static void sensorScanTask(void* param);
+  void scanMatrix();
+  void shiftWalkingBit(bool bit);
+  void rawScanFrame(bool out[NUM_ROWS][NUM_COLS], uint16_t settleUs);
+  void calibrateScanSettle();
+  uint16_t scanSettleUs;                 // Calibrated column settle delay
+  std::atomic<uint32_t> scanFrameTimeUs; // Measured duration of the last full sweep
   void executeAnimation(const AnimationJob& job);
   void doCapture(int row, int col);
   void doPromotion(int col);
@@ -142,6 +190,10 @@ class BoardDriver {
   bool sensorPrev[NUM_ROWS][NUM_COLS];
   bool sensorRaw[NUM_ROWS][NUM_COLS];
   unsigned long sensorDebounceTime[NUM_ROWS][NUM_COLS];
+  uint8_t stableFrames[NUM_ROWS][NUM_COLS]; // Consecutive sweeps agreeing on a pending transition
+  uint8_t chatterScore[NUM_ROWS][NUM_COLS]; // Recent aborted transitions, decayed over time
+  bool slowDebounce[NUM_ROWS][NUM_COLS];    // Square currently held to the long DEBOUNCE_MS window
+  unsigned long lastChatterDecay;
   int lastEnabledCol; // Tracks last enabled column for efficient sequential shifting
 
   enum Axis {
@@ -154,6 +206,18 @@ class BoardDriver {
   uint8_t dimMultiplier;                    // Dark square dim factor 0-100 (stored as percentage)
   LedRGB currentColors[NUM_ROWS][NUM_COLS]; // Track current colors for dim multiplier updates
 
+  // Dirty-tracking framebuffer: renderedColors shadows what the strip last
+  // received so redundant setSquareLED writes and back-to-back showLEDs()
+  // calls don't each cost a full-frame transmission
+  uint32_t renderedColors[NUM_ROWS][NUM_COLS];
+  bool frameDirty;
+  unsigned long lastFrameMs;
+
+  // Dark-square dim scale as a 256-entry LUT, rebuilt only when the dim
+  // multiplier changes, so per-pixel rendering is three table reads
+  uint8_t dimLut[256];
+  void rebuildDimLut();
+
   // Runtime hardware pin configuration (persisted in NVS)
   HardwareConfig hwConfig;
 
@@ -188,6 +252,10 @@ class BoardDriver {
   bool getSensorState(int row, int col);
   bool getSensorPrev(int row, int col);
   void updateSensorPrev();
+  bool getSensorEvent(SensorEvent& event);
+  uint32_t getScanFrameTimeUs() const { return scanFrameTimeUs.load(); }
+  bool isSquareChattery(int row, int col) const { return slowDebounce[row][col]; }
+  uint8_t getChatterScore(int row, int col) const { return chatterScore[row][col]; }
 
   // LED Control (use acquireLEDs/releaseLEDs for multi-call sequences)
   void acquireLEDs(); // Block until LED strip available
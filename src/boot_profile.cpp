@@ -0,0 +1,95 @@
+#include "boot_profile.h"
+#include <Arduino.h>
+
+// Phase timings live in RTC slow memory: cheap, survives software resets,
+// and readable from the /perf handler long after setup() returned
+#define BOOT_PROFILE_MAGIC 0xB007F11E
+static RTC_DATA_ATTR uint32_t rtcMagic;
+static RTC_DATA_ATTR uint32_t rtcPhaseMs[BOOT_PHASE_COUNT];
+static RTC_DATA_ATTR uint32_t rtcPlayableMs;
+
+static unsigned long lastMarkMs = 0;
+
+// Regression budgets (ms). Chosen from healthy-boot measurements with slack;
+// an overrun means a phase regressed, not that the board is broken.
+static const uint32_t phaseBudgetMs[BOOT_PHASE_COUNT] = {
+    3200, // BOOT_SERIAL (dominated by the fixed settle delay)
+    150,  // BOOT_NVS
+    800,  // BOOT_FS_MOUNT
+    500,  // BOOT_MOVE_HISTORY
+    1200, // BOOT_BOARD_DRIVER
+    1500, // BOOT_WIFI_SETUP
+    150,  // BOOT_UI_LINK
+    6500, // BOOT_WIFI_CONNECT (10 × 500 ms attempt loop + association)
+    300,  // BOOT_RESUME_CHECK
+};
+
+static const char* phaseName(int i) {
+  switch (i) {
+    case BOOT_SERIAL: return "serial";
+    case BOOT_NVS: return "nvs";
+    case BOOT_FS_MOUNT: return "fsMount";
+    case BOOT_MOVE_HISTORY: return "moveHistory";
+    case BOOT_BOARD_DRIVER: return "boardDriver";
+    case BOOT_WIFI_SETUP: return "wifiSetup";
+    case BOOT_UI_LINK: return "uiLink";
+    case BOOT_WIFI_CONNECT: return "wifiConnect";
+    case BOOT_RESUME_CHECK: return "resumeCheck";
+    default: return "?";
+  }
+}
+
+namespace BootProfile {
+
+void start() {
+  memset(rtcPhaseMs, 0, sizeof(rtcPhaseMs));
+  rtcPlayableMs = 0;
+  rtcMagic = BOOT_PROFILE_MAGIC;
+  lastMarkMs = millis();
+}
+
+void mark(BootPhase phase) {
+  unsigned long now = millis();
+  rtcPhaseMs[phase] = (uint32_t)(now - lastMarkMs);
+  lastMarkMs = now;
+}
+
+void markPlayable() {
+  if (rtcPlayableMs == 0)
+    rtcPlayableMs = (uint32_t)millis();
+}
+
+void report() {
+  uint32_t total = 0;
+  Serial.println("===== Boot profile (ms) =====");
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    total += rtcPhaseMs[i];
+    Serial.printf("%-12s %6lu / %-6lu%s\n", phaseName(i),
+                  (unsigned long)rtcPhaseMs[i], (unsigned long)phaseBudgetMs[i],
+                  rtcPhaseMs[i] > phaseBudgetMs[i] ? "  OVER BUDGET" : "");
+  }
+  Serial.printf("%-12s %6lu\n", "total", (unsigned long)total);
+  Serial.println("=============================");
+}
+
+void fillJSON(JsonDocument& doc) {
+  if (rtcMagic != BOOT_PROFILE_MAGIC)
+    return;
+  JsonObject boot = doc["boot"].to<JsonObject>();
+  JsonArray phases = boot["phases"].to<JsonArray>();
+  uint32_t total = 0;
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    total += rtcPhaseMs[i];
+    JsonObject p = phases.add<JsonObject>();
+    p["name"] = phaseName(i);
+    p["ms"] = rtcPhaseMs[i];
+    p["budget_ms"] = phaseBudgetMs[i];
+    if (rtcPhaseMs[i] > phaseBudgetMs[i])
+      p["over"] = true;
+  }
+  boot["total_ms"] = total;
+  if (rtcPlayableMs > 0)
+    boot["playable_ms"] = rtcPlayableMs;
+}
+
+} // namespace BootProfile
@@ -0,0 +1,49 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <ArduinoJson.h>
+
+// ---------------------------
+// Boot-phase startup profiler
+// ---------------------------
+// Times the named phases of setup() so "cold boot to playable" stops being
+// one opaque number: after a venue power cycle every board races to become
+// playable again, and the slow phase has to be identifiable remotely. Each
+// phase carries a regression budget; the boot report flags overruns on
+// serial, and the timings are kept in RTC memory so the /perf endpoint can
+// serve them for the rest of the session (and across a software reset).
+
+enum BootPhase {
+  BOOT_SERIAL = 0,    // Banner + fixed serial settle delay
+  BOOT_NVS,           // ensureNvsInitialized
+  BOOT_FS_MOUNT,      // LittleFS.begin (format on first boot blows the budget — expected)
+  BOOT_MOVE_HISTORY,  // moveHistory.begin incl. reboot-interrupted finalize recovery
+  BOOT_BOARD_DRIVER,  // boardDriver.begin (calibration load, LED + sensor init)
+  BOOT_WIFI_SETUP,    // wifiManager.begin (AP + web server + handlers)
+  BOOT_UI_LINK,       // UIComm::begin
+  BOOT_WIFI_CONNECT,  // Station association wait loop
+  BOOT_RESUME_CHECK,  // Live-game probe + mode selection
+  BOOT_PHASE_COUNT
+};
+
+namespace BootProfile {
+
+// Call first in setup(); resets the phase table and starts the clock
+void start();
+
+// Record the end of `phase` (phases are assumed to run back to back)
+void mark(BootPhase phase);
+
+// Record time-to-playable: first mode initialized or selection screen up.
+// Later calls are ignored, so both sites can call it unconditionally.
+void markPlayable();
+
+// Print the phase table with budgets and overruns over serial
+void report();
+
+// Add a "boot" section to `doc` for the /perf endpoint
+void fillJSON(JsonDocument& doc);
+
+} // namespace BootProfile
+
+#endif // BOOT_PROFILE_H
@@ -1,39 +1,79 @@
 #include "chess_bot.h"
 #include "chess_utils.h"
+#include "core_layout.h"
 #include "led_colors.h"
 #include "move_history.h"
+#include "opening_book.h"
+#include "perf_stats.h"
+#include "stockfish_cache.h"
 #include "stockfish_api.h"
+#include "transposition_table.h"
 #include "wifi_manager_esp32.h"
 #include <Arduino.h>
 
-ChessBot::ChessBot(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, MoveHistory* mh, BotConfig cfg) : ChessGame(bd, ce, wm, mh), botConfig(cfg), currentEvaluation(0.0) {}
+// Shared transposition table for the on-device search. Allocated once on
+// first bot game (ChessBot instances are recreated per game; reallocating
+// tens of KB each time would fragment the heap) and cleared between games.
+static TranspositionTable botTT;
+
+// Opening book on LittleFS, shared across games (read-only)
+static OpeningBook botBook;
+
+// API response cache (RAM + LittleFS persistence), shared across games
+static StockfishCache sfCache;
+
+// Set while a ponder prefetch request is in flight. The think task waits on it
+// so the prefetched answer lands in the cache before the lookup, and so two
+// TLS connections never run at once.
+static std::atomic<bool> ponderInFlight(false);
+
+ChessBot::ChessBot(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, MoveHistory* mh, BotConfig cfg) : ChessGame(bd, ce, wm, mh), botConfig(cfg), localSearch(ce), moveState(BOT_IDLE), pendingKey(0), thinkAnimation(nullptr), currentEvaluation(0.0) {}
+
+ChessBot::~ChessBot() {
+  // The think task holds a pointer to this object — wait it out before
+  // the object goes away (mode switches delete the bot mid-game)
+  while (moveState.load() == BOT_THINKING)
+    delay(10);
+}
 
 void ChessBot::begin() {
   Serial.println("=== Starting Chess Bot Mode ===");
   Serial.printf("Player plays: %s\n", botConfig.playerIsWhite ? "White" : "Black");
   Serial.printf("Bot plays: %s\n", botConfig.playerIsWhite ? "Black" : "White");
+  Serial.printf("Bot Engine: %s\n", botConfig.useLocalEngine ? "On-device search" : "Stockfish API");
   Serial.printf("Bot Difficulty: Depth %d, Timeout %dms\n", botConfig.stockfishSettings.depth, botConfig.stockfishSettings.timeoutMs);
   Serial.println("====================================");
-  if (wifiManager->connectToWiFi(wifiManager->getWiFiSSID(), wifiManager->getWiFiPassword())) {
-    initializeBoard();
-    if (moveHistory->hasLiveGame()) {
-      Serial.println("Resuming live bot game...");
-      replaying = true;
-      moveHistory->replayIntoGame(this);
-      replaying = false;
-      wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-      sendUiState();
+  if (!wifiManager->connectToWiFi(wifiManager->getWiFiSSID(), wifiManager->getWiFiPassword())) {
+    // No network: the on-device engine keeps the bot playable
+    if (!botConfig.useLocalEngine) {
+      Serial.println("Failed to connect to WiFi. Falling back to the on-device engine.");
+      botConfig.useLocalEngine = true;
     } else {
-      moveHistory->startGame(GAME_MODE_BOT, botConfig.playerIsWhite ? 'w' : 'b', (uint8_t)botConfig.stockfishSettings.depth);
-      moveHistory->addFen(ChessUtils::boardToFEN(board, currentTurn, chessEngine));
+      Serial.println("No WiFi connection. Playing fully offline.");
     }
-    waitForBoardSetup(board);
+  }
+  botBook.begin();
+  sfCache.begin();
+  if (botTT.begin(TT_DEFAULT_BUDGET)) {
+    botTT.clear(); // Positions from the previous game don't help the next one
+    localSearch.setTranspositionTable(&botTT);
   } else {
-    Serial.println("Failed to connect to WiFi. Bot mode unavailable.");
-    boardDriver->flashBoardAnimation(LedColors::Red);
-    gameOver = true;
-    return;
+    Serial.println("Transposition table unavailable (low memory) — searching without one");
   }
+  initializeBoard();
+  if (moveHistory->hasLiveGame()) {
+    Serial.println("Resuming live bot game...");
+    replaying = true;
+    moveHistory->replayIntoGame(this);
+    replaying = false;
+    publishBoardState(materialScore);
+  } else {
+    moveHistory->startGame(GAME_MODE_BOT, botConfig.playerIsWhite ? 'w' : 'b', (uint8_t)botConfig.stockfishSettings.depth);
+    char fen[ChessUtils::FEN_MAX_LEN];
+    ChessUtils::boardToFEN(board, currentTurn, chessEngine, fen, sizeof(fen));
+    moveHistory->addFen(fen);
+  }
+  waitForBoardSetup(board);
 }
 
 void ChessBot::update() {
@@ -52,62 +92,30 @@ void ChessBot::update() {
     if (tryPlayerMove(currentTurn, fromRow, fromCol, toRow, toCol)) {
       applyMove(fromRow, fromCol, toRow, toCol);
       updateGameStatus();
-      wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), currentEvaluation);
-      sendUiState();
+      publishBoardState(currentEvaluation);
     }
   } else {
-    // Bot's turn
-    makeBotMove();
+    // Bot's turn — computation runs off-loop so sensors, resign gestures
+    // and UART keep being serviced at full rate while it thinks
+    if (moveState.load() == BOT_IDLE)
+      startBotMove();
+    if (moveState.load() == BOT_THINKING) {
+      boardDriver->updateSensorPrev();
+      return;
+    }
+    finishBotMove();
     updateGameStatus();
-    wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), currentEvaluation);
-    sendUiState();
+    publishBoardState(currentEvaluation);
   }
 
   boardDriver->updateSensorPrev();
 }
 
-String ChessBot::makeStockfishRequest(const String& fen) {
-  WiFiSSLClient client;
-  // Set insecure mode for SSL (or add proper certificate validation)
-  client.setInsecure();
-  String path = StockfishAPI::buildRequestURL(fen, botConfig.stockfishSettings.depth);
-  Serial.println("Stockfish request: " STOCKFISH_API_URL + path);
-  // Retry logic
-  for (int attempt = 1; attempt <= botConfig.stockfishSettings.maxRetries; attempt++) {
-    if (attempt > 1)
-      Serial.println("Attempt: " + String(attempt) + "/" + String(botConfig.stockfishSettings.maxRetries));
-    if (client.connect(STOCKFISH_API_URL, STOCKFISH_API_PORT)) {
-      client.println("GET " + path + " HTTP/1.1");
-      client.println("Host: " STOCKFISH_API_URL);
-      client.println("Connection: close");
-      client.println();
-      // Wait for response
-      unsigned long startTime = millis();
-      String response = "";
-      bool gotResponse = false;
-      while (client.connected() && (millis() - startTime < botConfig.stockfishSettings.timeoutMs)) {
-        if (client.available()) {
-          response = client.readString();
-          gotResponse = true;
-          break;
-        }
-        delay(10);
-      }
-      client.stop();
-
-      if (gotResponse && response.length() > 0)
-        return response;
-    }
-
-    Serial.println("API request timeout or empty response");
-    if (attempt < botConfig.stockfishSettings.maxRetries) {
-      Serial.println("Retrying...");
-      delay(500);
-    }
-  }
-
-  Serial.println("All API request attempts failed");
-  return "";
+String ChessBot::makeStockfishRequest(const char* fen) {
+  PERF_SCOPE(PERF_STOCKFISH_REQUEST);
+  // Connection management (keep-alive, retries, task serialization) lives
+  // in StockfishAPI so the ponder prefetch and UI hints share it
+  return StockfishAPI::request(fen, botConfig.stockfishSettings);
 }
 
 bool ChessBot::parseStockfishResponse(const String& response, String& bestMove, float& evaluation) {
@@ -117,6 +125,7 @@ bool ChessBot::parseStockfishResponse(const String& response, String& bestMove,
     return false;
   }
   bestMove = stockfishResp.bestMove;
+  ponderMove = stockfishResp.ponderMove;
   if (stockfishResp.hasMate) {
     Serial.printf("Mate in %d moves\n", stockfishResp.mateInMoves);
     // Convert mate to a large evaluation (positive or negative based on direction)
@@ -128,20 +137,100 @@ bool ChessBot::parseStockfishResponse(const String& response, String& bestMove,
   return true;
 }
 
-void ChessBot::makeBotMove() {
+// Run the on-device search for the current position and return the chosen
+// move as UCI. Used in offline mode and whenever the API fails mid-game.
+bool ChessBot::makeLocalEngineMove(String& bestMove) {
+  // Scale the thinking budget with the selected difficulty (easy ~3s,
+  // expert ~9s). Depth is capped: the budget runs out first in the midgame.
+  uint32_t budgetMs = (uint32_t)botConfig.stockfishSettings.depth * 600;
+  SearchResult result = localSearch.findBestMove(board, currentTurn, budgetMs, 8);
+  if (!result.valid) {
+    Serial.println("On-device search found no legal move");
+    return false;
+  }
+  bestMove = ChessUtils::toUCIMove(result.bestMove.fromRow, result.bestMove.fromCol, result.bestMove.toRow, result.bestMove.toCol, result.promotion);
+  // Negamax score is from the side to move; evaluation is White-perspective pawns
+  currentEvaluation = ((currentTurn == 'w') ? result.scoreCp : -result.scoreCp) / 100.0f;
+  Serial.printf("On-device search: %s (depth %d, %.2f pawns, %u nodes)\n", bestMove.c_str(), result.depthReached, currentEvaluation, result.nodes);
+  botTT.printStats();
+  return true;
+}
+
+void ChessBot::startBotMove() {
   Serial.println("=== BOT MOVE CALCULATION ===");
-  std::atomic<bool>* stopAnimation = boardDriver->startThinkingAnimation();
+  thinkAnimation = boardDriver->startThinkingAnimation();
+  ponderMove = ""; // Only an API response carries a prediction
+  pendingMove = "";
+  pendingKey = chessEngine->computeZobristHash(board, currentTurn);
+
+  // Opening book inline: a hit answers in milliseconds with no network
+  String bookMove;
+  if (botBook.probe(pendingKey, board, bookMove)) {
+    int fromRow, fromCol, toRow, toCol;
+    char promotion;
+    if (ChessUtils::parseUCIMove(bookMove, fromRow, fromCol, toRow, toCol, promotion) && chessEngine->isValidMove(board, fromRow, fromCol, toRow, toCol)) {
+      Serial.println("Book move: " + bookMove);
+      currentEvaluation = materialScore; // No engine evaluation for book moves
+      pendingMove = bookMove;
+      moveState.store(BOT_READY);
+      return;
+    }
+    Serial.println("Book move " + bookMove + " is not legal here — ignoring book");
+  }
+
+  moveState.store(BOT_THINKING);
+  xTaskCreatePinnedToCore(botThinkTask, "bot_think", 12288, this, 1, nullptr, CORE_APP);
+}
+
+// Runs on its own task: API request (or cache hit) with local-engine
+// fallback. Publishes the result through pendingMove/moveState.
+void ChessBot::botThinkTask(void* param) {
+  ChessBot* bot = static_cast<ChessBot*>(param);
   String bestMove;
-  String response = makeStockfishRequest(ChessUtils::boardToFEN(board, currentTurn, chessEngine));
-  if (stopAnimation) stopAnimation->store(true);
-  if (parseStockfishResponse(response, bestMove, currentEvaluation)) {
-    Serial.println("=== STOCKFISH EVALUATION ===");
+  bool haveMove = false;
+  if (!bot->botConfig.useLocalEngine) {
+    // A ponder prefetch may be about to land exactly this position — let it
+    // finish before looking up (and before opening a second TLS connection)
+    while (ponderInFlight.load())
+      delay(25);
+    // Cached API result for this position at this depth? Skip the network.
+    if (sfCache.lookup(bot->pendingKey, bot->botConfig.stockfishSettings.depth, bestMove, bot->currentEvaluation)) {
+      Serial.println("Cached Stockfish result: " + bestMove);
+      haveMove = true;
+    } else {
+      char fen[ChessUtils::FEN_MAX_LEN];
+      ChessUtils::boardToFEN(bot->board, bot->currentTurn, bot->chessEngine, fen, sizeof(fen));
+      String response = bot->makeStockfishRequest(fen);
+      haveMove = bot->parseStockfishResponse(response, bestMove, bot->currentEvaluation);
+      if (haveMove)
+        sfCache.store(bot->pendingKey, bot->botConfig.stockfishSettings.depth, bestMove, bot->currentEvaluation);
+      else
+        Serial.println("Stockfish API unavailable — falling back to the on-device search for this move");
+    }
+  }
+  if (!haveMove)
+    haveMove = bot->makeLocalEngineMove(bestMove);
+  bot->pendingMove = haveMove ? bestMove : "";
+  bot->moveState.store(haveMove ? BOT_READY : BOT_FAILED);
+  vTaskDelete(NULL);
+}
+
+void ChessBot::finishBotMove() {
+  if (thinkAnimation) {
+    thinkAnimation->store(true);
+    thinkAnimation = nullptr;
+  }
+  String bestMove = pendingMove;
+  bool haveMove = (moveState.load() == BOT_READY) && bestMove.length() > 0;
+  moveState.store(BOT_IDLE);
+  if (haveMove) {
+    Serial.println("=== BOT EVALUATION ===");
     Serial.printf("%s advantage: %.2f pawns\n", currentEvaluation > 0 ? "White" : "Black", currentEvaluation);
 
     int fromRow, fromCol, toRow, toCol;
     char promotion;
     if (ChessUtils::parseUCIMove(bestMove, fromRow, fromCol, toRow, toCol, promotion)) {
-      Serial.printf("Stockfish UCI move: %s = (%d,%d) -> (%d,%d)%s%c\n", bestMove.c_str(), fromRow, fromCol, toRow, toCol, promotion == ' ' ? "" : " Promotion to: ", promotion);
+      Serial.printf("Bot UCI move: %s = (%d,%d) -> (%d,%d)%s%c\n", bestMove.c_str(), fromRow, fromCol, toRow, toCol, promotion == ' ' ? "" : " Promotion to: ", promotion);
       Serial.println("============================");
       // Verify the move is from the correct color piece
       char piece = board[fromRow][fromCol];
@@ -156,12 +245,93 @@ void ChessBot::makeBotMove() {
         return;
       }
       applyMove(fromRow, fromCol, toRow, toCol, (bestMove.length() >= 5) ? bestMove[4] : ' ', true);
+      startPonderPrefetch();
     } else {
-      Serial.println("Failed to parse Stockfish UCI move: " + bestMove);
+      Serial.println("Failed to parse bot UCI move: " + bestMove);
     }
   }
 }
 
+// Speculatively analyse the position after the predicted human reply while
+// the human is still thinking. When the prediction is right — which is
+// often — the bot's next move becomes an instant cache hit instead of a
+// multi-second API round trip.
+void ChessBot::startPonderPrefetch() {
+  if (ponderMove.length() < 4 || botConfig.useLocalEngine || ponderInFlight.load())
+    return;
+
+  int fromRow, fromCol, toRow, toCol;
+  char promotion;
+  if (!ChessUtils::parseUCIMove(ponderMove, fromRow, fromCol, toRow, toCol, promotion) || !chessEngine->isValidMove(board, fromRow, fromCol, toRow, toCol))
+    return;
+
+  // Play the predicted reply on a scratch board and derive the key and FEN
+  // the same way startBotMove will once the human actually plays it
+  char predicted[8][8];
+  memcpy(predicted, board, sizeof(predicted));
+  char piece = predicted[fromRow][fromCol];
+  char capturedPiece = predicted[toRow][toCol];
+  if (ChessUtils::isEnPassantMove(fromRow, fromCol, toRow, toCol, piece, capturedPiece))
+    predicted[ChessUtils::getEnPassantCapturedPawnRow(toRow, piece)][toCol] = ' ';
+  if (ChessUtils::isCastlingMove(fromRow, fromCol, toRow, toCol, piece)) {
+    int rookFromCol = (toCol > fromCol) ? 7 : 0;
+    int rookToCol = (toCol > fromCol) ? 5 : 3;
+    predicted[fromRow][rookToCol] = predicted[fromRow][rookFromCol];
+    predicted[fromRow][rookFromCol] = ' ';
+  }
+  predicted[toRow][toCol] = piece;
+  predicted[fromRow][fromCol] = ' ';
+  if (chessEngine->isPawnPromotion(piece, toRow))
+    predicted[toRow][toCol] = ChessUtils::isWhitePiece(piece) ? toupper(promotion == ' ' ? 'q' : promotion) : tolower(promotion == ' ' ? 'q' : promotion);
+
+  // Borrow the engine's castling/en-passant state for hashing and the FEN,
+  // then put it back — the real game state must not see the speculation
+  uint8_t savedRights = chessEngine->getCastlingRights();
+  int savedEpRow, savedEpCol;
+  chessEngine->getEnPassantTarget(savedEpRow, savedEpCol);
+  if (toupper(piece) == 'P' && abs(toRow - fromRow) == 2)
+    chessEngine->setEnPassantTarget((fromRow + toRow) / 2, fromCol);
+  else
+    chessEngine->clearEnPassantTarget();
+  updateCastlingRightsAfterMove(fromRow, fromCol, toRow, toCol, piece, capturedPiece);
+  uint64_t key = chessEngine->computeZobristHash(predicted, currentTurn); // Bot to move again after the reply
+  String fen = ChessUtils::boardToFEN(predicted, currentTurn, chessEngine);
+  chessEngine->setCastlingRights(savedRights);
+  if (savedEpRow != -1)
+    chessEngine->setEnPassantTarget(savedEpRow, savedEpCol);
+  else
+    chessEngine->clearEnPassantTarget();
+
+  String cachedMove;
+  float cachedEval;
+  if (sfCache.lookup(key, botConfig.stockfishSettings.depth, cachedMove, cachedEval))
+    return; // Already analysed deep enough — nothing to prefetch
+
+  struct PonderParams {
+    String fen;
+    uint64_t key;
+    StockfishSettings settings;
+  };
+  auto* params = new PonderParams{fen, key, botConfig.stockfishSettings};
+  ponderInFlight.store(true);
+  Serial.println("Pondering predicted reply " + ponderMove + "...");
+  xTaskCreatePinnedToCore(
+      [](void* param) {
+        auto* p = static_cast<PonderParams*>(param);
+        String response = StockfishAPI::request(p->fen, p->settings);
+        StockfishResponse resp;
+        if (response.length() > 0 && StockfishAPI::parseResponse(response, resp)) {
+          float evaluation = resp.hasMate ? (resp.mateInMoves > 0 ? 100.0f : -100.0f) : resp.evaluation;
+          sfCache.store(p->key, p->settings.depth, resp.bestMove, evaluation);
+          Serial.println("Ponder prefetch cached: " + resp.bestMove);
+        }
+        ponderInFlight.store(false);
+        delete p;
+        vTaskDelete(NULL);
+      },
+      "ponder", 8192, params, 1, NULL, CORE_APP);
+}
+
 void ChessBot::waitForRemoteMoveCompletion(int fromRow, int fromCol, int toRow, int toCol, bool isCapture, bool isEnPassant, int enPassantCapturedPawnRow) {
   boardDriver->acquireLEDs();
   boardDriver->clearAllLEDs(false);
@@ -176,47 +346,38 @@ void ChessBot::waitForRemoteMoveCompletion(int fromRow, int fromCol, int toRow,
     boardDriver->setSquareLED(enPassantCapturedPawnRow, toCol, LedColors::Purple);
   boardDriver->showLEDs();
 
-  bool piecePickedUp = false;
-  bool capturedPieceRemoved = false;
-  bool moveCompleted = false;
-
   Serial.println("Waiting for you to complete the remote move...");
 
-  while (!moveCompleted) {
-    boardDriver->readSensors();
-
-    // For capture moves, ensure captured piece is removed first
-    // For en passant, check the actual captured pawn square (not the destination)
-    if (isCapture && !capturedPieceRemoved) {
-      int captureCheckRow = isEnPassant ? enPassantCapturedPawnRow : toRow;
-      if (!boardDriver->getSensorState(captureCheckRow, toCol)) {
-        capturedPieceRemoved = true;
-        if (isEnPassant)
-          Serial.println("En passant captured pawn removed, now complete the move...");
-        else
-          Serial.println("Captured piece removed, now complete the move...");
-      }
-    }
-
-    // Check if piece was picked up from source
-    if (!piecePickedUp && !boardDriver->getSensorState(fromRow, fromCol)) {
-      piecePickedUp = true;
-      Serial.println("Piece picked up, now place it on the destination...");
-    }
-
-    // Check if piece was placed on destination
-    // For captures: wait until captured piece is removed AND piece is placed
-    // For normal moves: just wait for piece to be placed
-    if (piecePickedUp && boardDriver->getSensorState(toRow, toCol))
-      if (!isCapture || (isCapture && capturedPieceRemoved)) {
-        moveCompleted = true;
-        Serial.println("Move completed on physical board!");
-      }
-
-    delay(SENSOR_READ_DELAY_MS);
-    boardDriver->updateSensorPrev();
+  // Precompute the expected transition sequence: lift the moving piece,
+  // remove the captured piece (from its actual square — en passant differs
+  // from the destination), then place. The wait loop just matches events.
+  ExpectedEdge steps[3];
+  int n = 0;
+  steps[n++] = {(int8_t)fromRow, (int8_t)fromCol, false, "Piece picked up, now place it on the destination..."};
+  if (isCapture) {
+    int captureCheckRow = isEnPassant ? enPassantCapturedPawnRow : toRow;
+    steps[n++] = {(int8_t)captureCheckRow, (int8_t)toCol, false,
+                  isEnPassant ? "En passant captured pawn removed, now complete the move..."
+                              : "Captured piece removed, now complete the move..."};
   }
+  steps[n++] = {(int8_t)toRow, (int8_t)toCol, true, "Move completed on physical board!"};
+  awaitEdgeSequence(steps, n);
 
   boardDriver->clearAllLEDs();
   boardDriver->releaseLEDs();
-}
\ No newline at end of file
+}
+bool ChessBot::lookupKnownMove(uint64_t key, const char board[8][8], int depth, String& uciMove) {
+  // Both begin() calls are idempotent — hints can arrive in modes where no
+  // ChessBot has initialized the shared book/cache yet
+  botBook.begin();
+  sfCache.begin();
+  if (botBook.isAvailable() && botBook.probe(key, board, uciMove))
+    return true;
+  float evaluation;
+  return sfCache.lookup(key, depth, uciMove, evaluation);
+}
+
+void ChessBot::cacheApiMove(uint64_t key, int depth, const String& uciMove, float evaluation) {
+  sfCache.begin();
+  sfCache.store(key, depth, uciMove, evaluation);
+}
@@ -2,9 +2,11 @@
 #define CHESS_BOT_H
 
 #include "chess_game.h"
+#include "chess_search.h"
 #include "chess_utils.h"
 #include "stockfish_api.h"
 #include "stockfish_settings.h"
+#include <atomic>
 
 // ESP32 WiFi includes
 #include <WiFi.h>
@@ -15,12 +17,31 @@ class ChessBot : public ChessGame {
  private:
   BotConfig botConfig;
 
+  // On-device search engine (offline mode and API fallback)
+  ChessSearch localSearch;
+
   // WiFi and API (Stockfish-specific)
-  String makeStockfishRequest(const String& fen);
+  String makeStockfishRequest(const char* fen);
   bool parseStockfishResponse(const String& response, String& bestMove, float& evaluation);
 
-  // Game flow (Stockfish-specific)
-  void makeBotMove();
+  // Predicted human reply from the last API response ("" when unknown)
+  String ponderMove;
+
+  // Non-blocking move computation. update() kicks off a think task and
+  // keeps pumping sensors and gestures while it runs; the result is
+  // applied on the game loop once the state reaches READY/FAILED.
+  enum BotMoveState { BOT_IDLE, BOT_THINKING, BOT_READY, BOT_FAILED };
+  std::atomic<int> moveState;
+  String pendingMove;         // Chosen move (UCI), written by the think task
+  uint64_t pendingKey;        // Zobrist key of the position being searched
+  std::atomic<bool>* thinkAnimation;
+
+  // Game flow
+  void startBotMove();
+  void finishBotMove();
+  static void botThinkTask(void* param);
+  bool makeLocalEngineMove(String& bestMove);
+  void startPonderPrefetch();
 
  protected:
   float currentEvaluation; // Evaluation (in pawns, positive = White advantage)
@@ -30,11 +51,20 @@ class ChessBot : public ChessGame {
 
  public:
   ChessBot(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, MoveHistory* mh, BotConfig cfg);
+  ~ChessBot();
   void begin() override;
   void update() override;
 
   // Get current evaluation
   float getEvaluation() const { return currentEvaluation; }
+
+  // Network-free lookup against the opening book and the Stockfish response
+  // cache (both shared with bot play). Used by the UI hint path so known
+  // positions answer instantly instead of paying an API round trip.
+  static bool lookupKnownMove(uint64_t key, const char board[8][8], int depth, String& uciMove);
+
+  // Store an API result in the response cache so repeat lookups hit
+  static void cacheApiMove(uint64_t key, int depth, const String& uciMove, float evaluation);
 };
 
 #endif // CHESS_BOT_H
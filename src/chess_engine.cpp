@@ -7,12 +7,15 @@
 // ChessEngine Implementation
 // ---------------------------
 
-ChessEngine::ChessEngine() : castlingRights(0x0F), enPassantTargetRow(-1), enPassantTargetCol(-1), halfmoveClock(0), fullmoveClock(1), positionHistoryCount(0) {}
+ChessEngine::ChessEngine() : castlingRights(0x0F), enPassantTargetRow(-1), enPassantTargetCol(-1), halfmoveClock(0), fullmoveClock(1), pieceHash(0), pieceHashValid(false) {
+  clearPositionHistory();
+}
 
-uint64_t ChessEngine::computeZobristHash(const char board[8][8], char sideToMove) const {
+// Full piece-placement recompute: loops all 64 squares with a PROGMEM fetch
+// per occupied square. Only used to (re)seed the incremental hash and as the
+// ZOBRIST_DEBUG_VERIFY cross-check.
+uint64_t ChessEngine::computePieceHash(const char board[8][8]) const {
   uint64_t hash = 0;
-
-  // Hash piece positions
   for (int row = 0; row < 8; row++) {
     for (int col = 0; col < 8; col++) {
       char piece = board[row][col];
@@ -23,26 +26,37 @@ uint64_t ChessEngine::computeZobristHash(const char board[8][8], char sideToMove
       }
     }
   }
+  return hash;
+}
+
+// Hash en passant file only if a legal en passant capture exists.
+// Per FIDE rules, the en passant square only matters for repetition if an opposing pawn can actually make the capture (including not leaving the king in check).
+uint64_t ChessEngine::epHashComponent(const char board[8][8], char sideToMove) const {
+  if (enPassantTargetRow < 0 || enPassantTargetCol < 0)
+    return 0;
+
+  int capturerRow = (sideToMove == 'w') ? enPassantTargetRow + 1 : enPassantTargetRow - 1;
+  char capturerPawn = (sideToMove == 'w') ? 'P' : 'p';
+  bool legalEpMoveExists = false;
+  // Check left adjacent pawn
+  if (enPassantTargetCol > 0 && board[capturerRow][enPassantTargetCol - 1] == capturerPawn && !wouldMoveLeaveKingInCheck(board, capturerRow, enPassantTargetCol - 1, enPassantTargetRow, enPassantTargetCol))
+    legalEpMoveExists = true;
+  // Check right adjacent pawn
+  if (!legalEpMoveExists && enPassantTargetCol < 7 && board[capturerRow][enPassantTargetCol + 1] == capturerPawn && !wouldMoveLeaveKingInCheck(board, capturerRow, enPassantTargetCol + 1, enPassantTargetRow, enPassantTargetCol))
+    legalEpMoveExists = true;
+
+  return legalEpMoveExists ? ZOBRIST_EN_PASSANT[enPassantTargetCol] : 0;
+}
+
+uint64_t ChessEngine::computeZobristHash(const char board[8][8], char sideToMove) const {
+  // Hash piece positions
+  uint64_t hash = computePieceHash(board);
 
   // https://lichess.org/forum/general-chess-discussion/3-fold-repetition-and-castling-rights-sarana-martinez
   // Hash castling rights (unlike en-passant, castling rights always matter for repetition and are only lost AFTER a rook or king moves, even if there are no legal castling moves now or never again in the future, they still count)
   hash ^= ZOBRIST_CASTLING[castlingRights];
 
-  // Hash en passant file only if a legal en passant capture exists.
-  // Per FIDE rules, the en passant square only matters for repetition if an opposing pawn can actually make the capture (including not leaving the king in check).
-  if (enPassantTargetRow >= 0 && enPassantTargetCol >= 0) {
-    int capturerRow = (sideToMove == 'w') ? enPassantTargetRow + 1 : enPassantTargetRow - 1;
-    char capturerPawn = (sideToMove == 'w') ? 'P' : 'p';
-    bool legalEpMoveExists = false;
-    // Check left adjacent pawn
-    if (enPassantTargetCol > 0 && board[capturerRow][enPassantTargetCol - 1] == capturerPawn && !wouldMoveLeaveKingInCheck(board, capturerRow, enPassantTargetCol - 1, enPassantTargetRow, enPassantTargetCol))
-      legalEpMoveExists = true;
-    // Check right adjacent pawn
-    if (!legalEpMoveExists && enPassantTargetCol < 7 && board[capturerRow][enPassantTargetCol + 1] == capturerPawn && !wouldMoveLeaveKingInCheck(board, capturerRow, enPassantTargetCol + 1, enPassantTargetRow, enPassantTargetCol))
-      legalEpMoveExists = true;
-    if (legalEpMoveExists)
-      hash ^= ZOBRIST_EN_PASSANT[enPassantTargetCol];
-  }
+  hash ^= epHashComponent(board, sideToMove);
 
   // Hash side to move
   if (sideToMove == 'b')
@@ -51,6 +65,30 @@ uint64_t ChessEngine::computeZobristHash(const char board[8][8], char sideToMove
   return hash;
 }
 
+void ChessEngine::hashMovePiece(char piece, int fromRow, int fromCol, int toRow, int toCol) {
+  if (!pieceHashValid)
+    return; // Will be reseeded from the board on the next recordPosition
+  int idx = pieceToZobristIndex(piece);
+  if (idx < 0)
+    return;
+  pieceHash ^= ZOBRIST_TABLE[idx][fromRow * 8 + fromCol];
+  pieceHash ^= ZOBRIST_TABLE[idx][toRow * 8 + toCol];
+}
+
+void ChessEngine::hashSetPiece(char piece, int row, int col) {
+  if (!pieceHashValid)
+    return;
+  int idx = pieceToZobristIndex(piece);
+  if (idx < 0)
+    return;
+  pieceHash ^= ZOBRIST_TABLE[idx][row * 8 + col];
+}
+
+void ChessEngine::hashClearPiece(char piece, int row, int col) {
+  // Set and clear are the same XOR; the separate names keep call sites readable
+  hashSetPiece(piece, row, col);
+}
+
 void ChessEngine::recordPosition(const char board[8][8], char sideToMove) {
   // Clear history on irreversible moves (pawn move or capture reset halfmoveClock to 0).
   // Positions from before an irreversible move can never recur, so this is safe
@@ -58,31 +96,74 @@ void ChessEngine::recordPosition(const char board[8][8], char sideToMove) {
   if (halfmoveClock == 0)
     clearPositionHistory();
 
-  if (positionHistoryCount < MAX_POSITION_HISTORY)
-    positionHistory[positionHistoryCount++] = computeZobristHash(board, sideToMove);
+  if (!pieceHashValid) {
+    pieceHash = computePieceHash(board);
+    pieceHashValid = true;
+  }
+#ifdef ZOBRIST_DEBUG_VERIFY
+  if (pieceHash != computePieceHash(board))
+    Serial.println("ZOBRIST MISMATCH: incremental piece hash diverged from full recompute!");
+#endif
+
+  uint64_t hash = pieceHash ^ ZOBRIST_CASTLING[castlingRights] ^ epHashComponent(board, sideToMove);
+  if (sideToMove == 'b')
+    hash ^= ZOBRIST_SIDE_TO_MOVE;
+
+  // Linear-probe for the position's slot and bump its count. The table can't
+  // realistically fill (irreversible-move clears bound live entries well
+  // below REPETITION_TABLE_SIZE), but leave one slot free so probing always
+  // terminates.
+  if (repetitionEntryCount >= REPETITION_TABLE_SIZE - 1) {
+    lastRecordedCount = 1;
+    return;
+  }
+  int slot = (int)(hash & (REPETITION_TABLE_SIZE - 1));
+  while (repetitionTable[slot].count != 0 && repetitionTable[slot].hash != hash)
+    slot = (slot + 1) & (REPETITION_TABLE_SIZE - 1);
+  if (repetitionTable[slot].count == 0) {
+    repetitionTable[slot].hash = hash;
+    repetitionEntryCount++;
+  }
+  if (repetitionTable[slot].count < 255)
+    repetitionTable[slot].count++;
+  lastRecordedCount = repetitionTable[slot].count;
 }
 
 void ChessEngine::clearPositionHistory() {
-  positionHistoryCount = 0;
+  for (int i = 0; i < REPETITION_TABLE_SIZE; i++)
+    repetitionTable[i].count = 0;
+  repetitionEntryCount = 0;
+  lastRecordedCount = 0;
 }
 
 bool ChessEngine::isThreefoldRepetition() const {
-  // Minimum 5 half-moves for 3 occurrences of same position
-  if (positionHistoryCount < 5)
-    return false;
+  // recordPosition already counted occurrences of the current position
+  return lastRecordedCount >= 3;
+}
 
-  uint64_t current = positionHistory[positionHistoryCount - 1];
-  int count = 1; // Current position counts as 1
-  // Scan backwards, skipping every other entry (only same side-to-move can match).
-  // Backwards scan finds recent repetitions faster for early exit.
-  for (int i = positionHistoryCount - 3; i >= 0; i -= 2) {
-    if (positionHistory[i] == current) {
-      count++;
-      if (count >= 3)
-        return true;
-    }
+int ChessEngine::exportRepetitionState(uint64_t* hashes, uint8_t* counts, int maxEntries) const {
+  int n = 0;
+  for (int i = 0; i < REPETITION_TABLE_SIZE && n < maxEntries; i++) {
+    if (repetitionTable[i].count == 0) continue;
+    hashes[n] = repetitionTable[i].hash;
+    counts[n] = repetitionTable[i].count;
+    n++;
   }
-  return false;
+  return n;
+}
+
+void ChessEngine::importRepetitionState(const uint64_t* hashes, const uint8_t* counts, int n, uint8_t lastCount) {
+  clearPositionHistory();
+  for (int i = 0; i < n && repetitionEntryCount < REPETITION_TABLE_SIZE - 1; i++) {
+    int slot = (int)(hashes[i] & (REPETITION_TABLE_SIZE - 1));
+    while (repetitionTable[slot].count != 0)
+      slot = (slot + 1) & (REPETITION_TABLE_SIZE - 1);
+    repetitionTable[slot].hash = hashes[i];
+    repetitionTable[slot].count = counts[i];
+    repetitionEntryCount++;
+  }
+  lastRecordedCount = lastCount;
+  pieceHashValid = false; // Recomputed from the board on next recordPosition
 }
 
 void ChessEngine::setCastlingRights(uint8_t rights) {
@@ -145,6 +226,40 @@ void ChessEngine::incrementFullmoveClock(char sideJustMoved) {
     fullmoveClock++;
 }
 
+// Emit one move per set bit of a destination mask
+static void emitMovesFromMask(uint64_t mask, int& moveCount, int moves[][2]) {
+  while (mask) {
+    int sq = Bitboards::lsb(mask);
+    mask = Bitboards::clearLsb(mask);
+    moves[moveCount][0] = sq >> 3;
+    moves[moveCount][1] = sq & 7;
+    moveCount++;
+  }
+}
+
+// Attack query against the bitboard representation: is sq attacked by any
+// piece of attackingColor? Pawns use the symmetry trick (the white pawns
+// attacking sq are exactly the squares a black pawn on sq would attack).
+static bool squareAttacked(const PieceBitboards& bb, int sq, char attackingColor) {
+  int base = (attackingColor == 'w') ? 0 : 6;
+
+  if (Bitboards::pawnAttacks(attackingColor == 'w' ? 'b' : 'w', sq) & bb.pieces[base + 0])
+    return true;
+  if (Bitboards::knightAttacks(sq) & bb.pieces[base + 1])
+    return true;
+  if (Bitboards::kingAttacks(sq) & bb.pieces[base + 5])
+    return true;
+
+  uint64_t diagSliders = bb.pieces[base + 2] | bb.pieces[base + 4]; // bishops + queens
+  if (diagSliders && (Bitboards::bishopAttacks(sq, bb.all) & diagSliders))
+    return true;
+  uint64_t lineSliders = bb.pieces[base + 3] | bb.pieces[base + 4]; // rooks + queens
+  if (lineSliders && (Bitboards::rookAttacks(sq, bb.all) & lineSliders))
+    return true;
+
+  return false;
+}
+
 // Generate pseudo-legal moves (without check filtering)
 void ChessEngine::getPseudoLegalMoves(const char board[8][8], int row, int col, int& moveCount, int moves[][2], bool includeCastling) const {
   moveCount = 0;
@@ -153,6 +268,9 @@ void ChessEngine::getPseudoLegalMoves(const char board[8][8], int row, int col,
   if (piece == ' ')
     return; // Empty square
 
+  // Build the bitboards once; the per-piece generators below index into them
+  bitboards.buildFromBoard(board);
+
   char pieceColor = ChessUtils::getPieceColor(piece);
 
   switch (toupper(piece)) {
@@ -253,78 +371,28 @@ void ChessEngine::addPawnMoves(const char board[8][8], int row, int col, char pi
   }
 }
 
-// Rook move generation
+// Rook move generation (sliding attacks over the occupancy bitboard)
 void ChessEngine::addRookMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2]) const {
-  int directions[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-
-  for (int d = 0; d < 4; d++)
-    for (int step = 1; step < 8; step++) {
-      int newRow = row + step * directions[d][0];
-      int newCol = col + step * directions[d][1];
-
-      if (!isValidSquare(newRow, newCol))
-        break;
-
-      if (isSquareEmpty(board, newRow, newCol)) {
-        moves[moveCount][0] = newRow;
-        moves[moveCount][1] = newCol;
-        moveCount++;
-      } else {
-        // Check if it's a capturable piece
-        if (isSquareOccupiedByOpponent(board, newRow, newCol, pieceColor)) {
-          moves[moveCount][0] = newRow;
-          moves[moveCount][1] = newCol;
-          moveCount++;
-        }
-        break; // Can't move past any piece
-      }
-    }
+  (void)board; // Position comes from the bitboards built in getPseudoLegalMoves
+  uint64_t own = bitboards.occupied[(pieceColor == 'w') ? 0 : 1];
+  uint64_t mask = Bitboards::rookAttacks(row * 8 + col, bitboards.all) & ~own;
+  emitMovesFromMask(mask, moveCount, moves);
 }
 
-// Knight move generation
+// Knight move generation (precomputed attack table)
 void ChessEngine::addKnightMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2]) const {
-  int knightMoves[8][2] = {{2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
-
-  for (int i = 0; i < 8; i++) {
-    int newRow = row + knightMoves[i][0];
-    int newCol = col + knightMoves[i][1];
-
-    if (isValidSquare(newRow, newCol))
-      if (isSquareEmpty(board, newRow, newCol) ||
-          isSquareOccupiedByOpponent(board, newRow, newCol, pieceColor)) {
-        moves[moveCount][0] = newRow;
-        moves[moveCount][1] = newCol;
-        moveCount++;
-      }
-  }
+  (void)board;
+  uint64_t own = bitboards.occupied[(pieceColor == 'w') ? 0 : 1];
+  uint64_t mask = Bitboards::knightAttacks(row * 8 + col) & ~own;
+  emitMovesFromMask(mask, moveCount, moves);
 }
 
-// Bishop move generation
+// Bishop move generation (sliding attacks over the occupancy bitboard)
 void ChessEngine::addBishopMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2]) const {
-  int directions[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
-
-  for (int d = 0; d < 4; d++)
-    for (int step = 1; step < 8; step++) {
-      int newRow = row + step * directions[d][0];
-      int newCol = col + step * directions[d][1];
-
-      if (!isValidSquare(newRow, newCol))
-        break;
-
-      if (isSquareEmpty(board, newRow, newCol)) {
-        moves[moveCount][0] = newRow;
-        moves[moveCount][1] = newCol;
-        moveCount++;
-      } else {
-        // Check if it's a capturable piece
-        if (isSquareOccupiedByOpponent(board, newRow, newCol, pieceColor)) {
-          moves[moveCount][0] = newRow;
-          moves[moveCount][1] = newCol;
-          moveCount++;
-        }
-        break; // Can't move past any piece
-      }
-    }
+  (void)board;
+  uint64_t own = bitboards.occupied[(pieceColor == 'w') ? 0 : 1];
+  uint64_t mask = Bitboards::bishopAttacks(row * 8 + col, bitboards.all) & ~own;
+  emitMovesFromMask(mask, moveCount, moves);
 }
 
 // Queen move generation (combination of rook and bishop)
@@ -333,22 +401,11 @@ void ChessEngine::addQueenMoves(const char board[8][8], int row, int col, char p
   addBishopMoves(board, row, col, pieceColor, moveCount, moves);
 }
 
-// King move generation
+// King move generation (precomputed attack table)
 void ChessEngine::addKingMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2], bool includeCastling) const {
-  int kingMoves[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
-
-  for (int i = 0; i < 8; i++) {
-    int newRow = row + kingMoves[i][0];
-    int newCol = col + kingMoves[i][1];
-
-    if (isValidSquare(newRow, newCol))
-      if (isSquareEmpty(board, newRow, newCol) ||
-          isSquareOccupiedByOpponent(board, newRow, newCol, pieceColor)) {
-        moves[moveCount][0] = newRow;
-        moves[moveCount][1] = newCol;
-        moveCount++;
-      }
-  }
+  uint64_t own = bitboards.occupied[(pieceColor == 'w') ? 0 : 1];
+  uint64_t mask = Bitboards::kingAttacks(row * 8 + col) & ~own;
+  emitMovesFromMask(mask, moveCount, moves);
 
   if (includeCastling)
     addCastlingMoves(board, row, col, pieceColor, moveCount, moves);
@@ -471,42 +528,20 @@ bool ChessEngine::findKingPosition(const char board[8][8], char kingColor, int&
 bool ChessEngine::isSquareUnderAttack(const char board[8][8], int row, int col, char defendingColor) const {
   char attackingColor = (defendingColor == 'w') ? 'b' : 'w';
 
-  // Check all opponent pieces to see if any can attack this square
-  for (int r = 0; r < 8; r++)
-    for (int c = 0; c < 8; c++) {
-      char piece = board[r][c];
-      if (piece == ' ') continue;
-
-      char pieceColor = ChessUtils::getPieceColor(piece);
-      if (pieceColor != attackingColor) continue;
-
-      // Pawns are special: their attack pattern differs from their move pattern.
-      if (toupper(piece) == 'P') {
-        int direction = (pieceColor == 'w') ? -1 : 1;
-        if (r + direction == row && (c - 1 == col || c + 1 == col))
-          return true;
-        continue;
-      }
-
-      // Get pseudo-legal moves for this enemy piece (no check filtering to avoid recursion)
-      int moveCount = 0;
-      int moves[28][2];
-      // IMPORTANT: for attack detection, do NOT include castling moves
-      getPseudoLegalMoves(board, r, c, moveCount, moves, false);
-
-      // Check if any of those moves target our square
-      for (int i = 0; i < moveCount; i++)
-        if (moves[i][0] == row && moves[i][1] == col)
-          return true; // Square is under attack
-    }
-
-  return false; // Square is safe
+  // Rebuild the bitboards for this board and run the query as a handful of
+  // table lookups and mask intersections instead of per-piece move generation
+  bitboards.buildFromBoard(board);
+  return squareAttacked(bitboards, row * 8 + col, attackingColor);
 }
 
-// Make a temporary move on a board copy
-void ChessEngine::makeMove(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, char& capturedPiece) const {
-  capturedPiece = board[toRow][toCol];
+// Apply a move in place, filling `undo` with everything needed to restore it
+void ChessEngine::makeMoveWithUndo(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, MoveUndo& undo) const {
   char movingPiece = board[fromRow][fromCol];
+  undo.movedPiece = movingPiece;
+  undo.capturedPiece = board[toRow][toCol];
+  undo.capturedRow = toRow;
+  undo.capturedCol = toCol;
+  undo.castling = false;
 
   board[toRow][toCol] = movingPiece;
   board[fromRow][fromCol] = ' ';
@@ -514,23 +549,18 @@ void ChessEngine::makeMove(char board[8][8], int fromRow, int fromCol, int toRow
   // Handle castling as a compound move (move rook too)
   if (toupper(movingPiece) == 'K' && fromRow == toRow) {
     int deltaCol = toCol - fromCol;
-    if (deltaCol == 2) {
-      // King-side: rook h-file -> f-file
-      int rookFromCol = 7;
-      int rookToCol = 5;
-      char rookPiece = (movingPiece >= 'a' && movingPiece <= 'z') ? 'r' : 'R';
-      if (board[toRow][rookFromCol] == rookPiece) {
-        board[toRow][rookToCol] = rookPiece;
-        board[toRow][rookFromCol] = ' ';
-      }
-    } else if (deltaCol == -2) {
-      // Queen-side: rook a-file -> d-file
-      int rookFromCol = 0;
-      int rookToCol = 3;
+    if (deltaCol == 2 || deltaCol == -2) {
+      int rookFromCol = (deltaCol == 2) ? 7 : 0;
+      int rookToCol = (deltaCol == 2) ? 5 : 3;
       char rookPiece = (movingPiece >= 'a' && movingPiece <= 'z') ? 'r' : 'R';
       if (board[toRow][rookFromCol] == rookPiece) {
         board[toRow][rookToCol] = rookPiece;
         board[toRow][rookFromCol] = ' ';
+        undo.castling = true;
+        undo.rookRow = toRow;
+        undo.rookFromCol = rookFromCol;
+        undo.rookToCol = rookToCol;
+        undo.rookPiece = rookPiece;
       }
     }
   }
@@ -538,39 +568,49 @@ void ChessEngine::makeMove(char board[8][8], int fromRow, int fromCol, int toRow
   // Handle en passant capture
   if (toupper(movingPiece) == 'P' && hasEnPassantTarget()) {
     // If moving to the en passant target square, remove the captured pawn
-    if (toRow == enPassantTargetRow && toCol == enPassantTargetCol && capturedPiece == ' ') {
+    if (toRow == enPassantTargetRow && toCol == enPassantTargetCol && undo.capturedPiece == ' ') {
       // The captured pawn is one square behind the target (in the opposite direction)
       int enPassantCapturedPawnRow = ChessUtils::getEnPassantCapturedPawnRow(toRow, movingPiece);
-      capturedPiece = board[enPassantCapturedPawnRow][toCol];
+      undo.capturedPiece = board[enPassantCapturedPawnRow][toCol];
+      undo.capturedRow = enPassantCapturedPawnRow;
       board[enPassantCapturedPawnRow][toCol] = ' ';
     }
   }
 }
 
+// Restore a move applied by makeMoveWithUndo
+void ChessEngine::unmakeMove(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, const MoveUndo& undo) const {
+  board[toRow][toCol] = ' ';
+  board[fromRow][fromCol] = undo.movedPiece;
+  if (undo.capturedPiece != ' ')
+    board[undo.capturedRow][undo.capturedCol] = undo.capturedPiece;
+  if (undo.castling) {
+    board[undo.rookRow][undo.rookFromCol] = undo.rookPiece;
+    board[undo.rookRow][undo.rookToCol] = ' ';
+  }
+}
+
 bool ChessEngine::wouldMoveLeaveKingInCheck(const char board[8][8], int fromRow, int fromCol, int toRow, int toCol) const {
-  // Create a copy of the board to test the move
-  char testBoard[8][8];
-  for (int r = 0; r < 8; r++)
-    for (int c = 0; c < 8; c++)
-      testBoard[r][c] = board[r][c];
+  // Make/unmake in place instead of copying the whole board per candidate
+  // move. The board is restored before returning, so the const signature
+  // still reflects the caller-visible contract.
+  char(*mutableBoard)[8] = const_cast<char(*)[8]>(board);
 
   // Get the color of the piece being moved
-  char movingPiece = testBoard[fromRow][fromCol];
+  char movingPiece = board[fromRow][fromCol];
   char movingColor = ChessUtils::getPieceColor(movingPiece);
 
-  // Make the move on the test board
-  char capturedPiece;
-  makeMove(testBoard, fromRow, fromCol, toRow, toCol, capturedPiece);
+  MoveUndo undo;
+  makeMoveWithUndo(mutableBoard, fromRow, fromCol, toRow, toCol, undo);
 
   // Find the king (it might have moved if the piece being moved was the king)
   int kingRow, kingCol;
-  bool kingFound = findKingPosition(testBoard, movingColor, kingRow, kingCol);
+  bool kingFound = findKingPosition(board, movingColor, kingRow, kingCol);
 
-  if (!kingFound)
-    return true; // If king not found, move is definitely illegal
+  // Check if the king is in check after the move (king not found = illegal)
+  bool inCheck = !kingFound || isSquareUnderAttack(board, kingRow, kingCol, movingColor);
 
-  // Check if the king is in check after the move
-  bool inCheck = isSquareUnderAttack(testBoard, kingRow, kingCol, movingColor);
+  unmakeMove(mutableBoard, fromRow, fromCol, toRow, toCol, undo);
 
   return inCheck;
 }
@@ -584,22 +624,40 @@ bool ChessEngine::isKingInCheck(const char board[8][8], char kingColor) {
   return isSquareUnderAttack(board, kingRow, kingCol, kingColor);
 }
 
-bool ChessEngine::hasAnyLegalMove(const char board[8][8], char color) {
-  for (int fromRow = 0; fromRow < 8; fromRow++)
-    for (int fromCol = 0; fromCol < 8; fromCol++) {
-      char piece = board[fromRow][fromCol];
-      if (piece == ' ') continue;
+void ChessEngine::getAllLegalMoves(const char board[8][8], char color, MoveList& list, bool firstMoveOnly) {
+  list.clear();
 
-      if (ChessUtils::getPieceColor(piece) != color) continue;
+  // Iterate only the side's occupied squares via the bitboards instead of
+  // scanning all 64 squares
+  bitboards.buildFromBoard(board);
+  uint64_t occ = bitboards.occupied[(color == 'w') ? 0 : 1];
 
-      int moveCount = 0;
-      int moves[28][2];
-      getPossibleMoves(board, fromRow, fromCol, moveCount, moves);
-      if (moveCount > 0)
-        return true;
+  while (occ) {
+    int sq = Bitboards::lsb(occ);
+    occ = Bitboards::clearLsb(occ);
+    int fromRow = sq >> 3;
+    int fromCol = sq & 7;
+
+    int pseudoMoveCount = 0;
+    int pseudoMoves[28][2];
+    getPseudoLegalMoves(board, fromRow, fromCol, pseudoMoveCount, pseudoMoves, true);
+
+    for (int i = 0; i < pseudoMoveCount; i++) {
+      int toRow = pseudoMoves[i][0];
+      int toCol = pseudoMoves[i][1];
+      if (wouldMoveLeaveKingInCheck(board, fromRow, fromCol, toRow, toCol))
+        continue;
+      list.add(fromRow, fromCol, toRow, toCol);
+      if (firstMoveOnly)
+        return;
     }
+  }
+}
 
-  return false;
+bool ChessEngine::hasAnyLegalMove(const char board[8][8], char color) {
+  MoveList list;
+  getAllLegalMoves(board, color, list, true);
+  return list.count > 0;
 }
 
 bool ChessEngine::isCheckmate(const char board[8][8], char kingColor) {
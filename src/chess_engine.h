@@ -1,8 +1,36 @@
 #ifndef CHESS_ENGINE_H
 #define CHESS_ENGINE_H
 
+#include "bitboards.h"
 #include <stdint.h>
 
+// Upper bound on legal moves in any reachable position (proven max is 218)
+#define MAX_LEGAL_MOVES 220
+
+// A single generated move in board coordinates
+struct EngineMove {
+  int8_t fromRow, fromCol;
+  int8_t toRow, toCol;
+};
+
+// Fixed-capacity move list filled by ChessEngine::getAllLegalMoves.
+// Caller-provided so the generator never allocates.
+struct MoveList {
+  EngineMove moves[MAX_LEGAL_MOVES];
+  int count;
+
+  void clear() { count = 0; }
+  void add(int fromRow, int fromCol, int toRow, int toCol) {
+    if (count >= MAX_LEGAL_MOVES)
+      return;
+    moves[count].fromRow = (int8_t)fromRow;
+    moves[count].fromCol = (int8_t)fromCol;
+    moves[count].toRow = (int8_t)toRow;
+    moves[count].toCol = (int8_t)toCol;
+    count++;
+  }
+};
+
 // ---------------------------
 // Chess Engine Class
 // ---------------------------
@@ -25,10 +53,31 @@ class ChessEngine {
   int fullmoveClock;
 
   // --- Zobrist hashing for threefold repetition detection ---
-  // Position history (cleared on irreversible moves for memory efficiency)
-#define MAX_POSITION_HISTORY 128
-  uint64_t positionHistory[MAX_POSITION_HISTORY];
-  int positionHistoryCount;
+  // Open-addressed hash table (hash -> occurrence count) with linear probing,
+  // cleared on irreversible moves. The 50-move rule bounds live entries to
+  // ~100, so a power-of-2 table of 256 slots keeps the load factor below 0.4
+  // and probes short. Repetition detection is then an O(1) count lookup
+  // instead of a linear history scan.
+#define REPETITION_TABLE_SIZE 256
+  struct RepetitionEntry {
+    uint64_t hash;
+    uint8_t count; // 0 = slot empty
+  };
+  RepetitionEntry repetitionTable[REPETITION_TABLE_SIZE];
+  int repetitionEntryCount;
+  uint8_t lastRecordedCount; // Occurrences of the most recently recorded position
+
+  // Incrementally maintained piece-placement hash component. The callers that
+  // mutate the board (ChessGame::applyMove and friends) report every square
+  // change through the hash* methods below, so recordPosition only has to XOR
+  // in the cheap castling/en-passant/side components instead of re-walking all
+  // 64 squares with a PROGMEM fetch per piece. Invalidated on reset and
+  // lazily recomputed from the board on the next recordPosition.
+  uint64_t pieceHash;
+  bool pieceHashValid;
+
+  uint64_t computePieceHash(const char board[8][8]) const;
+  uint64_t epHashComponent(const char board[8][8], char sideToMove) const;
 
   static inline int pieceToZobristIndex(char piece) {
     const char* pieces = "PNBRQKpnbrqk";
@@ -36,6 +85,12 @@ class ChessEngine {
     return p ? (int)(p - pieces) : -1;
   };
 
+  // Parallel bitboard representation of the mailbox board, rebuilt on demand
+  // from whichever board the caller passes in. Attack queries and the
+  // knight/king/slider move generators run against this instead of scanning
+  // squares one at a time.
+  mutable PieceBitboards bitboards;
+
   // Helper functions for move generation
   void addPawnMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2]) const;
   void addRookMoves(const char board[8][8], int row, int col, char pieceColor, int& moveCount, int moves[][2]) const;
@@ -51,11 +106,23 @@ class ChessEngine {
   bool isSquareEmpty(const char board[8][8], int row, int col) const;
   bool isValidSquare(int row, int col) const;
 
+  // Undo record for make/unmake legality testing: everything needed to
+  // restore the board after a candidate move is applied in place
+  struct MoveUndo {
+    char movedPiece;
+    char capturedPiece;
+    int capturedRow, capturedCol; // differs from the target square for en passant
+    bool castling;
+    int rookRow, rookFromCol, rookToCol;
+    char rookPiece;
+  };
+
   // Check detection helpers
   void getPseudoLegalMoves(const char board[8][8], int row, int col, int& moveCount, int moves[][2], bool includeCastling = true) const;
   bool isSquareUnderAttack(const char board[8][8], int row, int col, char defendingColor) const;
   bool wouldMoveLeaveKingInCheck(const char board[8][8], int fromRow, int fromCol, int toRow, int toCol) const;
-  void makeMove(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, char& capturedPiece) const;
+  void makeMoveWithUndo(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, MoveUndo& undo) const;
+  void unmakeMove(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, const MoveUndo& undo) const;
 
  public:
   ChessEngine();
@@ -67,6 +134,7 @@ class ChessEngine {
     halfmoveClock = 0;
     fullmoveClock = 1;
     clearPositionHistory();
+    pieceHashValid = false; // Recomputed from the board on next recordPosition
   }
 
   // Set castling rights bitmask (KQkq = 0b1111)
@@ -96,9 +164,28 @@ class ChessEngine {
   void clearPositionHistory();
   bool isThreefoldRepetition() const;
 
+  // Export/import the live repetition entries as (hash, count) pairs so the
+  // fast-resume snapshot can restore threefold state without a full replay
+  int exportRepetitionState(uint64_t* hashes, uint8_t* counts, int maxEntries) const;
+  void importRepetitionState(const uint64_t* hashes, const uint8_t* counts, int n, uint8_t lastCount);
+  uint8_t getLastRecordedCount() const { return lastRecordedCount; }
+
+  // Incremental hash maintenance: board mutators call these alongside each
+  // square change so the piece hash never needs a full 64-square recompute.
+  // Define ZOBRIST_DEBUG_VERIFY to cross-check against the full recompute.
+  void hashMovePiece(char piece, int fromRow, int fromCol, int toRow, int toCol);
+  void hashSetPiece(char piece, int row, int col);
+  void hashClearPiece(char piece, int row, int col);
+
   // Main move generation function
   void getPossibleMoves(const char board[8][8], int row, int col, int& moveCount, int moves[][2]);
 
+  // Generate every legal move for `color` in a single pass into `list`.
+  // With firstMoveOnly set, returns as soon as one legal move is found
+  // (existence check for mate/stalemate detection without generating the
+  // full move set).
+  void getAllLegalMoves(const char board[8][8], char color, MoveList& list, bool firstMoveOnly = false);
+
   // Move validation
   bool isValidMove(const char board[8][8], int fromRow, int fromCol, int toRow, int toCol);
 
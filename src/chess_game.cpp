@@ -1,5 +1,6 @@
 #include "chess_game.h"
 #include "chess_utils.h"
+#include "perf_stats.h"
 #include "move_history.h"
 #include "ui_comm.h"
 #include "wifi_manager_esp32.h"
@@ -16,17 +17,20 @@ const char ChessGame::INITIAL_BOARD[8][8] = {
     {'R', 'N', 'B', 'Q', 'K', 'B', 'N', 'R'}  // row 7 = rank 1 (White pieces, bottom row)
 };
 
-ChessGame::ChessGame(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, MoveHistory* mh) : boardDriver(bd), chessEngine(ce), wifiManager(wm), moveHistory(mh), currentTurn('w'), gameOver(false), replaying(false), lastUciMove("") {}
+ChessGame::ChessGame(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, MoveHistory* mh) : boardDriver(bd), chessEngine(ce), wifiManager(wm), moveHistory(mh), currentTurn('w'), materialScore(0.0f), gameOver(false), replaying(false), lastUciMove(""), lastPublishKey(0), lastPublishValid(false), legalCacheValid(false) {
+  memset(legalDestMask, 0, sizeof(legalDestMask));
+}
 
 void ChessGame::initializeBoard() {
   currentTurn = 'w';
   gameOver = false;
   lastUciMove = "";
+  legalCacheValid = false;
   memcpy(board, INITIAL_BOARD, sizeof(INITIAL_BOARD));
   chessEngine->reset();
   chessEngine->recordPosition(board, currentTurn);
-  wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-  sendUiState();
+  materialScore = ChessUtils::evaluatePosition(board); // Full scan only on (re)seed
+  publishBoardState(materialScore);
 }
 
 void ChessGame::waitForBoardSetup(const char targetBoard[8][8]) {
@@ -87,6 +91,8 @@ void ChessGame::waitForBoardSetup(const char targetBoard[8][8]) {
 }
 
 void ChessGame::applyMove(int fromRow, int fromCol, int toRow, int toCol, char promotion, bool isRemoteMove) {
+  PERF_SCOPE(PERF_APPLY_MOVE);
+  legalCacheValid = false; // Stale the moment the board changes
   char piece = board[fromRow][fromCol];
   char capturedPiece = board[toRow][toCol];
 
@@ -102,12 +108,18 @@ void ChessGame::applyMove(int fromRow, int fromCol, int toRow, int toCol, char p
   if (isEnPassantCapture) {
     capturedPiece = board[enPassantCapturedPawnRow][toCol];
     board[enPassantCapturedPawnRow][toCol] = ' ';
+    chessEngine->hashClearPiece(capturedPiece, enPassantCapturedPawnRow, toCol);
+  } else if (capturedPiece != ' ') {
+    chessEngine->hashClearPiece(capturedPiece, toRow, toCol);
   }
+  if (capturedPiece != ' ')
+    materialScore -= ChessUtils::signedPieceValue(capturedPiece);
 
   chessEngine->updateHalfmoveClock(piece, capturedPiece);
 
   board[toRow][toCol] = piece;
   board[fromRow][fromCol] = ' ';
+  chessEngine->hashMovePiece(piece, fromRow, fromCol, toRow, toCol);
 
   Serial.printf("%s %s: %c %c%d -> %c%d\n", isRemoteMove ? "Remote" : "Player", isCastling ? "castling" : (isEnPassantCapture ? "en passant" : (capturedPiece != ' ' ? "capture" : "move")), piece, (char)('a' + fromCol), 8 - fromRow, (char)('a' + toCol), 8 - toRow);
 
@@ -163,6 +175,9 @@ void ChessGame::applyMove(int fromRow, int fromCol, int toRow, int toCol, char p
       promotion = ChessUtils::isWhitePiece(piece) ? 'Q' : 'q';
     }
     board[toRow][toCol] = promotion;
+    chessEngine->hashClearPiece(piece, toRow, toCol); // Pawn leaves the board
+    chessEngine->hashSetPiece(promotion, toRow, toCol);
+    materialScore += ChessUtils::signedPieceValue(promotion) - ChessUtils::signedPieceValue(piece);
     Serial.printf("Pawn promoted to %c\n", promotion);
   }
 
@@ -174,40 +189,51 @@ void ChessGame::applyMove(int fromRow, int fromCol, int toRow, int toCol, char p
 }
 
 bool ChessGame::tryPlayerMove(char playerColor, int& fromRow, int& fromCol, int& toRow, int& toCol) {
-  for (int row = 0; row < 8; row++)
-    for (int col = 0; col < 8; col++) {
-      // Continue if nothing was picked up from this square
-      if (!boardDriver->getSensorPrev(row, col) || boardDriver->getSensorState(row, col))
-        continue;
-
-      char piece = board[row][col];
-
-      // Skip empty squares
-      if (piece == ' ')
-        continue;
-
-      // Check if it's the correct player's piece
-      if (ChessUtils::getPieceColor(piece) != playerColor) {
-        Serial.printf("Wrong turn! It's %s's turn to move.\n", ChessUtils::colorName(playerColor));
-        boardDriver->blinkSquare(row, col, LedColors::Red, 2);
-        continue;
-      }
-
-      Serial.printf("Piece pickup from %c%d\n", (char)('a' + col), 8 - row);
+  // Pickups are consumed from the sensor task's event queue rather than a
+  // prev/state comparison, so a lift that happened while this loop was blocked
+  // (network request, web handler) is still delivered here instead of lost
+  SensorEvent event;
+  while (boardDriver->getSensorEvent(event)) {
+    // Placements are handled by the wait loops below
+    if (event.present)
+      continue;
+    int row = event.row;
+    int col = event.col;
+
+    // Stale lift: the piece is already back down, so no move is in progress
+    // (a lift-and-replace is a cancelled pickup anyway)
+    if (boardDriver->getSensorState(row, col))
+      continue;
+
+    char piece = board[row][col];
+
+    // Skip empty squares (e.g. lifts already resolved by an applied move)
+    if (piece == ' ')
+      continue;
+
+    // Check if it's the correct player's piece
+    if (ChessUtils::getPieceColor(piece) != playerColor) {
+      Serial.printf("Wrong turn! It's %s's turn to move.\n", ChessUtils::colorName(playerColor));
+      boardDriver->blinkSquare(row, col, LedColors::Red, 2);
+      continue;
+    }
 
-      // Generate possible moves
-      int moveCount = 0;
-      int moves[28][2];
-      chessEngine->getPossibleMoves(board, row, col, moveCount, moves);
+    Serial.printf("Piece pickup from %c%d\n", (char)('a' + col), 8 - row);
 
-      // Light up current square and possible move squares
-      boardDriver->setSquareLED(row, col, LedColors::Cyan);
+    // Safety net for paths that reach here without a status pass (e.g.
+    // right after a resume); the per-turn refresh makes this a no-op
+    if (!legalCacheValid)
+      refreshLegalMoveCache();
+    uint64_t destMask = legalDestMask[row][col];
 
-      // Highlight possible move squares (different colors for empty vs capture)
-      for (int i = 0; i < moveCount; i++) {
-        int r = moves[i][0];
-        int c = moves[i][1];
+    // Light up current square and possible move squares
+    boardDriver->setSquareLED(row, col, LedColors::Cyan);
 
+    // Highlight possible move squares (different colors for empty vs capture)
+    for (int r = 0; r < 8; r++)
+      for (int c = 0; c < 8; c++) {
+        if (!((destMask >> (r * 8 + c)) & 1))
+          continue;
         bool isEnPassantCapture = ChessUtils::isEnPassantMove(row, col, r, c, piece, board[r][c]);
         if (board[r][c] == ' ' && !isEnPassantCapture) {
           boardDriver->setSquareLED(r, c, LedColors::White);
@@ -217,118 +243,105 @@ bool ChessGame::tryPlayerMove(char playerColor, int& fromRow, int& fromCol, int&
             boardDriver->setSquareLED(ChessUtils::getEnPassantCapturedPawnRow(r, piece), c, LedColors::Purple);
         }
       }
-      boardDriver->showLEDs();
+    boardDriver->showLEDs();
 
-      // Wait for piece placement - handle both normal moves and captures
-      int targetRow = -1, targetCol = -1;
-      bool piecePlaced = false;
+    // Wait for piece placement - handle both normal moves and captures
+    int targetRow = -1, targetCol = -1;
+    bool piecePlaced = false;
 
-      while (!piecePlaced) {
-        boardDriver->readSensors();
+    while (!piecePlaced) {
+      boardDriver->readSensors();
 
-        // First check if the original piece was placed back
-        if (boardDriver->getSensorState(row, col)) {
-          targetRow = row;
-          targetCol = col;
-          piecePlaced = true;
-          break;
-        }
+      // First check if the original piece was placed back
+      if (boardDriver->getSensorState(row, col)) {
+        targetRow = row;
+        targetCol = col;
+        piecePlaced = true;
+        break;
+      }
 
-        // Then check all squares for a regular move or capture initiation
-        for (int r2 = 0; r2 < 8; r2++) {
-          for (int c2 = 0; c2 < 8; c2++) {
-            // Skip the original square which was already checked
-            if (r2 == row && c2 == col)
-              continue;
-
-            // Check if this would be a legal move
-            bool isLegalMove = false;
-            for (int i = 0; i < moveCount; i++)
-              if (moves[i][0] == r2 && moves[i][1] == c2) {
-                isLegalMove = true;
+      // Then check all squares for a regular move or capture initiation
+      for (int r2 = 0; r2 < 8; r2++) {
+        for (int c2 = 0; c2 < 8; c2++) {
+          // Skip the original square which was already checked
+          if (r2 == row && c2 == col)
+            continue;
+
+          // If not a legal move, no need to check further
+          if (!((destMask >> (r2 * 8 + c2)) & 1))
+            continue;
+
+          // For capture moves: detect when the target square is empty (captured piece removed)
+          // This works whether the piece was just removed or was already removed before pickup
+          bool isEnPassantCapture = ChessUtils::isEnPassantMove(row, col, r2, c2, piece, board[r2][c2]);
+          int enPassantCapturedPawnRow = ChessUtils::getEnPassantCapturedPawnRow(r2, piece);
+          auto isCapturedPiecePickedUp = [&]() -> bool {
+            if (isEnPassantCapture)
+              return !boardDriver->getSensorState(enPassantCapturedPawnRow, c2);
+            else
+              return !boardDriver->getSensorState(r2, c2);
+          };
+          if ((board[r2][c2] != ' ' || isEnPassantCapture) && isCapturedPiecePickedUp()) {
+            Serial.printf("Capture initiated at %c%d\n", (char)('a' + c2), 8 - r2);
+            // Store the target square and wait for the capturing piece to be placed there
+            targetRow = r2;
+            targetCol = c2;
+            piecePlaced = true;
+            if (isEnPassantCapture)
+              boardDriver->setSquareLED(enPassantCapturedPawnRow, c2, LedColors::Off);
+            // Blink the capture square to indicate waiting for piece placement
+            boardDriver->blinkSquare(r2, c2, LedColors::Red, 1, false);
+            // Wait for the capturing piece to be placed (or returned to origin to cancel)
+            while (!boardDriver->getSensorState(r2, c2)) {
+              boardDriver->readSensors();
+              // Allow cancellation by placing the piece back to its original position
+              if (boardDriver->getSensorState(row, col)) {
+                Serial.println("Capture cancelled");
+                targetRow = row;
+                targetCol = col;
                 break;
               }
-
-            // If not a legal move, no need to check further
-            if (!isLegalMove)
-              continue;
-
-            // For capture moves: detect when the target square is empty (captured piece removed)
-            // This works whether the piece was just removed or was already removed before pickup
-            bool isEnPassantCapture = ChessUtils::isEnPassantMove(row, col, r2, c2, piece, board[r2][c2]);
-            int enPassantCapturedPawnRow = ChessUtils::getEnPassantCapturedPawnRow(r2, piece);
-            auto isCapturedPiecePickedUp = [&]() -> bool {
-              if (isEnPassantCapture)
-                return !boardDriver->getSensorState(enPassantCapturedPawnRow, c2);
-              else
-                return !boardDriver->getSensorState(r2, c2);
-            };
-            if ((board[r2][c2] != ' ' || isEnPassantCapture) && isCapturedPiecePickedUp()) {
-              Serial.printf("Capture initiated at %c%d\n", (char)('a' + c2), 8 - r2);
-              // Store the target square and wait for the capturing piece to be placed there
-              targetRow = r2;
-              targetCol = c2;
-              piecePlaced = true;
-              if (isEnPassantCapture)
-                boardDriver->setSquareLED(enPassantCapturedPawnRow, c2, LedColors::Off);
-              // Blink the capture square to indicate waiting for piece placement
-              boardDriver->blinkSquare(r2, c2, LedColors::Red, 1, false);
-              // Wait for the capturing piece to be placed (or returned to origin to cancel)
-              while (!boardDriver->getSensorState(r2, c2)) {
-                boardDriver->readSensors();
-                // Allow cancellation by placing the piece back to its original position
-                if (boardDriver->getSensorState(row, col)) {
-                  Serial.println("Capture cancelled");
-                  targetRow = row;
-                  targetCol = col;
-                  break;
-                }
-                delay(SENSOR_READ_DELAY_MS);
-              }
-              break;
+              delay(SENSOR_READ_DELAY_MS);
             }
+            break;
+          }
 
-            // For normal non-capture moves: detect when a piece is placed on an empty square
-            if ((board[r2][c2] == ' ' && !isEnPassantCapture) && boardDriver->getSensorState(r2, c2)) {
-              targetRow = r2;
-              targetCol = c2;
-              piecePlaced = true;
-              break;
-            }
+          // For normal non-capture moves: detect when a piece is placed on an empty square
+          if ((board[r2][c2] == ' ' && !isEnPassantCapture) && boardDriver->getSensorState(r2, c2)) {
+            targetRow = r2;
+            targetCol = c2;
+            piecePlaced = true;
+            break;
           }
         }
-
-        delay(SENSOR_READ_DELAY_MS);
       }
 
-      if (targetRow == row && targetCol == col) {
-        Serial.println("Pickup cancelled");
-        boardDriver->clearAllLEDs();
-        return false;
-      }
-
-      bool legalMove = false;
-      for (int i = 0; i < moveCount; i++)
-        if (moves[i][0] == targetRow && moves[i][1] == targetCol) {
-          legalMove = true;
-          break;
-        }
+      delay(SENSOR_READ_DELAY_MS);
+    }
 
-      if (!legalMove) {
-        Serial.println("Illegal move, reverting");
-        boardDriver->clearAllLEDs();
-        return false;
-      }
+    if (targetRow == row && targetCol == col) {
+      Serial.println("Pickup cancelled");
+      boardDriver->clearAllLEDs();
+      return false;
+    }
 
-      fromRow = row;
-      fromCol = col;
-      toRow = targetRow;
-      toCol = targetCol;
+    bool legalMove = (destMask >> (targetRow * 8 + targetCol)) & 1;
 
+    if (!legalMove) {
+      Serial.println("Illegal move, reverting");
       boardDriver->clearAllLEDs();
-      return true;
+      return false;
     }
 
+    fromRow = row;
+    fromCol = col;
+    toRow = targetRow;
+    toCol = targetCol;
+
+    boardDriver->clearAllLEDs();
+    return true;
+  }
+
   return false;
 }
 
@@ -339,9 +352,15 @@ void ChessGame::advanceTurn() {
 }
 
 void ChessGame::updateGameStatus() {
+  PERF_SCOPE(PERF_UPDATE_GAME_STATUS);
   advanceTurn();
 
-  if (chessEngine->isCheckmate(board, currentTurn)) {
+  // One shared check + legal-move-existence query covers both checkmate and
+  // stalemate instead of generating the side's move set once for each
+  bool inCheck = chessEngine->isKingInCheck(board, currentTurn);
+  bool hasLegalMove = chessEngine->hasAnyLegalMove(board, currentTurn);
+
+  if (inCheck && !hasLegalMove) {
     char winnerColor = (currentTurn == 'w') ? 'b' : 'w';
     Serial.printf("CHECKMATE! %s wins!\n", ChessUtils::colorName(winnerColor));
     boardDriver->fireworkAnimation(ChessUtils::colorLed(winnerColor));
@@ -350,7 +369,7 @@ void ChessGame::updateGameStatus() {
     return;
   }
 
-  if (chessEngine->isStalemate(board, currentTurn)) {
+  if (!inCheck && !hasLegalMove) {
     Serial.println("STALEMATE! Game is a draw.");
     boardDriver->fireworkAnimation(LedColors::Cyan);
     gameOver = true;
@@ -382,7 +401,7 @@ void ChessGame::updateGameStatus() {
     return;
   }
 
-  if (chessEngine->isKingInCheck(board, currentTurn)) {
+  if (inCheck) {
     Serial.printf("%s is in CHECK!\n", ChessUtils::colorName(currentTurn));
     boardDriver->clearAllLEDs(false);
 
@@ -393,16 +412,44 @@ void ChessGame::updateGameStatus() {
   }
 
   Serial.printf("It's %s's turn !\n", ChessUtils::colorName(currentTurn));
+
+  // The move is final and the game continues: refresh the fast-resume
+  // snapshot so a power blip restores here without replaying the game
+  // (finishGame already stopped recording on the terminal paths above)
+  if (moveHistory && moveHistory->isRecording())
+    moveHistory->saveResumeSnapshot(this);
+
+  // The board is idle until the next lift — precompute the destination
+  // masks now so the lift handler doesn't pay for move generation
+  if (!replaying)
+    refreshLegalMoveCache();
+}
+
+void ChessGame::refreshLegalMoveCache() {
+  memset(legalDestMask, 0, sizeof(legalDestMask));
+  for (int row = 0; row < 8; row++)
+    for (int col = 0; col < 8; col++) {
+      char piece = board[row][col];
+      if (piece == ' ' || ChessUtils::getPieceColor(piece) != currentTurn)
+        continue;
+      int moveCount = 0;
+      int moves[28][2];
+      chessEngine->getPossibleMoves(board, row, col, moveCount, moves);
+      for (int i = 0; i < moveCount; i++)
+        legalDestMask[row][col] |= 1ULL << (moves[i][0] * 8 + moves[i][1]);
+    }
+  legalCacheValid = true;
 }
 
 void ChessGame::setBoardStateFromFEN(const String& fen) {
+  legalCacheValid = false;
   ChessUtils::fenToBoard(fen, board, currentTurn, chessEngine);
   chessEngine->recordPosition(board, currentTurn);
+  materialScore = ChessUtils::evaluatePosition(board); // Arbitrary position: reseed
   if (moveHistory && moveHistory->isRecording())
     moveHistory->addFen(fen);
-  wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
   lastUciMove = "";
-  sendUiState();
+  publishBoardState(materialScore);
   Serial.println("Board state set from FEN: " + fen);
   ChessUtils::printBoard(board);
 }
@@ -495,6 +542,7 @@ void ChessGame::applyCastling(int kingFromRow, int kingFromCol, int kingToRow, i
   // Update board state
   board[kingToRow][rookToCol] = rookPiece;
   board[kingToRow][rookFromCol] = ' ';
+  chessEngine->hashMovePiece(rookPiece, kingToRow, rookFromCol, kingToRow, rookToCol);
 
   // Skip all LED prompts and physical waits during replay
   if (replaying) return;
@@ -509,20 +557,16 @@ void ChessGame::applyCastling(int kingFromRow, int kingFromCol, int kingToRow, i
     boardDriver->showLEDs();
 
     // Wait for king to be lifted from its original square
-    while (boardDriver->getSensorState(kingFromRow, kingFromCol)) {
-      boardDriver->readSensors();
-      delay(SENSOR_READ_DELAY_MS);
-    }
+    ExpectedEdge kingLift[1] = {{(int8_t)kingFromRow, (int8_t)kingFromCol, false, nullptr}};
+    awaitEdgeSequence(kingLift, 1);
 
     // Wait for king to be placed on destination square
     boardDriver->clearAllLEDs(false);
     boardDriver->setSquareLED(kingToRow, kingToCol, LedColors::White);
     boardDriver->showLEDs();
 
-    while (!boardDriver->getSensorState(kingToRow, kingToCol)) {
-      boardDriver->readSensors();
-      delay(SENSOR_READ_DELAY_MS);
-    }
+    ExpectedEdge kingPlace[1] = {{(int8_t)kingToRow, (int8_t)kingToCol, true, nullptr}};
+    awaitEdgeSequence(kingPlace, 1);
 
     boardDriver->clearAllLEDs();
   }
@@ -536,29 +580,90 @@ void ChessGame::applyCastling(int kingFromRow, int kingFromCol, int kingToRow, i
   boardDriver->setSquareLED(kingToRow, rookToCol, LedColors::White);
   boardDriver->showLEDs();
 
-  while (boardDriver->getSensorState(kingToRow, rookFromCol)) {
-    boardDriver->readSensors();
-    delay(SENSOR_READ_DELAY_MS);
-  }
+  ExpectedEdge rookLift[1] = {{(int8_t)kingToRow, (int8_t)rookFromCol, false, nullptr}};
+  awaitEdgeSequence(rookLift, 1);
 
   // Wait for rook to be placed on destination square
   boardDriver->clearAllLEDs(false);
   boardDriver->setSquareLED(kingToRow, rookToCol, LedColors::White);
   boardDriver->showLEDs();
 
-  while (!boardDriver->getSensorState(kingToRow, rookToCol)) {
-    boardDriver->readSensors();
-    delay(SENSOR_READ_DELAY_MS);
-  }
+  ExpectedEdge rookPlace[1] = {{(int8_t)kingToRow, (int8_t)rookToCol, true, nullptr}};
+  awaitEdgeSequence(rookPlace, 1);
 
   boardDriver->clearAllLEDs();
 }
 
+void ChessGame::awaitEdgeSequence(const ExpectedEdge* steps, int count) {
+  bool done[4] = {false, false, false, false};
+  const ExpectedEdge& last = steps[count - 1];
+
+  // Edges from before the prompt went up are not part of this move
+  SensorEvent ev;
+  while (boardDriver->getSensorEvent(ev)) {
+  }
+
+  // A non-final step may already be satisfied (e.g. the captured piece came
+  // off while the move was still being announced) — seed from the debounced
+  // state rather than waiting for an edge that already happened
+  for (int i = 0; i < count - 1; i++)
+    if (boardDriver->getSensorState(steps[i].row, steps[i].col) == steps[i].present) {
+      done[i] = true;
+      if (steps[i].doneMsg)
+        Serial.println(steps[i].doneMsg);
+    }
+
+  while (true) {
+    // The final placement is judged by debounced state, not by its edge:
+    // a piece parked on the destination early (before a capture cleared)
+    // still completes the move the moment the remaining steps finish
+    bool rest = true;
+    for (int i = 0; i < count - 1; i++)
+      rest = rest && done[i];
+    if (rest && boardDriver->getSensorState(last.row, last.col) == last.present) {
+      if (last.doneMsg)
+        Serial.println(last.doneMsg);
+      return;
+    }
+
+    while (boardDriver->getSensorEvent(ev))
+      for (int i = 0; i < count - 1; i++)
+        if (!done[i] && ev.row == steps[i].row && ev.col == steps[i].col && ev.present == steps[i].present) {
+          done[i] = true;
+          if (steps[i].doneMsg)
+            Serial.println(steps[i].doneMsg);
+        }
+
+    delay(SENSOR_READ_DELAY_MS);
+  }
+}
+
 void ChessGame::confirmSquareCompletion(int row, int col) {
   boardDriver->blinkSquare(row, col, LedColors::Green, 1);
 }
 
-void ChessGame::sendUiState() {
-  String fen = ChessUtils::boardToFEN(board, currentTurn, chessEngine);
-  UIComm::sendStateUpdate(fen, lastUciMove);
+void ChessGame::publishBoardState(float evaluation) {
+  // State key: the Zobrist hash covers placement, side to move, castling and
+  // en passant; fold in the clocks, the evaluation and the last move so
+  // anything that changes the published output changes the key
+  uint64_t key = chessEngine->computeZobristHash(board, currentTurn);
+  key ^= (uint64_t)(uint32_t)chessEngine->getHalfmoveClock() * 0x9E3779B97F4A7C15ULL;
+  key ^= (uint64_t)(uint32_t)chessEngine->getFullmoveClock() * 0xC2B2AE3D27D4EB4FULL;
+  uint32_t evalBits;
+  memcpy(&evalBits, &evaluation, sizeof(evalBits));
+  key ^= (uint64_t)evalBits << 21;
+  for (size_t i = 0; i < lastUciMove.length(); i++)
+    key = (key ^ (uint8_t)lastUciMove[i]) * 0x100000001B3ULL;
+
+  // Skip the serialization and transmission when nothing changed — unless
+  // the slave asked for a resync, which must be answered with a full frame
+  if (lastPublishValid && key == lastPublishKey && !UIComm::resyncPending())
+    return;
+  lastPublishKey = key;
+  lastPublishValid = true;
+
+  char fen[ChessUtils::FEN_MAX_LEN];
+  ChessUtils::boardToFEN(board, currentTurn, chessEngine, fen, sizeof(fen));
+  wifiManager->updateBoardState(fen, evaluation);
+  UIComm::sendStateUpdate(fen, lastUciMove.c_str());
 }
\ No newline at end of file
@@ -23,6 +23,10 @@ class ChessGame {
 
   char board[8][8];
   char currentTurn; // 'w' or 'b'
+  // Material balance in pawns (positive = White advantage), maintained
+  // incrementally by applyMove so the web polling and UI slave paths never
+  // re-scan the board. Reseeded by initializeBoard / setBoardStateFromFEN.
+  float materialScore;
   bool gameOver;
   bool replaying;     // True while replaying moves during resume (suppresses LEDs and physical move waits)
   String lastUciMove; // Last move in UCI format (e.g. "e2e4") for UI slave display
@@ -39,13 +43,44 @@ class ChessGame {
   void applyMove(int fromRow, int fromCol, int toRow, int toCol, char promotion = ' ', bool isRemoteMove = false);
   bool tryPlayerMove(char playerColor, int& fromRow, int& fromCol, int& toRow, int& toCol);
   void updateGameStatus();
-  void sendUiState(); // Send current FEN + last move to UI slave display
+  // Push the current position to the web clients and the UI slave display.
+  // Builds the FEN once into a stack buffer — no heap churn per move.
+  // Gated on a state hash: redundant calls (paths that publish "just in
+  // case") cost one 64-bit compare, not a serialization and a UART frame.
+  void publishBoardState(float evaluation);
+  uint64_t lastPublishKey;
+  bool lastPublishValid;
+
+  // Legal destinations for every piece of the side to move, one 64-bit mask
+  // per square (bit row*8+col). Refreshed once per turn at the end of
+  // updateGameStatus, while the board is idle — so the lift handler lights
+  // highlight LEDs straight from a bitmap instead of running move
+  // generation and per-candidate check filtering between the lift edge and
+  // the LED frame.
+  uint64_t legalDestMask[8][8];
+  bool legalCacheValid;
+  void refreshLegalMoveCache();
 
   // Chess rule helpers
   void updateCastlingRightsAfterMove(int fromRow, int fromCol, int toRow, int toCol, char movedPiece, char capturedPiece);
   void applyCastling(int kingFromRow, int kingFromCol, int kingToRow, int kingToCol, char kingPiece, bool waitForKingCompletion = false);
   void confirmSquareCompletion(int row, int col);
 
+  // One expected debounced sensor transition in a guided physical move
+  struct ExpectedEdge {
+    int8_t row;
+    int8_t col;
+    bool present;        // false = lift/remove, true = place
+    const char* doneMsg; // Printed once the edge is observed (nullptr = silent)
+  };
+  // Block until the precomputed sequence completes on the physical board.
+  // All steps but the last may happen in any order (players differ on
+  // whether they clear a captured piece before or after lifting their own);
+  // the final placement counts only once everything else is done. The loop
+  // body consumes the sensor event queue — no engine calls, no per-square
+  // rescans.
+  void awaitEdgeSequence(const ExpectedEdge* steps, int count);
+
   // Virtual hooks for remote move handling (overridden in subclasses)
   virtual void waitForRemoteMoveCompletion(int fromRow, int fromCol, int toRow, int toCol, bool isCapture, bool isEnPassant = false, int enPassantCapturedPawnRow = -1) {}
 
@@ -58,6 +93,7 @@ class ChessGame {
   void setBoardStateFromFEN(const String& fen);
   bool isGameOver() const { return gameOver; }
   char getCurrentTurn() const { return currentTurn; }
+  float getMaterialScore() const { return materialScore; }
 
   // Resign: the resigning color loses
   void resignGame(char resigningColor);
@@ -1,11 +1,62 @@
 #include "chess_lichess.h"
 #include "chess_utils.h"
+#include "core_layout.h"
 #include "led_colors.h"
 #include "wifi_manager_esp32.h"
 #include <Arduino.h>
 
 // Dummy BotConfig for parent constructor (not used in Lichess mode)
-static BotConfig dummyBotConfig = {StockfishSettings::medium(), false};
+static BotConfig dummyBotConfig = {StockfishSettings::medium(), false, false};
+
+// ---------------------------
+// Move submission worker
+// ---------------------------
+// A slow or failed POST used to run inside the game loop, freezing sensor
+// scanning and LED feedback until it returned. Moves are queued to a
+// worker task instead: the loop continues servicing the physical board
+// immediately while the worker does the HTTPS call and retries with
+// backoff. Queue entries are plain char arrays (FreeRTOS queues copy raw
+// bytes) and the worker outlives the per-game ChessLichess object.
+
+struct PendingLichessMove {
+  char gameId[20];
+  char uci[8];
+};
+
+#define MOVE_QUEUE_LENGTH 4
+#define MOVE_SUBMIT_RETRIES 3
+
+static QueueHandle_t moveQueue = nullptr;
+static std::atomic<bool> moveSubmitFailed(false);
+
+static void moveWorkerTask(void*) {
+  PendingLichessMove m;
+  for (;;) {
+    if (xQueueReceive(moveQueue, &m, portMAX_DELAY) != pdTRUE)
+      continue;
+    bool sent = false;
+    int backoffMs = 500;
+    for (int attempt = 1; attempt <= MOVE_SUBMIT_RETRIES && !sent; attempt++) {
+      sent = LichessAPI::makeMove(m.gameId, m.uci);
+      if (!sent) {
+        Serial.printf("ERROR: Failed to send move to Lichess! Attempt %d/%d\n", attempt, MOVE_SUBMIT_RETRIES);
+        if (attempt < MOVE_SUBMIT_RETRIES) {
+          delay(backoffMs);
+          backoffMs *= 2;
+        }
+      }
+    }
+    if (!sent)
+      moveSubmitFailed.store(true);
+  }
+}
+
+static void ensureMoveWorker() {
+  if (moveQueue != nullptr)
+    return;
+  moveQueue = xQueueCreate(MOVE_QUEUE_LENGTH, sizeof(PendingLichessMove));
+  xTaskCreatePinnedToCore(moveWorkerTask, "lichess_move", 8192, nullptr, 1, nullptr, CORE_APP);
+}
 
 ChessLichess::ChessLichess(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, LichessConfig cfg)
     : ChessBot(bd, ce, wm, nullptr, dummyBotConfig),
@@ -14,7 +65,7 @@ ChessLichess::ChessLichess(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* w
       myColor('w'),
       lastKnownMoves(""),
       lastSentMove(""),
-      lastPollTime(0),
+      nextGameRequested(false),
       stopAnimation(nullptr) {}
 
 void ChessLichess::begin() {
@@ -44,72 +95,116 @@ void ChessLichess::begin() {
     return;
   }
 
+  ensureMoveWorker();
+  moveSubmitFailed.store(false);
+
   Serial.println("Logged in as: " + username);
   Serial.println("Waiting for a Lichess game to start...");
   Serial.println("Start a game on lichess.org or accept a challenge!");
   Serial.println("====================================");
 
+  multiplexer.begin();
   waitForLichessGame();
 }
 
 void ChessLichess::waitForLichessGame() {
   Serial.println("Searching for active Lichess games...");
-  std::atomic<bool>* stopAnimation = boardDriver->startWaitingAnimation();
-  LichessEvent event;
-  event.type = LichessEventType::UNKNOWN;
-  while (!gameOver) {
-    if (!LichessAPI::pollForGameEvent(event) || event.type != LichessEventType::GAME_START) {
-      delay(2000);
-      continue;
+  std::atomic<bool>* waitAnimation = boardDriver->startWaitingAnimation();
+  unsigned long lastSeed = 0;
+  while (!gameOver && !multiplexer.hasGames()) {
+    multiplexer.update();
+    // The event stream only reports games starting from now on; games
+    // already running (correspondence) come from the ongoing-games list
+    if (millis() - lastSeed >= 2000) {
+      lastSeed = millis();
+      multiplexer.seedFromOngoingGames();
     }
-    break;
+    delay(50);
   }
-  if (stopAnimation) stopAnimation->store(true);
-  currentGameId = event.gameId;
-  myColor = event.myColor;
+  if (waitAnimation) waitAnimation->store(true);
+  if (gameOver)
+    return;
+
+  multiplexer.activateFirstGame();
+  syncActiveGame();
+}
 
-  Serial.println("=== Game Found! ===");
-  Serial.println("Game ID: " + currentGameId);
+// Point the board at the multiplexer's active game: wait briefly for its
+// stream to deliver a state, pull the authoritative position from the
+// ongoing-games list, then walk the player through the piece setup.
+void ChessLichess::syncActiveGame() {
+  LichessGameSlot* slot = multiplexer.getActiveSlot();
+  if (slot == nullptr)
+    return;
+  currentGameId = slot->gameId;
+  myColor = slot->myColor;
+
+  Serial.println("=== Active game: " + currentGameId + " ===");
   Serial.printf("Playing as: %s\n", myColor == 'w' ? "White" : "Black");
 
-  // Get full game state
-  LichessGameState state;
+  // Give a freshly opened stream a moment to deliver its gameFull event
+  unsigned long deadline = millis() + 8000;
+  while (!slot->synced && millis() < deadline) {
+    multiplexer.update();
+    delay(20);
+  }
+
+  // The cached slot state covers turn and last move; the position itself
+  // comes from the ongoing-games list — one request on the shared
+  // keep-alive connection, not a reconnect cycle
+  LichessGameState state = slot->state;
   state.myColor = myColor;
   state.gameId = currentGameId;
-  state.fen = event.fen; // Use FEN from initial event as fallback
-
-  if (LichessAPI::pollGameStream(currentGameId, state)) {
-    Serial.println("Got full game state from stream");
-  } else {
-    // Fallback: Use data from the initial event
-    Serial.println("Warning: Could not get full game state, using initial event data");
-    state.gameStarted = true;
-    state.gameEnded = false;
-    state.lastMove = "";
-    // Determine turn from FEN (6th field) or assume White starts
-    if (event.fen.length() > 0) {
-      int spaceCount = 0;
-      for (size_t i = 0; i < event.fen.length(); i++) {
-        if (event.fen[i] == ' ') spaceCount++;
-        if (spaceCount == 1) {
-          state.isMyTurn = (event.fen[i + 1] == 'w' && myColor == 'w') || (event.fen[i + 1] == 'b' && myColor == 'b');
-          break;
-        }
-      }
-    } else {
-      state.isMyTurn = (myColor == 'w'); // White moves first
+  state.gameStarted = true;
+  LichessOngoingGame games[LICHESS_MAX_GAMES];
+  int count = LichessAPI::listOngoingGames(games, LICHESS_MAX_GAMES);
+  for (int i = 0; i < count; i++) {
+    if (games[i].gameId == currentGameId) {
+      state.fen = games[i].fen;
+      state.isMyTurn = games[i].isMyTurn;
+      state.lastMove = games[i].lastMove;
+      break;
     }
   }
+  // Consumed — unless the stream has already seen a move newer than the
+  // listing, which update() then applies on top of the synced position
+  slot->dirty = (slot->state.lastMove != state.lastMove);
 
   // Sync the board with the current game state
   syncBoardWithLichess(state);
+  // The synced position already contains this move — don't replay its echo
+  lastKnownMoves = state.lastMove;
+  lastSentMove = "";
 
   // Wait for board setup with the current position
   waitForBoardSetup(board);
 
   Serial.println("Board synchronized! Game starting...");
-  wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-  sendUiState();
+  publishBoardState(materialScore);
+  publishGamesList();
+}
+
+void ChessLichess::switchToGame(const String& gameId) {
+  if (gameId == currentGameId)
+    return;
+  if (!multiplexer.setActiveGame(gameId)) {
+    Serial.println("Lichess: cannot switch, unknown game " + gameId);
+    return;
+  }
+  Serial.println("Lichess: switching board to game " + gameId);
+  if (stopAnimation) {
+    stopAnimation->store(true);
+    stopAnimation = nullptr;
+  }
+  syncActiveGame();
+}
+
+void ChessLichess::publishGamesList() {
+  JsonDocument doc;
+  multiplexer.fillGamesJSON(doc);
+  String json;
+  serializeJson(doc, json);
+  wifiManager->updateLichessGames(json);
 }
 
 void ChessLichess::syncBoardWithLichess(const LichessGameState& state) {
@@ -134,11 +229,40 @@ void ChessLichess::update() {
   if (gameOver)
     return;
 
+  // A failed background submission ends the game, as the old blocking
+  // retry loop did
+  if (moveSubmitFailed.load()) {
+    moveSubmitFailed.store(false);
+    Serial.println("ERROR: All attempts to send move to Lichess failed, ending game!");
+    boardDriver->flashBoardAnimation(LedColors::Red);
+    multiplexer.close();
+    gameOver = true;
+    return;
+  }
+
   boardDriver->readSensors();
 
   // Check for physical resign/draw gesture (both kings lifted)
   if (checkPhysicalResignOrDraw()) return;
 
+  // Game-switch requests: from the web UI (by game id) or the UI slave
+  // (cycle to the next ongoing game)
+  String switchId;
+  if (wifiManager->getPendingLichessSwitch(switchId)) {
+    wifiManager->clearPendingLichessSwitch();
+    switchToGame(switchId);
+    return;
+  }
+  if (nextGameRequested) {
+    nextGameRequested = false;
+    String next = multiplexer.nextGameId();
+    if (next.length() > 0) {
+      switchToGame(next);
+      return;
+    }
+    Serial.println("Lichess: no other ongoing game to switch to");
+  }
+
   int fromRow, fromCol, toRow, toCol;
   char promotion = ' ';
 
@@ -152,9 +276,8 @@ void ChessLichess::update() {
     if (isPromotion)
       promotion = tolower(board[toRow][toCol]);
     updateGameStatus();
-    wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-    sendUiState();
-    // Then send move to Lichess (blocking)
+    publishBoardState(materialScore);
+    // Then hand the move to the submission worker (non-blocking)
     sendMoveToLichess(fromRow, fromCol, toRow, toCol, promotion);
     boardDriver->updateSensorPrev();
   }
@@ -163,18 +286,15 @@ void ChessLichess::update() {
   if (currentTurn != myColor && stopAnimation == nullptr && !gameOver)
     stopAnimation = boardDriver->startThinkingAnimation();
 
-  // Polling interval check
-  if ((currentTurn == myColor) || millis() - lastPollTime < POLL_INTERVAL_MS) {
-    boardDriver->updateSensorPrev();
-    return;
-  }
-  lastPollTime = millis();
+  // Pump every stream each tick (reconnects are rate-limited inside) —
+  // opponent moves on the active game arrive within a network round trip,
+  // background games just refresh their cached state
+  multiplexer.update();
+  if (multiplexer.consumeListChanged())
+    publishGamesList();
 
-  // Remote player's turn - poll Lichess for updates
   LichessGameState state;
-  state.myColor = myColor;
-  state.gameId = currentGameId;
-  if (LichessAPI::pollGameStream(currentGameId, state)) {
+  if (multiplexer.consumeActiveUpdate(state)) {
     if (state.gameEnded) {
       Serial.println("Game ended! Status: " + state.status);
       if (state.winner.length() > 0)
@@ -187,7 +307,16 @@ void ChessLichess::update() {
         boardDriver->fireworkAnimation(LedColors::Cyan);
       else
         boardDriver->fireworkAnimation(ChessUtils::colorLed((state.winner == "white") ? 'w' : 'b'));
-      gameOver = true;
+      multiplexer.removeGame(currentGameId);
+      // Other games still running? Rotate the board onto the next one
+      String next = multiplexer.activateFirstGame();
+      if (next.length() > 0) {
+        Serial.println("Lichess: continuing with game " + next);
+        syncActiveGame();
+      } else {
+        gameOver = true;
+        multiplexer.close();
+      }
       return;
     }
     // Check if there's a new move
@@ -206,8 +335,7 @@ void ChessLichess::update() {
           Serial.printf("Lichess UCI move: %s = (%d,%d) -> (%d,%d)%s%c\n", state.lastMove.c_str(), fromRow, fromCol, toRow, toCol, promotion == ' ' ? "" : " Promotion to: ", promotion);
           applyMove(fromRow, fromCol, toRow, toCol, promotion, true);
           updateGameStatus();
-          wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-          sendUiState();
+          publishBoardState(materialScore);
         } else {
           Serial.println("Failed to parse Lichess UCI move: " + state.lastMove);
         }
@@ -219,29 +347,19 @@ void ChessLichess::update() {
 
 void ChessLichess::sendMoveToLichess(int fromRow, int fromCol, int toRow, int toCol, char promotion) {
   String uciMove = ChessUtils::toUCIMove(fromRow, fromCol, toRow, toCol, promotion);
-  Serial.println("Sending move to Lichess: " + uciMove);
+  Serial.println("Queueing move for Lichess: " + uciMove);
 
   // Track this move so we don't process it as a remote move when it echoes back
   lastSentMove = uciMove;
 
-  // Retry up to 3 times if sending fails
-  const int maxRetries = 3;
-  int attempt = 0;
-  bool sent = false;
-  while (attempt < maxRetries && !sent) {
-    if (LichessAPI::makeMove(currentGameId, uciMove)) {
-      sent = true;
-      break;
-    } else {
-      Serial.printf("ERROR: Failed to send move to Lichess! Attempt %d/%d\n", attempt + 1, maxRetries);
-      delay(500);
-      attempt++;
-    }
-  }
-  if (!sent) {
-    gameOver = true;
-    Serial.println("ERROR: All attempts to send move to Lichess failed, ending game!");
-    boardDriver->flashBoardAnimation(LedColors::Red);
-    lastSentMove = "";
+  PendingLichessMove m = {};
+  strlcpy(m.gameId, currentGameId.c_str(), sizeof(m.gameId));
+  strlcpy(m.uci, uciMove.c_str(), sizeof(m.uci));
+  if (xQueueSend(moveQueue, &m, 0) != pdTRUE) {
+    // Queue full should never happen (one outstanding move per turn) —
+    // fall back to sending inline rather than dropping the move
+    Serial.println("Move queue full, sending inline");
+    if (!LichessAPI::makeMove(currentGameId, uciMove))
+      moveSubmitFailed.store(true);
   }
 }
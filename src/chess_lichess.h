@@ -3,6 +3,7 @@
 
 #include "chess_bot.h"
 #include "lichess_api.h"
+#include "lichess_multiplexer.h"
 #include <atomic>
 
 // Lichess game configuration
@@ -21,9 +22,9 @@ class ChessLichess : public ChessBot {
   // Track last move we sent to avoid processing it as remote move
   String lastSentMove;
 
-  // Polling state
-  unsigned long lastPollTime;
-  static const unsigned long POLL_INTERVAL_MS = 500;
+  // All ongoing games on the account; the active one drives the board
+  LichessMultiplexer multiplexer;
+  volatile bool nextGameRequested; // Set from the UI slave touch handler
 
   // Animation stop flag for remote turn thinking animation
   std::atomic<bool>* stopAnimation;
@@ -31,12 +32,20 @@ class ChessLichess : public ChessBot {
   // Game flow
   void waitForLichessGame();
   void syncBoardWithLichess(const LichessGameState& state);
+  // Sync the board to the multiplexer's active game (after activation or a
+  // switch); blocks on waitForBoardSetup like the initial game start does
+  void syncActiveGame();
+  void switchToGame(const String& gameId);
+  void publishGamesList();
   void sendMoveToLichess(int fromRow, int fromCol, int toRow, int toCol, char promotion = ' ');
 
  public:
   ChessLichess(BoardDriver* bd, ChessEngine* ce, WiFiManagerESP32* wm, LichessConfig cfg);
   void begin() override;
   void update() override;
+
+  // Rotate the board to the next ongoing game (UI slave button)
+  void requestNextGame() { nextGameRequested = true; }
 };
 
 #endif // CHESS_LICHESS_H
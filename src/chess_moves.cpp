@@ -15,11 +15,12 @@ void ChessMoves::begin() {
     replaying = true;
     moveHistory->replayIntoGame(this);
     replaying = false;
-    wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-    sendUiState();
+    publishBoardState(materialScore);
   } else {
     moveHistory->startGame(GAME_MODE_CHESS_MOVES);
-    moveHistory->addFen(ChessUtils::boardToFEN(board, currentTurn, chessEngine));
+    char fen[ChessUtils::FEN_MAX_LEN];
+    ChessUtils::boardToFEN(board, currentTurn, chessEngine, fen, sizeof(fen));
+    moveHistory->addFen(fen);
   }
   waitForBoardSetup(board);
 }
@@ -34,8 +35,7 @@ void ChessMoves::update() {
   if (tryPlayerMove(currentTurn, fromRow, fromCol, toRow, toCol)) {
     applyMove(fromRow, fromCol, toRow, toCol);
     updateGameStatus();
-    wifiManager->updateBoardState(ChessUtils::boardToFEN(board, currentTurn, chessEngine), ChessUtils::evaluatePosition(board));
-    sendUiState();
+    publishBoardState(materialScore);
   }
 
   boardDriver->updateSensorPrev();
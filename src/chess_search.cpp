@@ -0,0 +1,593 @@
+#include "chess_search.h"
+#include "bitboards.h"
+#include "core_layout.h"
+#include "transposition_table.h"
+#include "zobrist_keys.h"
+#include <Arduino.h>
+#include <string.h>
+
+// ---------------------------
+// Evaluation tables
+// ---------------------------
+// Material values in centipawns, indexed like Bitboards::pieceIndex modulo 6
+// (P, N, B, R, Q, K). The king has no material value; king safety comes from
+// its piece-square table.
+static const int PIECE_VALUE[6] = {100, 320, 330, 500, 900, 0};
+
+// Piece-square tables from White's perspective, row 0 = rank 8 (same board
+// orientation as the mailbox). Black pieces use the vertically mirrored
+// square. Values are small midgame nudges on top of material: pawns and
+// minors toward the centre, king tucked behind its pawns.
+static const int8_t PST_PAWN[64] PROGMEM = {
+    0,  0,  0,   0,   0,   0,   0,  0,  //
+    50, 50, 50,  50,  50,  50,  50, 50, //
+    10, 10, 20,  30,  30,  20,  10, 10, //
+    5,  5,  10,  25,  25,  10,  5,  5,  //
+    0,  0,  0,   20,  20,  0,   0,  0,  //
+    5,  -5, -10, 0,   0,   -10, -5, 5,  //
+    5,  10, 10,  -20, -20, 10,  10, 5,  //
+    0,  0,  0,   0,   0,   0,   0,  0};
+
+static const int8_t PST_KNIGHT[64] PROGMEM = {
+    -50, -40, -30, -30, -30, -30, -40, -50, //
+    -40, -20, 0,   0,   0,   0,   -20, -40, //
+    -30, 0,   10,  15,  15,  10,  0,   -30, //
+    -30, 5,   15,  20,  20,  15,  5,   -30, //
+    -30, 0,   15,  20,  20,  15,  0,   -30, //
+    -30, 5,   10,  15,  15,  10,  5,   -30, //
+    -40, -20, 0,   5,   5,   0,   -20, -40, //
+    -50, -40, -30, -30, -30, -30, -40, -50};
+
+static const int8_t PST_BISHOP[64] PROGMEM = {
+    -20, -10, -10, -10, -10, -10, -10, -20, //
+    -10, 0,   0,   0,   0,   0,   0,   -10, //
+    -10, 0,   5,   10,  10,  5,   0,   -10, //
+    -10, 5,   5,   10,  10,  5,   5,   -10, //
+    -10, 0,   10,  10,  10,  10,  0,   -10, //
+    -10, 10,  10,  10,  10,  10,  10,  -10, //
+    -10, 5,   0,   0,   0,   0,   5,   -10, //
+    -20, -10, -10, -10, -10, -10, -10, -20};
+
+static const int8_t PST_ROOK[64] PROGMEM = {
+    0,  0,  0,  0,  0,  0,  0,  0,  //
+    5,  10, 10, 10, 10, 10, 10, 5,  //
+    -5, 0,  0,  0,  0,  0,  0,  -5, //
+    -5, 0,  0,  0,  0,  0,  0,  -5, //
+    -5, 0,  0,  0,  0,  0,  0,  -5, //
+    -5, 0,  0,  0,  0,  0,  0,  -5, //
+    -5, 0,  0,  0,  0,  0,  0,  -5, //
+    0,  0,  0,  5,  5,  0,  0,  0};
+
+static const int8_t PST_QUEEN[64] PROGMEM = {
+    -20, -10, -10, -5, -5, -10, -10, -20, //
+    -10, 0,   0,   0,  0,  0,   0,   -10, //
+    -10, 0,   5,   5,  5,  5,   0,   -10, //
+    -5,  0,   5,   5,  5,  5,   0,   -5,  //
+    0,   0,   5,   5,  5,  5,   0,   -5,  //
+    -10, 5,   5,   5,  5,  5,   0,   -10, //
+    -10, 0,   5,   0,  0,  0,   0,   -10, //
+    -20, -10, -10, -5, -5, -10, -10, -20};
+
+static const int8_t PST_KING[64] PROGMEM = {
+    -30, -40, -40, -50, -50, -40, -40, -30, //
+    -30, -40, -40, -50, -50, -40, -40, -30, //
+    -30, -40, -40, -50, -50, -40, -40, -30, //
+    -30, -40, -40, -50, -50, -40, -40, -30, //
+    -20, -30, -30, -40, -40, -30, -30, -20, //
+    -10, -20, -20, -20, -20, -20, -20, -10, //
+    20,  20,  0,   0,   0,   0,   20,  20,  //
+    20,  30,  10,  0,   0,   10,  30,  20};
+
+static const int8_t* const PST[6] = {PST_PAWN, PST_KNIGHT, PST_BISHOP, PST_ROOK, PST_QUEEN, PST_KING};
+
+// Mate scores within this margin of SEARCH_SCORE_MATE are ply-adjusted when
+// stored in / loaded from the transposition table so "mate in N from here"
+// stays correct regardless of the ply the entry was created at
+#define SEARCH_MATE_THRESHOLD (SEARCH_SCORE_MATE - 2 * SEARCH_MAX_PLY)
+
+static inline int16_t scoreToTT(int score, int ply) {
+  if (score > SEARCH_MATE_THRESHOLD)
+    return (int16_t)(score + ply);
+  if (score < -SEARCH_MATE_THRESHOLD)
+    return (int16_t)(score - ply);
+  return (int16_t)score;
+}
+
+static inline int scoreFromTT(int16_t score, int ply) {
+  if (score > SEARCH_MATE_THRESHOLD)
+    return score - ply;
+  if (score < -SEARCH_MATE_THRESHOLD)
+    return score + ply;
+  return score;
+}
+
+// The two root workers publish their best (score, root index) as a single
+// 32-bit word so one compare-exchange replaces both together: the score,
+// biased to unsigned, sits in the high bits so numeric comparison orders by
+// score; the root move index sits in the low byte (MAX_LEGAL_MOVES < 255)
+#define ROOT_IDX_NONE 0xFF
+
+static inline uint32_t packBest(int score, int idx) {
+  return ((uint32_t)(score + SEARCH_SCORE_INF) << 8) | (uint32_t)(idx & 0xFF);
+}
+
+static inline int packedScore(uint32_t packed) {
+  return (int)(packed >> 8) - SEARCH_SCORE_INF;
+}
+
+static inline int packedIdx(uint32_t packed) {
+  uint32_t idx = packed & 0xFF;
+  return idx == ROOT_IDX_NONE ? -1 : (int)idx;
+}
+
+ChessSearch::ChessSearch(ChessEngine* ce) : engine(ce), tt(nullptr), searchHash(0), deadline(0), nodes(0), aborted(false), helperEngine(nullptr), helper(nullptr), stopShared(false), stopFlag(nullptr) {}
+
+ChessSearch::~ChessSearch() {
+  delete helper;
+  delete helperEngine;
+}
+
+// Full-board hash for the search root. Unlike ChessEngine::computeZobristHash
+// this hashes the en-passant file unconditionally: positions differing only
+// in an unusable ep right get distinct keys, which costs a missed TT hit but
+// can never return a wrong score.
+uint64_t ChessSearch::computeSearchHash(char sideToMove) const {
+  uint64_t hash = 0;
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      int idx = Bitboards::pieceIndex(searchBoard[row][col]);
+      if (idx >= 0)
+        hash ^= ZOBRIST_TABLE[idx][row * 8 + col];
+    }
+  }
+  hash ^= ZOBRIST_CASTLING[engine->getCastlingRights()];
+  int epRow, epCol;
+  engine->getEnPassantTarget(epRow, epCol);
+  if (epRow >= 0)
+    hash ^= ZOBRIST_EN_PASSANT[epCol];
+  if (sideToMove == 'b')
+    hash ^= ZOBRIST_SIDE_TO_MOVE;
+  return hash;
+}
+
+bool ChessSearch::timeUp() {
+  // Only hit millis() (and the cross-core stop flag) every 512 nodes to
+  // keep the hot path cheap; a worker that aborts raises the shared flag so
+  // its peer stops within its own next 512 nodes
+  if ((++nodes & 511) == 0) {
+    if (millis() >= deadline || (stopFlag != nullptr && *stopFlag)) {
+      aborted = true;
+      if (stopFlag != nullptr)
+        *stopFlag = true;
+    }
+  }
+  return aborted;
+}
+
+int ChessSearch::evaluate(char sideToMove) const {
+  int score = 0; // From White's perspective
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      char piece = searchBoard[row][col];
+      if (piece == ' ')
+        continue;
+      int idx = Bitboards::pieceIndex(piece);
+      if (idx < 0)
+        continue;
+      int type = idx % 6;
+      if (idx < 6)
+        score += PIECE_VALUE[type] + PST[type][row * 8 + col];
+      else
+        score -= PIECE_VALUE[type] + PST[type][(7 - row) * 8 + col];
+    }
+  }
+  return (sideToMove == 'w') ? score : -score;
+}
+
+int ChessSearch::moveOrderScore(const EngineMove& m) const {
+  char mover = searchBoard[m.fromRow][m.fromCol];
+  char victim = searchBoard[m.toRow][m.toCol];
+  int score = 0;
+  // MVV-LVA: prefer capturing the biggest victim with the smallest attacker
+  if (victim != ' ')
+    score = 16 * PIECE_VALUE[Bitboards::pieceIndex(victim) % 6] - PIECE_VALUE[Bitboards::pieceIndex(mover) % 6];
+  // Promotions are effectively winning a queen
+  if ((mover == 'P' && m.toRow == 0) || (mover == 'p' && m.toRow == 7))
+    score += 16 * PIECE_VALUE[4];
+  return score;
+}
+
+void ChessSearch::orderMoves(MoveList& list) const {
+  // Insertion sort by descending order score; lists are short and mostly
+  // quiet moves with score 0, so this stays cheap
+  int scores[MAX_LEGAL_MOVES];
+  for (int i = 0; i < list.count; i++)
+    scores[i] = moveOrderScore(list.moves[i]);
+  for (int i = 1; i < list.count; i++) {
+    EngineMove m = list.moves[i];
+    int s = scores[i];
+    int j = i - 1;
+    while (j >= 0 && scores[j] < s) {
+      list.moves[j + 1] = list.moves[j];
+      scores[j + 1] = scores[j];
+      j--;
+    }
+    list.moves[j + 1] = m;
+    scores[j + 1] = s;
+  }
+}
+
+void ChessSearch::makeMove(const EngineMove& m, SearchUndo& undo) {
+  undo.castlingRights = engine->getCastlingRights();
+  engine->getEnPassantTarget(undo.epRow, undo.epCol);
+  undo.hash = searchHash;
+
+  char piece = searchBoard[m.fromRow][m.fromCol];
+  undo.movedPiece = piece;
+  undo.capturedPiece = searchBoard[m.toRow][m.toCol];
+  undo.capturedRow = m.toRow;
+  undo.capturedCol = m.toCol;
+  undo.castling = false;
+
+  bool isPawn = (piece == 'P' || piece == 'p');
+
+  // En passant: a pawn moving diagonally onto an empty square. The legal
+  // move generator only emits this when it really is en passant.
+  if (isPawn && undo.capturedPiece == ' ' && m.fromCol != m.toCol) {
+    undo.capturedRow = m.fromRow;
+    undo.capturedCol = m.toCol;
+    undo.capturedPiece = searchBoard[m.fromRow][m.toCol];
+    searchBoard[m.fromRow][m.toCol] = ' ';
+  }
+
+  // Search always promotes to a queen; underpromotions are never best at
+  // these depths and pruning them keeps the tree smaller
+  char placed = piece;
+  if (piece == 'P' && m.toRow == 0)
+    placed = 'Q';
+  else if (piece == 'p' && m.toRow == 7)
+    placed = 'q';
+  searchBoard[m.toRow][m.toCol] = placed;
+  searchBoard[m.fromRow][m.fromCol] = ' ';
+
+  // Castling as a compound move
+  if ((piece == 'K' || piece == 'k') && (m.toCol - m.fromCol == 2 || m.toCol - m.fromCol == -2)) {
+    int rookFromCol = (m.toCol > m.fromCol) ? 7 : 0;
+    int rookToCol = (m.toCol > m.fromCol) ? 5 : 3;
+    char rookPiece = (piece == 'k') ? 'r' : 'R';
+    searchBoard[m.toRow][rookToCol] = rookPiece;
+    searchBoard[m.toRow][rookFromCol] = ' ';
+    undo.castling = true;
+    undo.rookRow = m.toRow;
+    undo.rookFromCol = rookFromCol;
+    undo.rookToCol = rookToCol;
+    undo.rookPiece = rookPiece;
+  }
+
+  // Castling rights update (same rule as ChessGame::updateCastlingRightsAfterMove)
+  uint8_t rights = undo.castlingRights;
+  if (piece == 'K')
+    rights &= ~(0x01 | 0x02);
+  else if (piece == 'k')
+    rights &= ~(0x04 | 0x08);
+  if (piece == 'R') {
+    if (m.fromRow == 7 && m.fromCol == 7) rights &= ~0x01;
+    if (m.fromRow == 7 && m.fromCol == 0) rights &= ~0x02;
+  } else if (piece == 'r') {
+    if (m.fromRow == 0 && m.fromCol == 7) rights &= ~0x04;
+    if (m.fromRow == 0 && m.fromCol == 0) rights &= ~0x08;
+  }
+  if (undo.capturedPiece == 'R') {
+    if (m.toRow == 7 && m.toCol == 7) rights &= ~0x01;
+    if (m.toRow == 7 && m.toCol == 0) rights &= ~0x02;
+  } else if (undo.capturedPiece == 'r') {
+    if (m.toRow == 0 && m.toCol == 7) rights &= ~0x04;
+    if (m.toRow == 0 && m.toCol == 0) rights &= ~0x08;
+  }
+  engine->setCastlingRights(rights);
+
+  // Double pawn push opens an en passant target for the reply
+  bool newEp = isPawn && (m.fromRow - m.toRow == 2 || m.toRow - m.fromRow == 2);
+  if (newEp)
+    engine->setEnPassantTarget((m.fromRow + m.toRow) / 2, m.fromCol);
+  else
+    engine->clearEnPassantTarget();
+
+  // Incremental hash update (piece XORs, castling, ep file, side to move)
+  searchHash ^= ZOBRIST_TABLE[Bitboards::pieceIndex(piece)][m.fromRow * 8 + m.fromCol];
+  searchHash ^= ZOBRIST_TABLE[Bitboards::pieceIndex(placed)][m.toRow * 8 + m.toCol];
+  if (undo.capturedPiece != ' ')
+    searchHash ^= ZOBRIST_TABLE[Bitboards::pieceIndex(undo.capturedPiece)][undo.capturedRow * 8 + undo.capturedCol];
+  if (undo.castling) {
+    searchHash ^= ZOBRIST_TABLE[Bitboards::pieceIndex(undo.rookPiece)][undo.rookRow * 8 + undo.rookFromCol];
+    searchHash ^= ZOBRIST_TABLE[Bitboards::pieceIndex(undo.rookPiece)][undo.rookRow * 8 + undo.rookToCol];
+  }
+  if (rights != undo.castlingRights)
+    searchHash ^= ZOBRIST_CASTLING[undo.castlingRights] ^ ZOBRIST_CASTLING[rights];
+  if (undo.epRow >= 0)
+    searchHash ^= ZOBRIST_EN_PASSANT[undo.epCol];
+  if (newEp)
+    searchHash ^= ZOBRIST_EN_PASSANT[m.fromCol];
+  searchHash ^= ZOBRIST_SIDE_TO_MOVE;
+}
+
+void ChessSearch::unmakeMove(const EngineMove& m, const SearchUndo& undo) {
+  searchBoard[m.toRow][m.toCol] = ' ';
+  searchBoard[m.fromRow][m.fromCol] = undo.movedPiece;
+  if (undo.capturedPiece != ' ')
+    searchBoard[undo.capturedRow][undo.capturedCol] = undo.capturedPiece;
+  if (undo.castling) {
+    searchBoard[undo.rookRow][undo.rookFromCol] = undo.rookPiece;
+    searchBoard[undo.rookRow][undo.rookToCol] = ' ';
+  }
+  engine->setCastlingRights(undo.castlingRights);
+  if (undo.epRow >= 0)
+    engine->setEnPassantTarget(undo.epRow, undo.epCol);
+  else
+    engine->clearEnPassantTarget();
+  searchHash = undo.hash;
+}
+
+int ChessSearch::quiescence(int alpha, int beta, char sideToMove, int ply) {
+  if (timeUp())
+    return 0;
+
+  int standPat = evaluate(sideToMove);
+  if (standPat >= beta || ply >= SEARCH_MAX_PLY)
+    return standPat;
+  if (standPat > alpha)
+    alpha = standPat;
+
+  MoveList list;
+  engine->getAllLegalMoves(searchBoard, sideToMove, list);
+  if (list.count == 0)
+    return engine->isKingInCheck(searchBoard, sideToMove) ? -(SEARCH_SCORE_MATE - ply) : 0;
+  orderMoves(list);
+
+  char opponent = (sideToMove == 'w') ? 'b' : 'w';
+  for (int i = 0; i < list.count; i++) {
+    const EngineMove& m = list.moves[i];
+    char mover = searchBoard[m.fromRow][m.fromCol];
+    bool isCapture = searchBoard[m.toRow][m.toCol] != ' ' ||
+                     ((mover == 'P' || mover == 'p') && m.fromCol != m.toCol);
+    bool isPromotion = (mover == 'P' && m.toRow == 0) || (mover == 'p' && m.toRow == 7);
+    if (!isCapture && !isPromotion)
+      continue; // Only captures and promotions past the horizon
+
+    SearchUndo undo;
+    makeMove(m, undo);
+    int score = -quiescence(-beta, -alpha, opponent, ply + 1);
+    unmakeMove(m, undo);
+    if (aborted)
+      return 0;
+
+    if (score >= beta)
+      return score;
+    if (score > alpha)
+      alpha = score;
+  }
+  return alpha;
+}
+
+int ChessSearch::alphaBeta(int depth, int alpha, int beta, char sideToMove, int ply) {
+  if (timeUp())
+    return 0;
+  if (depth <= 0 || ply >= SEARCH_MAX_PLY)
+    return quiescence(alpha, beta, sideToMove, ply);
+
+  // Transposition table probe: return a cached score when it was computed at
+  // sufficient depth and its bound actually cuts this window
+  int alphaOrig = alpha;
+  TTEntry tte;
+  bool haveTT = false;
+  if (tt != nullptr && tt->probe(searchHash, tte)) {
+    haveTT = true;
+    if ((int)tte.depth >= depth) {
+      int s = scoreFromTT(tte.score, ply);
+      if (tte.bound == TT_BOUND_EXACT)
+        return s;
+      if (tte.bound == TT_BOUND_LOWER && s >= beta)
+        return s;
+      if (tte.bound == TT_BOUND_UPPER && s <= alpha)
+        return s;
+    }
+  }
+
+  MoveList list;
+  engine->getAllLegalMoves(searchBoard, sideToMove, list);
+  if (list.count == 0)
+    return engine->isKingInCheck(searchBoard, sideToMove) ? -(SEARCH_SCORE_MATE - ply) : 0;
+  orderMoves(list);
+
+  // Try the remembered best move first; it usually causes the cutoff
+  if (haveTT) {
+    for (int i = 1; i < list.count; i++) {
+      if (list.moves[i].fromRow == tte.move.fromRow && list.moves[i].fromCol == tte.move.fromCol && list.moves[i].toRow == tte.move.toRow && list.moves[i].toCol == tte.move.toCol) {
+        EngineMove ttMove = list.moves[i];
+        for (int j = i; j > 0; j--)
+          list.moves[j] = list.moves[j - 1];
+        list.moves[0] = ttMove;
+        break;
+      }
+    }
+  }
+
+  char opponent = (sideToMove == 'w') ? 'b' : 'w';
+  int best = -SEARCH_SCORE_INF;
+  EngineMove bestMove = list.moves[0];
+  for (int i = 0; i < list.count; i++) {
+    SearchUndo undo;
+    makeMove(list.moves[i], undo);
+    int score = -alphaBeta(depth - 1, -beta, -alpha, opponent, ply + 1);
+    unmakeMove(list.moves[i], undo);
+    if (aborted)
+      return 0;
+
+    if (score > best) {
+      best = score;
+      bestMove = list.moves[i];
+    }
+    if (score > alpha)
+      alpha = score;
+    if (alpha >= beta)
+      break; // Beta cutoff
+  }
+
+  if (tt != nullptr && !aborted) {
+    uint8_t bound = (best <= alphaOrig) ? TT_BOUND_UPPER : ((best >= beta) ? TT_BOUND_LOWER : TT_BOUND_EXACT);
+    tt->store(searchHash, depth, scoreToTT(best, ply), bound, bestMove);
+  }
+  return best;
+}
+
+// Drain root moves from the shared queue, each searched with the window
+// opened at the best score either worker has published so far. Runs on the
+// calling task and, through rootWorkerTask, on the helper.
+void ChessSearch::searchRoot(RootJob& job) {
+  char opponent = (job.sideToMove == 'w') ? 'b' : 'w';
+  while (!aborted) {
+    int i = job.nextIdx.fetch_add(1);
+    if (i >= job.root->count)
+      break;
+
+    int alpha = packedScore(job.best.load());
+    SearchUndo undo;
+    makeMove(job.root->moves[i], undo);
+    int score = -alphaBeta(job.depth - 1, -SEARCH_SCORE_INF, -alpha, opponent, 1);
+    unmakeMove(job.root->moves[i], undo);
+    if (aborted)
+      break; // Partial score, don't publish
+
+    // Publish if strictly better (or first); the CAS loop settles the race
+    // when both workers finish a root move at once
+    uint32_t cur = job.best.load();
+    while (score > packedScore(cur) || packedIdx(cur) < 0) {
+      if (job.best.compare_exchange_weak(cur, packBest(score, i)))
+        break;
+    }
+
+    // The helper shares core and priority with the LED animation worker:
+    // hand over the timeslice between root moves so an animation frame
+    // never waits out a full tick. A no-op for the calling task.
+    taskYIELD();
+  }
+}
+
+void ChessSearch::rootWorkerTask(void* param) {
+  RootJob* job = (RootJob*)param;
+  job->worker->searchRoot(*job);
+  job->helperDone.store(true); // Last touch of the caller's stack frame
+  vTaskDelete(nullptr);
+}
+
+SearchResult ChessSearch::findBestMove(const char board[8][8], char sideToMove, uint32_t timeBudgetMs, int maxDepth) {
+  SearchResult result;
+  result.promotion = ' ';
+  result.scoreCp = 0;
+  result.depthReached = 0;
+  result.nodes = 0;
+  result.valid = false;
+
+  memcpy(searchBoard, board, sizeof(searchBoard));
+  searchHash = computeSearchHash(sideToMove);
+  deadline = millis() + timeBudgetMs;
+  nodes = 0;
+  aborted = false;
+  if (tt != nullptr)
+    tt->newSearch();
+
+  // The search shares the engine's castling/en-passant state; snapshot it so
+  // the game sees it untouched afterwards
+  uint8_t savedRights = engine->getCastlingRights();
+  int savedEpRow, savedEpCol;
+  engine->getEnPassantTarget(savedEpRow, savedEpCol);
+
+  MoveList root;
+  engine->getAllLegalMoves(searchBoard, sideToMove, root);
+  if (root.count == 0)
+    return result;
+  orderMoves(root);
+
+  stopShared = false;
+  stopFlag = &stopShared;
+  if (helper == nullptr && root.count > 1) {
+    helperEngine = new ChessEngine();
+    helper = new ChessSearch(helperEngine);
+    helper->stopFlag = &stopShared;
+  }
+  if (helper != nullptr) {
+    // The helper searches the same root position from its own engine state;
+    // make/unmake restores it, so one setup covers all iterations
+    helper->tt = tt;
+    memcpy(helper->searchBoard, searchBoard, sizeof(searchBoard));
+    helper->searchHash = searchHash;
+    helper->deadline = deadline;
+    helper->nodes = 0;
+    helper->aborted = false;
+    helperEngine->setCastlingRights(savedRights);
+    if (savedEpRow >= 0)
+      helperEngine->setEnPassantTarget(savedEpRow, savedEpCol);
+    else
+      helperEngine->clearEnPassantTarget();
+  }
+
+  for (int depth = 1; depth <= maxDepth && !aborted; depth++) {
+    RootJob job;
+    job.worker = helper;
+    job.root = &root;
+    job.depth = depth;
+    job.sideToMove = sideToMove;
+    job.nextIdx.store(0);
+    job.best.store(packBest(-SEARCH_SCORE_INF, ROOT_IDX_NONE));
+    job.helperDone.store(true);
+
+    // Split the root across both cores: the helper worker takes moves from
+    // the same queue while this task searches its share. Priority 1 puts it
+    // beside AnimWorker; searchRoot yields to it between root moves.
+    bool spawned = false;
+    if (helper != nullptr && root.count > 1) {
+      job.helperDone.store(false);
+      spawned = xTaskCreatePinnedToCore(rootWorkerTask, "SearchWorker", 12288, &job, 1, nullptr, CORE_REALTIME) == pdPASS;
+      if (!spawned)
+        job.helperDone.store(true); // Out of memory for the task: search this depth alone
+    }
+
+    searchRoot(job);
+    while (!job.helperDone.load())
+      vTaskDelay(1);
+    if (spawned && helper->aborted)
+      aborted = true; // The helper ran out of time mid-move; this depth is partial
+
+    uint32_t packed = job.best.load();
+    int bestIdx = packedIdx(packed);
+    int alpha = packedScore(packed);
+
+    if (bestIdx >= 0 && (!aborted || result.depthReached == 0)) {
+      result.bestMove = root.moves[bestIdx];
+      char mover = searchBoard[result.bestMove.fromRow][result.bestMove.fromCol];
+      result.promotion = ((mover == 'P' && result.bestMove.toRow == 0) || (mover == 'p' && result.bestMove.toRow == 7)) ? 'q' : ' ';
+      result.scoreCp = alpha;
+      result.depthReached = depth;
+      result.valid = true;
+
+      // Search the previous best first on the next iteration
+      EngineMove best = root.moves[bestIdx];
+      for (int i = bestIdx; i > 0; i--)
+        root.moves[i] = root.moves[i - 1];
+      root.moves[0] = best;
+
+      // No point deepening once a forced mate is found
+      if (alpha >= SEARCH_SCORE_MATE - SEARCH_MAX_PLY || alpha <= -(SEARCH_SCORE_MATE - SEARCH_MAX_PLY))
+        break;
+    }
+  }
+
+  engine->setCastlingRights(savedRights);
+  if (savedEpRow >= 0)
+    engine->setEnPassantTarget(savedEpRow, savedEpCol);
+  else
+    engine->clearEnPassantTarget();
+
+  result.nodes = nodes + (helper != nullptr ? helper->nodes : 0);
+  return result;
+}
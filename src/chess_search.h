@@ -0,0 +1,110 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include "chess_engine.h"
+#include <atomic>
+#include <stdint.h>
+
+// ---------------------------
+// On-device search engine
+// ---------------------------
+// Iterative-deepening alpha-beta with quiescence over ChessEngine's move
+// generator. Used as the offline bot and as the fallback when the Stockfish
+// API is unreachable. Scores are centipawns from the side to move's
+// perspective (negamax convention).
+//
+// The root is searched on both cores: each depth iteration, a helper worker
+// task on the realtime core pulls root moves from the same queue as the
+// calling task, sharing the transposition table (lock-free, see
+// transposition_table.h) and the published best score as its alpha. The
+// helper runs at the LED animation worker's priority and yields to it
+// between root moves, so piece animations stay smooth while the bot thinks.
+
+#define SEARCH_SCORE_INF 32000
+#define SEARCH_SCORE_MATE 30000
+#define SEARCH_MAX_PLY 32
+
+class TranspositionTable;
+struct TTEntry;
+
+struct SearchResult {
+  EngineMove bestMove;
+  char promotion;   // 'q' when the best move promotes, ' ' otherwise
+  int scoreCp;      // Centipawns from the searched side's perspective
+  int depthReached; // Deepest fully completed iteration
+  uint32_t nodes;
+  bool valid;
+};
+
+class ChessSearch {
+ public:
+  explicit ChessSearch(ChessEngine* ce);
+  ~ChessSearch();
+
+  // Search `board` with `sideToMove` to move, stopping when the time budget
+  // expires or maxDepth completes. The engine's castling/en-passant state is
+  // used during the search and restored exactly before returning.
+  SearchResult findBestMove(const char board[8][8], char sideToMove, uint32_t timeBudgetMs, int maxDepth);
+
+  // Optional transposition table (shared cache of search results). The
+  // search runs fine without one, just slower.
+  void setTranspositionTable(TranspositionTable* t) { tt = t; }
+
+ private:
+  // Everything needed to take back one search move, including the engine
+  // state the move clobbered (castling rights, en passant target)
+  struct SearchUndo {
+    char movedPiece;
+    char capturedPiece;
+    int capturedRow, capturedCol; // Differs from the target square for en passant
+    bool castling;
+    int rookRow, rookFromCol, rookToCol;
+    char rookPiece;
+    uint8_t castlingRights;
+    int epRow, epCol;
+    uint64_t hash; // Search hash before the move (restored on unmake)
+  };
+
+  // One depth iteration's work queue, shared by the calling task and the
+  // helper worker. Lives on the caller's stack; the helper signals
+  // helperDone before exiting so the frame outlives the task.
+  struct RootJob {
+    ChessSearch* worker;  // The helper's search instance (its own engine)
+    const MoveList* root; // Read-only during the iteration
+    int depth;
+    char sideToMove;
+    std::atomic<int> nextIdx;   // Next unclaimed root move
+    std::atomic<uint32_t> best; // Best (score, index) packed into one word
+    std::atomic<bool> helperDone;
+  };
+
+  ChessEngine* engine;
+  TranspositionTable* tt;
+  char searchBoard[8][8];
+  uint64_t searchHash; // Zobrist hash of searchBoard, updated incrementally
+  unsigned long deadline;
+  uint32_t nodes;
+  bool aborted;
+
+  // The helper cannot share the lead's ChessEngine: makeMove/unmakeMove go
+  // through its castling and en-passant state, so each worker owns one.
+  // Both are created lazily on the first parallel search.
+  ChessEngine* helperEngine;
+  ChessSearch* helper;
+  volatile bool stopShared; // Raised by whichever worker aborts first
+  volatile bool* stopFlag;  // Both workers point at the lead's stopShared
+
+  uint64_t computeSearchHash(char sideToMove) const;
+  void searchRoot(RootJob& job);
+  static void rootWorkerTask(void* param);
+  void makeMove(const EngineMove& m, SearchUndo& undo);
+  void unmakeMove(const EngineMove& m, const SearchUndo& undo);
+  int alphaBeta(int depth, int alpha, int beta, char sideToMove, int ply);
+  int quiescence(int alpha, int beta, char sideToMove, int ply);
+  int evaluate(char sideToMove) const;
+  void orderMoves(MoveList& list) const;
+  int moveOrderScore(const EngineMove& m) const;
+  bool timeUp();
+};
+
+#endif // CHESS_SEARCH_H
@@ -39,8 +39,14 @@ uint8_t ChessUtils::castlingRightsFromString(const String& rightsStr) {
   return rights;
 }
 
-String ChessUtils::boardToFEN(const char board[8][8], char currentTurn, ChessEngine* chessEngine) {
-  String fen = "";
+size_t ChessUtils::boardToFEN(const char board[8][8], char currentTurn, ChessEngine* chessEngine, char* out, size_t cap) {
+  if (out == nullptr || cap == 0)
+    return 0;
+  const size_t last = cap - 1; // Reserve room for the terminator
+  size_t n = 0;
+  auto put = [&](char c) {
+    if (n < last) out[n++] = c;
+  };
 
   // Board position - FEN expects rank 8 (Black pieces) first, rank 1 (White pieces) last
   // Our array: row 0 = rank 8 (Black), row 7 = rank 1 (White)
@@ -52,61 +58,68 @@ String ChessUtils::boardToFEN(const char board[8][8], char currentTurn, ChessEng
         emptyCount++;
       } else {
         if (emptyCount > 0) {
-          fen += String(emptyCount);
+          put((char)('0' + emptyCount));
           emptyCount = 0;
         }
-        fen += board[row][col];
+        put(board[row][col]);
       }
     if (emptyCount > 0)
-      fen += String(emptyCount);
+      put((char)('0' + emptyCount));
     if (row < 7)
-      fen += "/";
+      put('/');
   }
 
   // Active color
-  fen += " " + String(currentTurn);
+  put(' ');
+  put(currentTurn);
 
   // Castling availability
-  if (chessEngine != nullptr)
-    fen += " " + ChessUtils::castlingRightsToString(chessEngine->getCastlingRights());
-  else
-    fen += " KQkq";
+  put(' ');
+  uint8_t rights = (chessEngine != nullptr) ? chessEngine->getCastlingRights() : 0x0F;
+  if (rights == 0) {
+    put('-');
+  } else {
+    if (rights & 0x01) put('K');
+    if (rights & 0x02) put('Q');
+    if (rights & 0x04) put('k');
+    if (rights & 0x08) put('q');
+  }
 
   // En passant target square
+  put(' ');
   if (chessEngine != nullptr && chessEngine->hasEnPassantTarget()) {
     int epRow, epCol;
     chessEngine->getEnPassantTarget(epRow, epCol);
     // Convert row/col to algebraic notation (e.g., e3, e6)
-    char file = 'a' + epCol;
-    int rank = 8 - epRow;
-    fen += " " + String(file) + String(rank);
+    put((char)('a' + epCol));
+    put((char)('0' + (8 - epRow)));
   } else {
-    fen += " -";
+    put('-');
   }
 
-  // Halfmove clock
-  if (chessEngine != nullptr)
-    fen += " " + String(chessEngine->getHalfmoveClock());
-  else
-    fen += " 0";
+  // Halfmove clock and fullmove number
+  char clocks[16];
+  int len = snprintf(clocks, sizeof(clocks), " %d %d",
+                     (chessEngine != nullptr) ? chessEngine->getHalfmoveClock() : 0,
+                     (chessEngine != nullptr) ? chessEngine->getFullmoveClock() : 1);
+  for (int i = 0; i < len; i++)
+    put(clocks[i]);
 
-  // Fullmove number
-  if (chessEngine != nullptr)
-    fen += " " + String(chessEngine->getFullmoveClock());
-  else
-    fen += " 1";
+  out[n] = '\0';
+  return n;
+}
 
-  return fen;
+String ChessUtils::boardToFEN(const char board[8][8], char currentTurn, ChessEngine* chessEngine) {
+  char fen[FEN_MAX_LEN];
+  boardToFEN(board, currentTurn, chessEngine, fen, sizeof(fen));
+  return String(fen);
 }
 
-void ChessUtils::fenToBoard(const String& fen, char board[8][8], char& currentTurn, ChessEngine* chessEngine) {
+void ChessUtils::fenToBoard(const char* fen, char board[8][8], char& currentTurn, ChessEngine* chessEngine) {
   // Parse FEN string and update board state
   // FEN format: "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
-
-  // Split FEN into parts
-  int firstSpace = fen.indexOf(' ');
-  String boardPart = (firstSpace > 0) ? fen.substring(0, firstSpace) : fen;
-  String remainingParts = (firstSpace > 0) ? fen.substring(firstSpace + 1) : "";
+  if (fen == nullptr)
+    fen = "";
 
   // Clear board
   for (int row = 0; row < 8; row++)
@@ -119,17 +132,16 @@ void ChessUtils::fenToBoard(const String& fen, char board[8][8], char& currentTu
   int row = 0; // Start with rank 8 (row 0 in our array)
   int col = 0;
 
-  for (size_t i = 0; i < boardPart.length() && row < 8; i++) {
-    char c = boardPart.charAt(i);
-
+  const char* p = fen;
+  for (; *p != '\0' && *p != ' ' && row < 8; p++) {
+    char c = *p;
     if (c == '/') {
       // Next rank
       row++;
       col = 0;
     } else if (c >= '1' && c <= '8') {
       // Empty squares
-      int emptyCount = c - '0';
-      col += emptyCount;
+      col += c - '0';
     } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
       // Piece
       if (row >= 0 && row < 8 && col >= 0 && col < 8) {
@@ -141,60 +153,71 @@ void ChessUtils::fenToBoard(const String& fen, char board[8][8], char& currentTu
   if (chessEngine != nullptr)
     chessEngine->reset();
 
+  // Walk the remaining space-separated fields in place
+  auto nextField = [&]() {
+    while (*p != '\0' && *p != ' ') p++;
+    while (*p == ' ') p++;
+  };
+  nextField();
+
   // Parse active color
-  if (remainingParts.length() > 0) {
-    int secondSpace = remainingParts.indexOf(' ');
-    String activeColor = (secondSpace > 0) ? remainingParts.substring(0, secondSpace) : remainingParts;
-    currentTurn = (activeColor == "w" || activeColor == "W") ? 'w' : 'b';
-    remainingParts = (secondSpace > 0) ? remainingParts.substring(secondSpace + 1) : "";
+  if (*p != '\0') {
+    currentTurn = (*p == 'w' || *p == 'W') ? 'w' : 'b';
+    nextField();
   }
 
   // Parse castling rights
-  if (remainingParts.length() > 0) {
-    int thirdSpace = remainingParts.indexOf(' ');
+  if (*p != '\0') {
+    uint8_t rights = 0;
+    for (const char* r = p; *r != '\0' && *r != ' '; r++) {
+      switch (*r) {
+        case 'K': rights |= 0x01; break;
+        case 'Q': rights |= 0x02; break;
+        case 'k': rights |= 0x04; break;
+        case 'q': rights |= 0x08; break;
+        default: break;
+      }
+    }
     if (chessEngine != nullptr)
-      chessEngine->setCastlingRights(castlingRightsFromString((thirdSpace > 0) ? remainingParts.substring(0, thirdSpace) : remainingParts));
-    remainingParts = (thirdSpace > 0) ? remainingParts.substring(thirdSpace + 1) : "";
+      chessEngine->setCastlingRights(rights);
+    nextField();
   }
 
   // Parse en passant target square
-  if (remainingParts.length() > 0) {
-    int fourthSpace = remainingParts.indexOf(' ');
-    String enPassantSquare = (fourthSpace > 0) ? remainingParts.substring(0, fourthSpace) : remainingParts;
-
-    if (enPassantSquare != "-" && enPassantSquare.length() >= 2) {
+  if (*p != '\0') {
+    if (*p != '-' && p[1] != '\0') {
       // Parse algebraic notation (e.g., "e3", "e6")
-      char file = enPassantSquare.charAt(0);
-      char rankChar = enPassantSquare.charAt(1);
-
+      char file = p[0];
+      char rankChar = p[1];
       if (file >= 'a' && file <= 'h' && rankChar >= '1' && rankChar <= '8') {
         int epCol = file - 'a';
-        int rank = rankChar - '0';
-        int epRow = 8 - rank;
+        int epRow = 8 - (rankChar - '0');
         if (chessEngine != nullptr)
           chessEngine->setEnPassantTarget(epRow, epCol);
       }
     }
-    remainingParts = (fourthSpace > 0) ? remainingParts.substring(fourthSpace + 1) : "";
+    nextField();
   }
 
   // Parse halfmove clock
-  if (remainingParts.length() > 0) {
-    int fifthSpace = remainingParts.indexOf(' ');
-    String halfmoveStr = (fifthSpace > 0) ? remainingParts.substring(0, fifthSpace) : remainingParts;
+  if (*p != '\0') {
     if (chessEngine != nullptr)
-      chessEngine->setHalfmoveClock(halfmoveStr.toInt());
-    remainingParts = (fifthSpace > 0) ? remainingParts.substring(fifthSpace + 1) : "";
+      chessEngine->setHalfmoveClock(atoi(p));
+    nextField();
   }
 
   // Parse fullmove number
-  if (remainingParts.length() > 0) {
-    int fullmove = remainingParts.toInt();
+  if (*p != '\0') {
+    int fullmove = atoi(p);
     if (chessEngine != nullptr)
       chessEngine->setFullmoveClock(fullmove > 0 ? fullmove : 1);
   }
 }
 
+void ChessUtils::fenToBoard(const String& fen, char board[8][8], char& currentTurn, ChessEngine* chessEngine) {
+  fenToBoard(fen.c_str(), board, currentTurn, chessEngine);
+}
+
 void ChessUtils::printBoard(const char board[8][8]) {
   Serial.println("====== BOARD ======");
   for (int row = 0; row < 8; row++) {
@@ -210,46 +233,38 @@ void ChessUtils::printBoard(const char board[8][8]) {
   Serial.println("===================");
 }
 
+float ChessUtils::signedPieceValue(char piece) {
+  float value;
+  switch (tolower(piece)) {
+    case 'p':
+      value = 1.0f;
+      break; // Pawn
+    case 'n':
+      value = 3.0f;
+      break; // Knight
+    case 'b':
+      value = 3.0f;
+      break; // Bishop
+    case 'r':
+      value = 5.0f;
+      break; // Rook
+    case 'q':
+      value = 9.0f;
+      break; // Queen
+    default:
+      return 0.0f; // King (not counted) or empty square
+  }
+  return (piece >= 'A' && piece <= 'Z') ? value : -value;
+}
+
 float ChessUtils::evaluatePosition(const char board[8][8]) {
   // Simple material evaluation
   // Positive = White advantage, negative = Black advantage
   float evaluation = 0.0f;
 
   for (int row = 0; row < 8; row++)
-    for (int col = 0; col < 8; col++) {
-      char piece = board[row][col];
-      float value = 0.0f;
-
-      // Get piece value (uppercase = White, lowercase = Black)
-      switch (tolower(piece)) {
-        case 'p':
-          value = 1.0f;
-          break; // Pawn
-        case 'n':
-          value = 3.0f;
-          break; // Knight
-        case 'b':
-          value = 3.0f;
-          break; // Bishop
-        case 'r':
-          value = 5.0f;
-          break; // Rook
-        case 'q':
-          value = 9.0f;
-          break; // Queen
-        case 'k':
-          value = 0.0f;
-          break; // King (not counted)
-        default:
-          continue; // Empty square
-      }
-
-      // Add to evaluation (positive for White, negative for Black)
-      if (piece >= 'A' && piece <= 'Z')
-        evaluation += value; // White piece
-      else if (piece >= 'a' && piece <= 'z')
-        evaluation -= value; // Black piece
-    }
+    for (int col = 0; col < 8; col++)
+      evaluation += signedPieceValue(board[row][col]);
 
   return evaluation;
 }
@@ -46,24 +46,42 @@ class ChessUtils {
   static String castlingRightsToString(uint8_t rights);
   static uint8_t castlingRightsFromString(const String& rightsStr);
 
-  // Convert board state to FEN notation
+  // Buffer size for the zero-allocation FEN variants: a complete FEN is at
+  // most ~90 characters including the terminator
+  static const size_t FEN_MAX_LEN = 96;
+
+  // Convert board state to FEN notation into a caller-supplied buffer.
+  // This is the hot path — FENs regenerate on every move and every state
+  // push, and the String variant's per-square concatenation churns the heap.
   // board: 8x8 array representing the chess board
   // currentTurn: 'w' for White's turn, 'b' for Black's turn
   // chessEngine: ChessEngine pointer to get castling rights and en passant target square
-  // Returns: FEN string representation
+  // out/cap: destination buffer (at least FEN_MAX_LEN bytes); always
+  //          NUL-terminated, truncated if cap is too small
+  // Returns: number of characters written (excluding the terminator)
+  static size_t boardToFEN(const char board[8][8], char currentTurn, ChessEngine* chessEngine, char* out, size_t cap);
+
+  // String convenience wrapper around the buffer variant above
   static String boardToFEN(const char board[8][8], char currentTurn, ChessEngine* chessEngine = nullptr);
 
-  // Parse FEN notation and update board state
+  // Parse FEN notation and update board state (allocation-free)
   // fen: FEN string to parse
   // board: 8x8 array to update with parsed position
   // currentTurn: output parameter for whose turn it is - 'w' or 'b' (optional)
   // chessEngine: ChessEngine pointer to set castling rights and en passant target square
+  static void fenToBoard(const char* fen, char board[8][8], char& currentTurn, ChessEngine* chessEngine = nullptr);
+
+  // String convenience wrapper around the parser above
   static void fenToBoard(const String& fen, char board[8][8], char& currentTurn, ChessEngine* chessEngine = nullptr);
 
   // Print current board state to Serial for debugging
   // board: 8x8 array representing the chess board
   static void printBoard(const char board[8][8]);
 
+  // Material value of a single piece in pawns, signed by color
+  // (positive for White pieces, negative for Black, 0 for kings/empty)
+  static float signedPieceValue(char piece);
+
   // Evaluate board position using simple material count
   // Returns evaluation in pawns (positive = White advantage, negative = Black advantage)
   // Pawn=1, Knight=3, Bishop=3, Rook=5, Queen=9
@@ -0,0 +1,34 @@
+#ifndef CORE_LAYOUT_H
+#define CORE_LAYOUT_H
+
+// ---------------------------
+// Dual-core task layout
+//
+// The two ESP32 cores are split by latency class, not by subsystem:
+//
+//   CORE_REALTIME (core 1): everything a player can feel — sensor matrix
+//     scanning and debouncing (SensorScan), the LED framebuffer and
+//     animations (AnimWorker), and the UART event task for the UI slave
+//     link (pinned via ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE in
+//     platformio.ini). Nothing on this core ever touches the network or
+//     the filesystem.
+//
+//   CORE_APP (core 0): the application loop (game mode updates, web
+//     server callbacks, hint requests), bot thinking and Lichess workers,
+//     MoveHistory finalization, and OTA flashing. The Arduino framework
+//     pins the WiFi/lwip stack here too, which is why realtime work gets
+//     the other core: a TLS handshake or flash write can stall this core
+//     for seconds without moving a single sensor or LED deadline.
+//
+// The cores communicate through the existing queues and flags: the sensor
+// event queue and debounced-state snapshot (board_driver), the animation
+// job queues, and the volatile UI-touch flags in main.cpp.
+//
+// Note: setup() and the idle loop() still run on the default loopTask
+// (core 1); main.cpp hands the application loop to a task on CORE_APP
+// before loop() first runs.
+// ---------------------------
+#define CORE_REALTIME 1
+#define CORE_APP 0
+
+#endif // CORE_LAYOUT_H
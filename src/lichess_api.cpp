@@ -1,4 +1,5 @@
 #include "lichess_api.h"
+#include "wifi_manager_esp32.h"
 #include <ArduinoJson.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
@@ -6,6 +7,32 @@
 // Static member initialization
 String LichessAPI::apiToken = "";
 
+// ---------------------------
+// Persistent keep-alive connection
+// ---------------------------
+// WiFiClientSecure gives no access to the mbedTLS session, so genuine TLS
+// session-ID/ticket resumption can't be enabled from the Arduino layer.
+// The handshake cost is avoided another way: one connection is held open
+// across API calls with HTTP keep-alive, so during a game only the first
+// call (and the first after a WiFi drop) pays the full handshake.
+// Streamed endpoints are excluded — they are framed by the connection
+// itself and get a throwaway socket.
+
+static WiFiClientSecure apiClient;
+static unsigned long lastRequestMs = 0;
+static SemaphoreHandle_t httpMutex = nullptr;
+
+// Reconnect proactively once the server has likely dropped the idle socket
+#define LICHESS_KEEPALIVE_IDLE_MS 55000UL
+
+static bool connectionUsable() {
+  return apiClient.connected() && (millis() - lastRequestMs) < LICHESS_KEEPALIVE_IDLE_MS;
+}
+
+void LichessAPI::closeConnection() {
+  apiClient.stop();
+}
+
 void LichessAPI::setToken(const String& token) {
   apiToken = token;
 }
@@ -18,32 +45,18 @@ bool LichessAPI::hasToken() {
   return apiToken.length() > 0;
 }
 
-String LichessAPI::makeHttpRequest(const String& method, const String& path, const String& body) {
+// One-shot request on a throwaway connection, reading only the first burst
+// of data. Used for streamed endpoints, where getGameState only wants the
+// opening NDJSON event and the stream would otherwise never end.
+static String oneShotRequest(const String& request) {
   WiFiClientSecure client;
   client.setInsecure(); // For simplicity; in production, use proper cert validation
 
-  if (!client.connect(LICHESS_API_HOST, LICHESS_API_PORT)) {
+  if (!WiFiManagerESP32::connectWithDnsCache(client, LICHESS_API_HOST, LICHESS_API_PORT)) {
     Serial.println("Lichess API: Connection failed");
     return "";
   }
 
-  // Build HTTP request
-  String request = method + " " + path + " HTTP/1.1\r\n";
-  request += "Host: " LICHESS_API_HOST "\r\n";
-  request += "Authorization: Bearer " + apiToken + "\r\n";
-  request += "Accept: application/json\r\n";
-
-  if (body.length() > 0) {
-    request += "Content-Type: application/x-www-form-urlencoded\r\n";
-    request += "Content-Length: " + String(body.length()) + "\r\n";
-  }
-
-  request += "Connection: close\r\n\r\n";
-
-  if (body.length() > 0) {
-    request += body;
-  }
-
   client.print(request);
 
   // Wait for response
@@ -76,71 +89,137 @@ String LichessAPI::makeHttpRequest(const String& method, const String& path, con
   return response;
 }
 
-bool LichessAPI::verifyToken(String& username) {
-  String response = makeHttpRequest("GET", "/api/account");
-  if (response.length() == 0) {
-    return false;
-  }
-
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, response);
-  if (error) {
-    Serial.println("Lichess API: JSON parse error in verifyToken");
-    return false;
+// Read one complete response body off the shared connection. Since the
+// socket stays open, the end of the body is found via Content-Length or by
+// decoding chunked encoding rather than by waiting for the peer to close.
+static String readResponseBody(unsigned long timeoutMs) {
+  unsigned long deadline = millis() + timeoutMs;
+  String headers = "";
+  while (!headers.endsWith("\r\n\r\n")) {
+    if (millis() > deadline)
+      return "";
+    if (apiClient.available()) {
+      headers += (char)apiClient.read();
+    } else if (!apiClient.connected()) {
+      return "";
+    } else {
+      delay(10);
+    }
   }
 
-  if (doc.containsKey("username")) {
-    username = doc["username"].as<String>();
-    Serial.println("Lichess API: Verified token for user: " + username);
-    return true;
+  String lowerHeaders = headers;
+  lowerHeaders.toLowerCase();
+  String body = "";
+
+  if (lowerHeaders.indexOf("transfer-encoding: chunked") != -1) {
+    while (millis() < deadline) {
+      long chunkSize = strtol(apiClient.readStringUntil('\n').c_str(), nullptr, 16);
+      if (chunkSize <= 0)
+        break;
+      while (chunkSize > 0 && millis() < deadline) {
+        if (apiClient.available()) {
+          body += (char)apiClient.read();
+          chunkSize--;
+        } else if (!apiClient.connected()) {
+          return "";
+        } else {
+          delay(2);
+        }
+      }
+      apiClient.readStringUntil('\n'); // CRLF closing the chunk
+    }
+    apiClient.readStringUntil('\n'); // CRLF after the final zero chunk
+  } else {
+    int contentLength = -1;
+    int clPos = lowerHeaders.indexOf("content-length:");
+    if (clPos != -1)
+      contentLength = lowerHeaders.substring(clPos + 15).toInt();
+    if (contentLength < 0) {
+      // No framing — the server closes to end the body (old behaviour)
+      while (millis() < deadline && (apiClient.connected() || apiClient.available())) {
+        while (apiClient.available())
+          body += (char)apiClient.read();
+        if (!apiClient.connected())
+          break;
+        delay(10);
+      }
+      apiClient.stop();
+      return body;
+    }
+    body.reserve(contentLength);
+    while ((int)body.length() < contentLength) {
+      if (millis() > deadline)
+        return "";
+      if (apiClient.available()) {
+        body += (char)apiClient.read();
+      } else if (!apiClient.connected()) {
+        return "";
+      } else {
+        delay(2);
+      }
+    }
   }
 
-  return false;
+  if (lowerHeaders.indexOf("connection: close") != -1)
+    apiClient.stop();
+  return body;
 }
 
-bool LichessAPI::pollForGameEvent(LichessEvent& event) {
-  // Check for currently playing games first
-  WiFiClientSecure client;
-  client.setInsecure();
-
-  if (!client.connect(LICHESS_API_HOST, LICHESS_API_PORT)) {
-    return false;
-  }
+String LichessAPI::makeHttpRequest(const String& method, const String& path, const String& body) {
+  bool streaming = path.indexOf("/stream/") != -1;
 
-  // Use the /api/account/playing endpoint to get current games
-  String request = "GET /api/account/playing HTTP/1.1\r\n";
+  // Build HTTP request
+  String request = method + " " + path + " HTTP/1.1\r\n";
   request += "Host: " LICHESS_API_HOST "\r\n";
   request += "Authorization: Bearer " + apiToken + "\r\n";
   request += "Accept: application/json\r\n";
-  request += "Connection: close\r\n\r\n";
 
-  client.print(request);
+  if (body.length() > 0) {
+    request += "Content-Type: application/x-www-form-urlencoded\r\n";
+    request += "Content-Length: " + String(body.length()) + "\r\n";
+  }
 
-  unsigned long timeout = millis() + 10000;
-  while (client.connected() && !client.available()) {
-    if (millis() > timeout) {
-      client.stop();
-      return false;
-    }
-    delay(10);
+  request += streaming ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+
+  if (body.length() > 0) {
+    request += body;
   }
 
-  String response = "";
-  bool headersDone = false;
+  if (streaming)
+    return oneShotRequest(request);
 
-  while (client.available()) {
-    String line = client.readStringUntil('\n');
-    if (!headersDone) {
-      if (line == "\r" || line.length() == 0) {
-        headersDone = true;
+  if (httpMutex == nullptr)
+    httpMutex = xSemaphoreCreateMutex();
+  xSemaphoreTake(httpMutex, portMAX_DELAY);
+
+  // Two attempts: a reused socket may have been closed by the server since
+  // the last call — reconnect fresh and send again
+  String response = "";
+  for (int attempt = 0; attempt < 2 && response.length() == 0; attempt++) {
+    if (!connectionUsable()) {
+      apiClient.stop();
+      apiClient.setInsecure(); // For simplicity; in production, use proper cert validation
+      if (!WiFiManagerESP32::connectWithDnsCache(apiClient, LICHESS_API_HOST, LICHESS_API_PORT)) {
+        Serial.println("Lichess API: Connection failed");
+        continue;
       }
-    } else {
-      response += line;
     }
+    apiClient.print(request);
+    response = readResponseBody(10000);
+    if (response.length() == 0)
+      apiClient.stop();
+    else
+      lastRequestMs = millis();
   }
 
-  client.stop();
+  xSemaphoreGive(httpMutex);
+  if (response.length() == 0)
+    Serial.println("Lichess API: Request timeout");
+  return response;
+}
 
+bool LichessAPI::verifyToken(String& username) {
+  String response = makeHttpRequest("GET", "/api/account");
   if (response.length() == 0) {
     return false;
   }
@@ -148,138 +227,71 @@ bool LichessAPI::pollForGameEvent(LichessEvent& event) {
   JsonDocument doc;
   DeserializationError error = deserializeJson(doc, response);
   if (error) {
+    Serial.println("Lichess API: JSON parse error in verifyToken");
     return false;
   }
 
-  JsonArray games = doc["nowPlaying"].as<JsonArray>();
-  if (games.size() > 0) {
-    // Get the first active game
-    JsonObject game = games[0];
-    event.type = LichessEventType::GAME_START;
-    event.gameId = game["gameId"].as<String>();
-    event.fen = game["fen"].as<String>();
-
-    String color = game["color"].as<String>();
-    event.myColor = (color == "white") ? 'w' : 'b';
-
-    Serial.println("Lichess: Found active game: " + event.gameId);
+  if (doc.containsKey("username")) {
+    username = doc["username"].as<String>();
+    Serial.println("Lichess API: Verified token for user: " + username);
     return true;
   }
 
   return false;
 }
 
-bool LichessAPI::getGameState(const String& gameId, LichessGameState& state) {
-  String response = makeHttpRequest("GET", "/api/board/game/stream/" + gameId);
+int LichessAPI::listOngoingGames(LichessOngoingGame games[], int maxGames) {
+  // This polls every few seconds while waiting for a game, so it rides the
+  // shared keep-alive connection.
+  String response = makeHttpRequest("GET", "/api/account/playing");
   if (response.length() == 0) {
-    return false;
+    return 0;
   }
 
-  // The stream returns multiple JSON objects, we need the first "gameFull" event
-  int newlinePos = response.indexOf('\n');
-  String firstLine = (newlinePos > 0) ? response.substring(0, newlinePos) : response;
-
-  return parseGameFullEvent(firstLine, state);
-}
-
-bool LichessAPI::pollGameStream(const String& gameId, LichessGameState& state) {
-  WiFiClientSecure client;
-  client.setInsecure();
-
-  if (!client.connect(LICHESS_API_HOST, LICHESS_API_PORT)) {
-    return false;
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, response);
+  if (error) {
+    return 0;
   }
 
-  String request = "GET /api/board/game/stream/" + gameId + " HTTP/1.1\r\n";
-  request += "Host: " LICHESS_API_HOST "\r\n";
-  request += "Authorization: Bearer " + apiToken + "\r\n";
-  request += "Accept: application/x-ndjson\r\n";
-  request += "Connection: close\r\n\r\n";
-
-  client.print(request);
-
-  unsigned long timeout = millis() + 15000;
-  bool headersDone = false;
-  String jsonLine = "";
-  bool foundData = false;
-  bool isChunked = false;
-
-  while (client.connected() || client.available()) {
-    if (millis() > timeout) {
+  int count = 0;
+  for (JsonObject game : doc["nowPlaying"].as<JsonArray>()) {
+    if (count >= maxGames)
       break;
-    }
-
-    if (client.available()) {
-      String line = client.readStringUntil('\n');
-
-      // Check for chunked transfer encoding in headers
-      if (!headersDone) {
-        String lowerLine = line;
-        lowerLine.toLowerCase();
-        if (lowerLine.indexOf("transfer-encoding: chunked") >= 0) {
-          isChunked = true;
-        }
-      }
-
-      line.trim();
-
-      if (!headersDone) {
-        if (line.length() == 0) {
-          headersDone = true;
-        }
-        continue;
-      }
-
-      // Skip empty lines (keep-alive)
-      if (line.length() == 0) {
-        continue;
-      }
-
-      // If chunked encoding, skip chunk size lines (hex numbers)
-      if (isChunked) {
-        // Check if this is a chunk size (hex number)
-        bool isChunkSize = true;
-        for (size_t i = 0; i < line.length(); i++) {
-          char c = line[i];
-          if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-            isChunkSize = false;
-            break;
-          }
-        }
-        if (isChunkSize && line.length() <= 8) {
-          continue; // Skip chunk size line
-        }
-      }
-
-      // Must start with '{' to be valid JSON
-      if (line[0] != '{') {
-        continue;
-      }
-
-      jsonLine = line;
-      foundData = true;
-      break; // Got one event, process it
-    }
-
-    delay(10);
+    games[count].gameId = game["gameId"].as<String>();
+    games[count].fen = game["fen"].as<String>();
+    games[count].lastMove = game["lastMove"].as<String>();
+    games[count].opponent = game["opponent"]["username"].as<String>();
+    games[count].myColor = (game["color"].as<String>() == "black") ? 'b' : 'w';
+    games[count].isMyTurn = game["isMyTurn"].as<bool>();
+    count++;
   }
+  return count;
+}
 
-  client.stop();
+bool LichessAPI::pollForGameEvent(LichessEvent& event) {
+  LichessOngoingGame game;
+  if (listOngoingGames(&game, 1) < 1)
+    return false;
+  event.type = LichessEventType::GAME_START;
+  event.gameId = game.gameId;
+  event.fen = game.fen;
+  event.myColor = game.myColor;
+  Serial.println("Lichess: Found active game: " + event.gameId);
+  return true;
+}
 
-  if (!foundData || jsonLine.length() == 0) {
-    Serial.println("Lichess: No JSON data received from game stream");
+bool LichessAPI::getGameState(const String& gameId, LichessGameState& state) {
+  String response = makeHttpRequest("GET", "/api/board/game/stream/" + gameId);
+  if (response.length() == 0) {
     return false;
   }
 
-  Serial.println("Lichess: Game stream JSON: " + jsonLine.substring(0, min((size_t)200, jsonLine.length())));
-
-  // Try to parse as gameFull first, then as gameState
-  if (parseGameFullEvent(jsonLine, state)) {
-    return true;
-  }
+  // The stream returns multiple JSON objects, we need the first "gameFull" event
+  int newlinePos = response.indexOf('\n');
+  String firstLine = (newlinePos > 0) ? response.substring(0, newlinePos) : response;
 
-  Serial.println("Lichess: parseGameFullEvent failed, trying parseGameStateEvent");
-  return parseGameStateEvent(jsonLine, state);
+  return parseGameFullEvent(firstLine, state);
 }
 
 // Parse a space-separated UCI moves string into a move count and the last move.
@@ -38,6 +38,18 @@ struct LichessEvent {
   char myColor; // 'w' or 'b'
 };
 
+// One entry of GET /api/account/playing. Carries the current FEN and turn,
+// so pointing the board at any ongoing game costs one request on the shared
+// keep-alive connection rather than a stream reconnect.
+struct LichessOngoingGame {
+  String gameId;
+  String fen;
+  String lastMove;
+  String opponent;
+  char myColor; // 'w' or 'b'
+  bool isMyTurn;
+};
+
 class LichessAPI {
  public:
   // Set the API token (Personal Access Token)
@@ -52,12 +64,15 @@ class LichessAPI {
   // Returns true if a new game event was found
   static bool pollForGameEvent(LichessEvent& event);
 
+  // List all currently ongoing games (up to maxGames). Returns the count.
+  static int listOngoingGames(LichessOngoingGame games[], int maxGames);
+
   // Get current game state
   static bool getGameState(const String& gameId, LichessGameState& state);
 
-  // Stream game state (for ongoing game updates)
-  // Returns true if there's new state data
-  static bool pollGameStream(const String& gameId, LichessGameState& state);
+  // Event parsers (also fed by LichessStream with incremental NDJSON lines)
+  static bool parseGameFullEvent(const String& json, LichessGameState& state);
+  static bool parseGameStateEvent(const String& json, LichessGameState& state);
 
   // Make a move in the current game
   // move: UCI format (e.g., "e2e4", "e7e8q" for promotion)
@@ -66,11 +81,12 @@ class LichessAPI {
   // Resign the game
   static bool resignGame(const String& gameId);
 
+  // Drop the persistent connection (e.g. after WiFi loss)
+  static void closeConnection();
+
  private:
   static String apiToken;
   static String makeHttpRequest(const String& method, const String& path, const String& body = "");
-  static bool parseGameFullEvent(const String& json, LichessGameState& state);
-  static bool parseGameStateEvent(const String& json, LichessGameState& state);
 };
 
 #endif // LICHESS_API_H
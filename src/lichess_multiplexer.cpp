@@ -0,0 +1,269 @@
+#include "lichess_multiplexer.h"
+
+// Reopen rate limits: TLS handshakes are expensive and a flaky network
+// must not thrash them
+#define EVENT_STREAM_RECONNECT_MS 5000UL
+#define GAME_STREAM_RECONNECT_MS 5000UL
+
+LichessMultiplexer::LichessMultiplexer() : active(-1), listChanged(false), lastEventReconnectMs(0) {
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++) {
+    slots[i].used = false;
+    slots[i].myColor = 'w';
+    slots[i].synced = false;
+    slots[i].dirty = false;
+    slots[i].finished = false;
+    slots[i].lastReconnectMs = 0;
+  }
+}
+
+bool LichessMultiplexer::begin() {
+  lastEventReconnectMs = millis();
+  return eventStream.openPath("/api/stream/event");
+}
+
+void LichessMultiplexer::close() {
+  eventStream.close();
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (slots[i].used)
+      slots[i].stream.close();
+}
+
+void LichessMultiplexer::update() {
+  // Account event stream: games starting and finishing anywhere
+  if (!eventStream.isOpen() && millis() - lastEventReconnectMs >= EVENT_STREAM_RECONNECT_MS) {
+    lastEventReconnectMs = millis();
+    eventStream.openPath("/api/stream/event");
+  }
+  String line;
+  while (eventStream.pollLine(line))
+    handleEventLine(line);
+
+  ensureStreams();
+  pumpGameSlots();
+}
+
+void LichessMultiplexer::seedFromOngoingGames() {
+  LichessOngoingGame games[LICHESS_MAX_GAMES];
+  int count = LichessAPI::listOngoingGames(games, LICHESS_MAX_GAMES);
+  for (int i = 0; i < count; i++)
+    addGame(games[i].gameId, games[i].myColor, games[i].fen, games[i].opponent);
+}
+
+int LichessMultiplexer::findSlot(const String& gameId) const {
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (slots[i].used && slots[i].gameId == gameId)
+      return i;
+  return -1;
+}
+
+void LichessMultiplexer::handleEventLine(const String& line) {
+  JsonDocument doc;
+  if (deserializeJson(doc, line))
+    return;
+  String type = doc["type"].as<String>();
+  JsonObject game = doc["game"];
+  String gameId = game["gameId"].as<String>();
+  if (gameId.length() == 0)
+    gameId = game["id"].as<String>();
+
+  if (type == "gameStart") {
+    char color = (game["color"].as<String>() == "black") ? 'b' : 'w';
+    addGame(gameId, color, game["fen"].as<String>(), game["opponent"]["username"].as<String>());
+  } else if (type == "gameFinish") {
+    int idx = findSlot(gameId);
+    if (idx >= 0 && !slots[idx].finished) {
+      slots[idx].finished = true;
+      slots[idx].state.gameEnded = true;
+      if (slots[idx].state.status.length() == 0)
+        slots[idx].state.status = game["status"]["name"].as<String>();
+      slots[idx].dirty = true;
+      listChanged = true;
+    }
+  }
+  // Challenge events are ignored: accept/decline stays on lichess.org
+}
+
+void LichessMultiplexer::addGame(const String& gameId, char color, const String& fen, const String& opponent) {
+  if (gameId.length() == 0 || findSlot(gameId) >= 0)
+    return;
+  int idx = -1;
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++) {
+    if (!slots[i].used) {
+      idx = i;
+      break;
+    }
+  }
+  if (idx < 0) {
+    Serial.println("Lichess mux: game table full, not tracking " + gameId);
+    return;
+  }
+  LichessGameSlot& slot = slots[idx];
+  slot.used = true;
+  slot.gameId = gameId;
+  slot.myColor = color;
+  slot.opponent = opponent;
+  slot.state = LichessGameState();
+  slot.state.gameId = gameId;
+  slot.state.myColor = color;
+  slot.state.fen = fen;
+  slot.state.gameStarted = true;
+  slot.synced = false;
+  slot.dirty = false;
+  slot.finished = false;
+  slot.lastReconnectMs = 0;
+  listChanged = true;
+  Serial.println("Lichess mux: tracking game " + gameId + (opponent.length() > 0 ? " vs " + opponent : ""));
+}
+
+// The active game always gets a live stream; the remaining budget goes to
+// background games in slot order. Slots past the budget run cache-only.
+void LichessMultiplexer::ensureStreams() {
+  int order[LICHESS_MAX_GAMES];
+  int count = 0;
+  if (active >= 0 && slots[active].used && !slots[active].finished)
+    order[count++] = active;
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (i != active && slots[i].used && !slots[i].finished)
+      order[count++] = i;
+
+  for (int k = 0; k < count; k++) {
+    LichessGameSlot& slot = slots[order[k]];
+    if (k < LICHESS_MAX_GAME_STREAMS) {
+      if (!slot.stream.isOpen() && millis() - slot.lastReconnectMs >= GAME_STREAM_RECONNECT_MS) {
+        slot.lastReconnectMs = millis();
+        slot.stream.open(slot.gameId);
+      }
+    } else if (slot.stream.isOpen()) {
+      // Over the TLS budget (a game switch reshuffled priorities): the
+      // cache goes stale until a stream frees up; resynced on activation
+      slot.stream.close();
+    }
+  }
+
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (slots[i].used && slots[i].finished && slots[i].stream.isOpen())
+      slots[i].stream.close();
+}
+
+void LichessMultiplexer::pumpGameSlots() {
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++) {
+    LichessGameSlot& slot = slots[i];
+    if (!slot.used || !slot.stream.isOpen())
+      continue;
+    slot.state.myColor = slot.myColor; // Parsers derive isMyTurn from it
+    while (slot.stream.poll(slot.state)) {
+      slot.synced = true;
+      slot.dirty = true;
+      listChanged = true;
+      if (slot.state.gameEnded)
+        slot.finished = true;
+    }
+  }
+}
+
+bool LichessMultiplexer::hasGames() const {
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (slots[i].used && !slots[i].finished)
+      return true;
+  return false;
+}
+
+int LichessMultiplexer::gameCount() const {
+  int count = 0;
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++)
+    if (slots[i].used && !slots[i].finished)
+      count++;
+  return count;
+}
+
+String LichessMultiplexer::activeGameId() const {
+  return (active >= 0 && slots[active].used) ? slots[active].gameId : String();
+}
+
+LichessGameSlot* LichessMultiplexer::getActiveSlot() {
+  return (active >= 0 && slots[active].used) ? &slots[active] : nullptr;
+}
+
+String LichessMultiplexer::activateFirstGame() {
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++) {
+    if (slots[i].used && !slots[i].finished) {
+      if (active != i) {
+        active = i;
+        listChanged = true;
+      }
+      return slots[i].gameId;
+    }
+  }
+  return String();
+}
+
+bool LichessMultiplexer::setActiveGame(const String& gameId) {
+  int idx = findSlot(gameId);
+  if (idx < 0 || slots[idx].finished)
+    return false;
+  if (active != idx) {
+    active = idx;
+    listChanged = true;
+  }
+  return true;
+}
+
+String LichessMultiplexer::nextGameId() const {
+  if (active < 0)
+    return String();
+  for (int step = 1; step <= LICHESS_MAX_GAMES; step++) {
+    int i = (active + step) % LICHESS_MAX_GAMES;
+    if (i == active)
+      break;
+    if (slots[i].used && !slots[i].finished)
+      return slots[i].gameId;
+  }
+  return String();
+}
+
+void LichessMultiplexer::removeGame(const String& gameId) {
+  int idx = findSlot(gameId);
+  if (idx < 0)
+    return;
+  slots[idx].stream.close();
+  slots[idx].used = false;
+  slots[idx].gameId = "";
+  slots[idx].opponent = "";
+  slots[idx].state = LichessGameState();
+  if (active == idx)
+    active = -1;
+  listChanged = true;
+}
+
+bool LichessMultiplexer::consumeActiveUpdate(LichessGameState& out) {
+  if (active < 0 || !slots[active].used || !slots[active].dirty)
+    return false;
+  slots[active].dirty = false;
+  out = slots[active].state;
+  return true;
+}
+
+bool LichessMultiplexer::consumeListChanged() {
+  bool changed = listChanged;
+  listChanged = false;
+  return changed;
+}
+
+void LichessMultiplexer::fillGamesJSON(JsonDocument& doc) const {
+  JsonArray arr = doc.to<JsonArray>();
+  for (int i = 0; i < LICHESS_MAX_GAMES; i++) {
+    const LichessGameSlot& slot = slots[i];
+    if (!slot.used)
+      continue;
+    JsonObject obj = arr.add<JsonObject>();
+    obj["id"] = slot.gameId;
+    obj["color"] = String(slot.myColor);
+    obj["opponent"] = slot.opponent;
+    obj["my_turn"] = slot.state.isMyTurn;
+    obj["last_move"] = slot.state.lastMove;
+    obj["status"] = slot.state.status.length() > 0 ? slot.state.status : String("started");
+    obj["finished"] = slot.finished;
+    obj["live"] = slot.stream.isOpen();
+    obj["active"] = (i == active);
+  }
+}
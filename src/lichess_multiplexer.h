@@ -0,0 +1,93 @@
+#ifndef LICHESS_MULTIPLEXER_H
+#define LICHESS_MULTIPLEXER_H
+
+#include "lichess_api.h"
+#include "lichess_stream.h"
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ---------------------------
+// Lichess multi-game multiplexer
+// ---------------------------
+// Tracks every ongoing game on the account at once, so correspondence
+// players can point the physical board at any of them. A persistent
+// /api/stream/event connection reports games starting and finishing
+// anywhere; each tracked game keeps a cached state that background NDJSON
+// streams update incrementally — a non-active game costs its line parsing,
+// nothing more. Switching the active game reuses the cache plus one
+// keep-alive request for the current FEN, instead of the old full
+// reconnect-and-resync cycle.
+
+// How many concurrent games are tracked (cached state per game)
+#define LICHESS_MAX_GAMES 4
+
+// Each live stream is its own TLS connection (~45 KB of heap), so only this
+// many game streams are held open besides the event stream. The active game
+// always gets one; games past the budget go cache-only and resync from the
+// ongoing-games list when activated.
+#define LICHESS_MAX_GAME_STREAMS 2
+
+struct LichessGameSlot {
+  bool used;
+  String gameId;
+  char myColor; // 'w' or 'b'
+  String opponent;
+  LichessGameState state; // Latest state parsed off this game's stream
+  bool synced;            // state has seen at least one stream event
+  bool dirty;             // state changed since last consumed
+  bool finished;
+  LichessStream stream;
+  unsigned long lastReconnectMs;
+};
+
+class LichessMultiplexer {
+ public:
+  LichessMultiplexer();
+
+  // Open the account event stream. Returns false if the connection failed;
+  // update() keeps retrying either way.
+  bool begin();
+  void close();
+
+  // Pump the event stream and every open game stream. Non-blocking.
+  void update();
+
+  // Add games already running when we connected — the event stream only
+  // reports games that start from now on
+  void seedFromOngoingGames();
+
+  bool hasGames() const;
+  int gameCount() const;
+  String activeGameId() const;
+  LichessGameSlot* getActiveSlot();
+
+  // Returns the activated game's id, or "" when no game is tracked
+  String activateFirstGame();
+  bool setActiveGame(const String& gameId);
+  // The next unfinished game after the active one (cyclic), "" if none
+  String nextGameId() const;
+  void removeGame(const String& gameId);
+
+  // Consume the active game's latest state if it changed since last call
+  bool consumeActiveUpdate(LichessGameState& out);
+  // True once per change to the games list (add/remove/turn/active switch)
+  bool consumeListChanged();
+
+  // Games list for the web UI (array of {id, color, opponent, ...})
+  void fillGamesJSON(JsonDocument& doc) const;
+
+ private:
+  LichessStream eventStream;
+  LichessGameSlot slots[LICHESS_MAX_GAMES];
+  int active; // Slot index of the game on the physical board, -1 = none
+  bool listChanged;
+  unsigned long lastEventReconnectMs;
+
+  int findSlot(const String& gameId) const;
+  void handleEventLine(const String& line);
+  void addGame(const String& gameId, char color, const String& fen, const String& opponent);
+  void ensureStreams();
+  void pumpGameSlots();
+};
+
+#endif // LICHESS_MULTIPLEXER_H
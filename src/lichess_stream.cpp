@@ -0,0 +1,142 @@
+#include "lichess_stream.h"
+#include "wifi_manager_esp32.h"
+
+LichessStream::LichessStream() : opened(false), headersDone(false), chunked(false), chunkRemaining(0), lastDataMs(0) {}
+
+bool LichessStream::open(const String& gameId) {
+  return openPath("/api/board/game/stream/" + gameId);
+}
+
+bool LichessStream::openPath(const String& path) {
+  close();
+
+  client.setInsecure(); // For simplicity; in production, use proper cert validation
+  if (!WiFiManagerESP32::connectWithDnsCache(client, LICHESS_API_HOST, LICHESS_API_PORT)) {
+    Serial.println("Lichess stream: Connection failed");
+    return false;
+  }
+
+  String request = "GET " + path + " HTTP/1.1\r\n";
+  request += "Host: " LICHESS_API_HOST "\r\n";
+  request += "Authorization: Bearer " + LichessAPI::getToken() + "\r\n";
+  request += "Accept: application/x-ndjson\r\n";
+  request += "Connection: keep-alive\r\n\r\n";
+  client.print(request);
+
+  opened = true;
+  headersDone = false;
+  chunked = false;
+  chunkRemaining = 0;
+  sizeLine = "";
+  lineBuffer = "";
+  lastDataMs = millis();
+  Serial.println("Lichess stream: opened " + path);
+  return true;
+}
+
+void LichessStream::close() {
+  if (opened)
+    client.stop();
+  opened = false;
+}
+
+bool LichessStream::isOpen() const {
+  return opened;
+}
+
+// Pull one payload byte through the chunked-encoding layer. Chunk-size
+// lines (and the CRLFs closing each chunk) are consumed here so callers
+// only ever see NDJSON bytes.
+bool LichessStream::readBodyByte(char& c) {
+  while (client.available()) {
+    char raw = (char)client.read();
+    if (!chunked) {
+      c = raw;
+      return true;
+    }
+    if (chunkRemaining > 0) {
+      chunkRemaining--;
+      c = raw;
+      return true;
+    }
+    // Between chunks: accumulate the size line; blank lines here are the
+    // CRLF closing the previous chunk
+    if (raw != '\n') {
+      sizeLine += raw;
+      continue;
+    }
+    sizeLine.trim();
+    if (sizeLine.length() == 0)
+      continue;
+    chunkRemaining = strtol(sizeLine.c_str(), nullptr, 16);
+    sizeLine = "";
+    if (chunkRemaining == 0) {
+      // Zero chunk: the server ended the stream
+      close();
+      return false;
+    }
+  }
+  return false;
+}
+
+bool LichessStream::poll(LichessGameState& state) {
+  String event;
+  while (pollLine(event)) {
+    // First event is gameFull, later ones gameState (or chat, ignored)
+    if (LichessAPI::parseGameFullEvent(event, state) || LichessAPI::parseGameStateEvent(event, state))
+      return true;
+  }
+  return false;
+}
+
+bool LichessStream::pollLine(String& line) {
+  if (!opened)
+    return false;
+
+  // The server closing the socket or going silent both mean reconnect
+  if (!client.connected() && !client.available()) {
+    Serial.println("Lichess stream: connection lost");
+    close();
+    return false;
+  }
+  if (millis() - lastDataMs > LICHESS_STREAM_SILENCE_MS) {
+    Serial.println("Lichess stream: gone silent, reconnecting");
+    close();
+    return false;
+  }
+
+  // Finish the response headers first
+  while (!headersDone && client.available()) {
+    lastDataMs = millis();
+    lineBuffer += (char)client.read();
+    if (lineBuffer.endsWith("\r\n\r\n")) {
+      String lower = lineBuffer;
+      lower.toLowerCase();
+      chunked = lower.indexOf("transfer-encoding: chunked") != -1;
+      lineBuffer = "";
+      headersDone = true;
+    }
+  }
+  if (!headersDone)
+    return false;
+
+  char c;
+  while (readBodyByte(c)) {
+    lastDataMs = millis();
+    if (c != '\n') {
+      lineBuffer += c;
+      continue;
+    }
+    lineBuffer.trim();
+    if (lineBuffer.length() == 0)
+      continue; // Keep-alive newline
+    if (lineBuffer[0] != '{') {
+      lineBuffer = "";
+      continue;
+    }
+    line = lineBuffer;
+    lineBuffer = "";
+    return true;
+  }
+  return false;
+}
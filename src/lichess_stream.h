@@ -0,0 +1,59 @@
+#ifndef LICHESS_STREAM_H
+#define LICHESS_STREAM_H
+
+#include "lichess_api.h"
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+// ---------------------------
+// Lichess game stream
+// ---------------------------
+// The board API is designed as a long-lived NDJSON stream, but the old
+// client reconnected over TLS for every poll and threw the connection
+// away. This holds one stream connection open per game and parses events
+// incrementally as bytes arrive, so an opponent move reaches ChessLichess
+// within a network round trip instead of a poll interval plus handshake.
+// The same chunked-NDJSON plumbing also carries the account event stream
+// (/api/stream/event) for the multi-game multiplexer, via openPath.
+
+class LichessStream {
+ public:
+  LichessStream();
+
+  // Open the board game stream (closes any previous one). Returns false
+  // if the connection could not be established.
+  bool open(const String& gameId);
+  // Open an arbitrary NDJSON streaming endpoint (e.g. /api/stream/event)
+  bool openPath(const String& path);
+  void close();
+  bool isOpen() const;
+
+  // Pump available bytes off the socket without blocking. Returns true
+  // once a complete event line has been parsed into `state` (set
+  // state.myColor before calling — the parsers derive isMyTurn from it).
+  bool poll(LichessGameState& state);
+
+  // Lower-level variant: returns one raw NDJSON object line per call,
+  // keep-alive newlines already filtered. Used for streams whose events
+  // are not game states.
+  bool pollLine(String& line);
+
+ private:
+  WiFiClientSecure client;
+  bool opened;
+  bool headersDone;
+  bool chunked;
+  long chunkRemaining; // Payload bytes left in the current chunk
+  String sizeLine;     // Chunk-size line being accumulated
+  String lineBuffer;   // NDJSON line being accumulated
+  unsigned long lastDataMs;
+
+  // Pull one payload byte through the chunked-encoding layer
+  bool readBodyByte(char& c);
+};
+
+// Stream silence longer than this means the connection is dead (Lichess
+// sends a keep-alive newline every few seconds)
+#define LICHESS_STREAM_SILENCE_MS 30000UL
+
+#endif // LICHESS_STREAM_H
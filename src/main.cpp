@@ -1,13 +1,17 @@
 #include "board_driver.h"
+#include "boot_profile.h"
 #include "chess_bot.h"
 #include "chess_engine.h"
 #include "chess_lichess.h"
 #include "chess_moves.h"
 #include "chess_utils.h"
+#include "core_layout.h"
 #include "led_colors.h"
 #include "move_history.h"
 #include "ota_updater.h"
 #include "sensor_test.h"
+#include "settings_cache.h"
+#include "sys_diag.h"
 #include "ui_comm.h"
 #include "version.h"
 #include "wifi_manager_esp32.h"
@@ -24,10 +28,11 @@ enum GameMode {
   MODE_CHESS_MOVES = 1,
   MODE_BOT = 2,
   MODE_LICHESS = 3,
-  MODE_SENSOR_TEST = 4
+  MODE_SENSOR_TEST = 4,
+  MODE_BOT_OFFLINE = 5 // Bot vs human using the on-device search (no API)
 };
 
-BotConfig botConfig = {StockfishSettings::medium(), true};
+BotConfig botConfig = {StockfishSettings::medium(), true, false};
 LichessConfig lichessConfig = {""};
 
 BoardDriver boardDriver;
@@ -48,6 +53,7 @@ bool resetGameSelection = true;
 static volatile bool uiHintRequested = false;
 static volatile bool uiNewGameRequested = false;
 static volatile bool uiResignRequested = false;
+static volatile bool uiNextGameRequested = false;
 
 static void ui_touch_handler(const char* action, int x, int y) {
   Serial.printf("UI touch: %s (%d,%d)\n", action, x, y);
@@ -58,17 +64,20 @@ static void ui_touch_handler(const char* action, int x, int y) {
     uiNewGameRequested = true;
   } else if (strcmp(action, "resign") == 0) {
     uiResignRequested = true;
+  } else if (strcmp(action, "nextgame") == 0) {
+    uiNextGameRequested = true;
   } else if (strcmp(action, "undo") == 0) {
     Serial.println("Undo requested from UI (not yet supported)");
   } else if (strcmp(action, "board") == 0) {
     Serial.printf("UI board touch: row=%d col=%d\n", x, y);
   } else if (strcmp(action, "mode") == 0) {
     Serial.printf("Mode selected from UI: %d\n", x);
-    if (x >= 1 && x <= 4) {
+    if (x >= 1 && x <= 5) {
       currentMode = (GameMode)x;
       modeInitialized = false;
-      if (currentMode == MODE_BOT) {
+      if (currentMode == MODE_BOT || currentMode == MODE_BOT_OFFLINE) {
         botConfig = wifiManager.getBotConfig();
+        botConfig.useLocalEngine = (currentMode == MODE_BOT_OFFLINE);
       } else if (currentMode == MODE_LICHESS) {
         lichessConfig = wifiManager.getLichessConfig();
       }
@@ -77,53 +86,60 @@ static void ui_touch_handler(const char* action, int x, int y) {
   }
 }
 
-// Perform a Stockfish API request and return bestMove in UCI (or empty on failure)
-static String requestStockfishBestMove(const String& fen, const StockfishSettings& settings) {
-  WiFiSSLClient client;
-  client.setInsecure();
-  String path = StockfishAPI::buildRequestURL(fen, settings.depth);
-  Serial.println("Stockfish request (UI hint): " STOCKFISH_API_URL + path);
-  for (int attempt = 1; attempt <= settings.maxRetries; ++attempt) {
-    if (client.connect(STOCKFISH_API_URL, STOCKFISH_API_PORT)) {
-      client.println("GET " + path + " HTTP/1.1");
-      client.println("Host: " STOCKFISH_API_URL);
-      client.println("Connection: close");
-      client.println();
-      unsigned long startTime = millis();
-      String response = "";
-      bool got = false;
-      while (client.connected() && (millis() - startTime < (unsigned long)settings.timeoutMs)) {
-        if (client.available()) {
-          response = client.readString();
-          got = true;
-          break;
-        }
-        delay(10);
-      }
-      client.stop();
-      if (got && response.length() > 0) {
-        StockfishResponse resp;
-        if (StockfishAPI::parseResponse(response, resp)) {
-          return resp.bestMove;
-        } else {
-          Serial.printf("Stockfish parse error: %s\n", resp.errorMessage.c_str());
-          return String();
-        }
-      }
-    }
-    Serial.println("Stockfish API attempt failed, retrying...");
-    delay(300);
+// Perform a Stockfish API request and return bestMove in UCI (or empty on
+// failure); evaluation comes back in White-perspective pawns for the cache
+static String requestStockfishBestMove(const String& fen, const StockfishSettings& settings, float& evaluation) {
+  Serial.println("Stockfish request (UI hint)");
+  String response = StockfishAPI::request(fen, settings);
+  if (response.length() == 0)
+    return String();
+  StockfishResponse resp;
+  if (!StockfishAPI::parseResponse(response, resp)) {
+    Serial.printf("Stockfish parse error: %s\n", resp.errorMessage.c_str());
+    return String();
+  }
+  evaluation = resp.hasMate ? (resp.mateInMoves > 0 ? 100.0f : -100.0f) : resp.evaluation;
+  return resp.bestMove;
+}
+
+// Hint pipeline. The fast path (opening book, Stockfish response cache) is
+// answered inline; API requests run on a one-shot background task and hand
+// the result back through these flags so the app loop stays responsive and
+// the UART keeps a single writer.
+static String pendingHintMove;
+static volatile bool hintReady = false;
+static volatile bool hintFailed = false;
+static std::atomic<bool> hintInFlight(false);
+
+struct HintParams {
+  String fen;
+  uint64_t key;
+  StockfishSettings settings;
+};
+
+// Push a hint to the UI slave and blink it on the LED board
+static void deliverHint(const String& uci) {
+  Serial.printf("Hint (UCI): %s\n", uci.c_str());
+  UIComm::sendHintResponse(uci);
+  int fromRow = -1, fromCol = -1, toRow = -1, toCol = -1;
+  char promotion = ' ';
+  if (ChessUtils::parseUCIMove(uci, fromRow, fromCol, toRow, toCol, promotion)) {
+    // Blink origin then destination (3 times each) in Blue
+    boardDriver.blinkSquare(fromRow, fromCol, LedColors::Blue, 3, true);
+    boardDriver.blinkSquare(toRow, toCol, LedColors::Blue, 3, true);
+  } else {
+    Serial.println("Failed to parse UCI move for LED hint");
   }
-  Serial.println("Stockfish API: all attempts failed");
-  return String();
 }
 
 void showGameSelection();
 void handleGameSelection();
 void handleBotConfigSelection();
 void initializeSelectedMode(GameMode mode);
+static void appTask(void* param);
 
 void setup() {
+  BootProfile::start();
   Serial.begin(115200);
   delay(3000);
   Serial.println();
@@ -131,19 +147,28 @@ void setup() {
   Serial.println("         OpenChess Starting Up");
   Serial.println("         Firmware version: " FIRMWARE_VERSION);
   Serial.println("================================================");
+  BootProfile::mark(BOOT_SERIAL);
   if (!ChessUtils::ensureNvsInitialized())
     Serial.println("WARNING: NVS init failed (Preferences may not work)");
+  // One pass over every settings namespace; everyone else reads RAM
+  SettingsCache::begin();
+  BootProfile::mark(BOOT_NVS);
   if (!LittleFS.begin(true))
     Serial.println("ERROR: LittleFS mount failed!");
   else
     Serial.println("LittleFS mounted successfully");
+  BootProfile::mark(BOOT_FS_MOUNT);
   moveHistory.begin();
+  BootProfile::mark(BOOT_MOVE_HISTORY);
   boardDriver.begin();
+  BootProfile::mark(BOOT_BOARD_DRIVER);
   wifiManager.begin();
+  BootProfile::mark(BOOT_WIFI_SETUP);
   // Start UI communication (Serial2) — chosen pins avoid board_driver defaults
   // RX must be an input-capable pin; use RX=34, TX=25
-  UIComm::begin(115200, 34, 25);
+  UIComm::begin(921600, 34, 25);
   UIComm::setTouchHandler(ui_touch_handler);
+  BootProfile::mark(BOOT_UI_LINK);
 
   Serial.printf("Trying SSID: %s\n", WiFi.SSID().c_str());
   int attempts = 0;
@@ -153,6 +178,7 @@ void setup() {
     delay(500);
     Serial.printf("Attempt %d Status: %d\n", attempts, WiFi.status());
   }
+  BootProfile::mark(BOOT_WIFI_CONNECT);
 
   Serial.println();
   // Kick off NTP time sync (non-blocking, will resolve in background)
@@ -184,50 +210,93 @@ void setup() {
     if (currentMode != MODE_SELECTION) {
       // Tell UI slave which mode we're resuming into
       UIComm::sendMode((int)currentMode);
-      return; // Skip showing game selection
     }
   }
 
-  showGameSelection();
+  if (currentMode == MODE_SELECTION)
+    showGameSelection();
+  BootProfile::mark(BOOT_RESUME_CHECK);
+  BootProfile::report();
+
+  // Hand the application loop to its own task on CORE_APP (core_layout.h):
+  // game updates, network clients, and MoveHistory flushes run there next to
+  // the WiFi stack, keeping the realtime core free for sensor/LED/UART work
+  xTaskCreatePinnedToCore(appTask, "app", 12288, nullptr, 1, nullptr, CORE_APP);
 }
 
-void loop() {
+// One pass of the application loop (the former Arduino loop() body); runs on
+// the app task so a blocking TLS request or flash write never shares a core
+// with the realtime I/O tasks
+static void appLoop() {
   // Process deferred WiFi reconnection (from web UI)
   wifiManager.checkPendingWiFi();
 
-  // Process UI comm
-  UIComm::loop();
+  // Reap dead WebSocket clients
+  wifiManager.update();
+
+  // Periodic heap/fragmentation line so field crash reports carry the
+  // numbers leading up to the reboot
+  SysDiag::logIfDue();
+
+  // Flush buffered move-history writes once their interval elapses
+  moveHistory.update();
 
   if (uiHintRequested) {
     uiHintRequested = false;
-    Serial.println("UI requested hint — computing via Stockfish API");
     // Get current board FEN from WiFi manager (keeps latest game FEN)
     String fen = wifiManager.getCurrentFen();
     if (fen.length() == 0) {
       Serial.println("Warning: no FEN available to compute hint");
-      UIComm::sendSimple("ERROR|reason=no_fen");
+      UIComm::sendError(UIP_ERR_NO_FEN);
     } else {
-      // Use botConfig settings as hint depth preset
-      String bestUci = requestStockfishBestMove(fen, botConfig.stockfishSettings);
-      if (bestUci.length() == 0) {
-        UIComm::sendSimple("ERROR|reason=stockfish_failed");
+      // Fast path: known positions (opening book, cached API responses)
+      // answer instantly with no network round trip
+      char hintBoard[8][8];
+      char hintTurn = 'w';
+      ChessUtils::fenToBoard(fen.c_str(), hintBoard, hintTurn, nullptr);
+      uint64_t key = chessEngine.computeZobristHash(hintBoard, hintTurn);
+      String bestUci;
+      if (ChessBot::lookupKnownMove(key, hintBoard, botConfig.stockfishSettings.depth, bestUci)) {
+        Serial.println("Hint served from book/cache");
+        deliverHint(bestUci);
+      } else if (hintInFlight.load()) {
+        Serial.println("Hint request already in flight");
       } else {
-        Serial.printf("Best move (UCI): %s\n", bestUci.c_str());
-        UIComm::sendHintResponse(bestUci);
-        // Also show hint on the LED board: blink origin and destination 3 times in Blue
-        int fromRow = -1, fromCol = -1, toRow = -1, toCol = -1;
-        char promotion = ' ';
-        if (ChessUtils::parseUCIMove(bestUci, fromRow, fromCol, toRow, toCol, promotion)) {
-          // Blink origin then destination (3 times each) in Blue
-          boardDriver.blinkSquare(fromRow, fromCol, LedColors::Blue, 3, true);
-          boardDriver.blinkSquare(toRow, toCol, LedColors::Blue, 3, true);
-        } else {
-          Serial.println("Failed to parse UCI move for LED hint");
-        }
+        // Unknown position: fetch in the background (botConfig settings as
+        // hint depth preset) while the board keeps playing
+        hintInFlight.store(true);
+        auto* params = new HintParams{fen, key, botConfig.stockfishSettings};
+        xTaskCreatePinnedToCore(
+            [](void* param) {
+              auto* p = static_cast<HintParams*>(param);
+              float evaluation = 0.0f;
+              String uci = requestStockfishBestMove(p->fen, p->settings, evaluation);
+              if (uci.length() > 0) {
+                ChessBot::cacheApiMove(p->key, p->settings.depth, uci, evaluation);
+                pendingHintMove = uci;
+                hintReady = true;
+              } else {
+                hintFailed = true;
+              }
+              hintInFlight.store(false);
+              delete p;
+              vTaskDelete(NULL);
+            },
+            "hint", 8192, params, 1, NULL, CORE_APP);
       }
     }
   }
 
+  // Publish hints computed in the background
+  if (hintReady) {
+    hintReady = false;
+    deliverHint(pendingHintMove);
+  }
+  if (hintFailed) {
+    hintFailed = false;
+    UIComm::sendError(UIP_ERR_ENGINE);
+  }
+
   // Handle new game request from UI slave
   if (uiNewGameRequested) {
     uiNewGameRequested = false;
@@ -236,6 +305,15 @@ void loop() {
     return;
   }
 
+  // Handle game-switch request from UI slave (Lichess multi-game)
+  if (uiNextGameRequested) {
+    uiNextGameRequested = false;
+    if (currentMode == MODE_LICHESS && modeInitialized && chessLichess != nullptr)
+      chessLichess->requestNextGame();
+    else
+      Serial.println("No Lichess session to switch games in");
+  }
+
   // Handle resign request from UI slave
   if (uiResignRequested) {
     uiResignRequested = false;
@@ -243,7 +321,7 @@ void loop() {
     if (currentMode == MODE_CHESS_MOVES && modeInitialized && chessMoves != nullptr) {
       // In human vs human, resign the side whose turn it is
       chessMoves->resignGame(chessMoves->getCurrentTurn());
-    } else if (currentMode == MODE_BOT && modeInitialized && chessBot != nullptr) {
+    } else if ((currentMode == MODE_BOT || currentMode == MODE_BOT_OFFLINE) && modeInitialized && chessBot != nullptr) {
       // In bot mode, the human player resigns
       chessBot->resignGame(botConfig.playerIsWhite ? 'w' : 'b');
     } else if (currentMode == MODE_LICHESS && modeInitialized && chessLichess != nullptr) {
@@ -261,7 +339,7 @@ void loop() {
     if (currentMode == MODE_CHESS_MOVES && modeInitialized && chessMoves != nullptr) {
       chessMoves->setBoardStateFromFEN(editFen);
       Serial.println("Board edit applied to Chess Moves mode");
-    } else if (currentMode == MODE_BOT && modeInitialized && chessBot != nullptr) {
+    } else if ((currentMode == MODE_BOT || currentMode == MODE_BOT_OFFLINE) && modeInitialized && chessBot != nullptr) {
       chessBot->setBoardStateFromFEN(editFen);
       Serial.println("Board edit applied to Chess Bot mode");
     } else if (currentMode == MODE_LICHESS && modeInitialized && chessLichess != nullptr) {
@@ -280,7 +358,7 @@ void loop() {
     Serial.printf("Processing resign from web UI: %c resigns\n", resignColor);
     if (currentMode == MODE_CHESS_MOVES && modeInitialized && chessMoves != nullptr) {
       chessMoves->resignGame(resignColor);
-    } else if (currentMode == MODE_BOT && modeInitialized && chessBot != nullptr) {
+    } else if ((currentMode == MODE_BOT || currentMode == MODE_BOT_OFFLINE) && modeInitialized && chessBot != nullptr) {
       chessBot->resignGame(resignColor);
     } else if (currentMode == MODE_LICHESS && modeInitialized && chessLichess != nullptr) {
       chessLichess->resignGame(resignColor);
@@ -295,7 +373,7 @@ void loop() {
     Serial.println("Processing draw from web UI");
     if (currentMode == MODE_CHESS_MOVES && modeInitialized && chessMoves != nullptr) {
       chessMoves->drawGame();
-    } else if (currentMode == MODE_BOT && modeInitialized && chessBot != nullptr) {
+    } else if ((currentMode == MODE_BOT || currentMode == MODE_BOT_OFFLINE) && modeInitialized && chessBot != nullptr) {
       chessBot->drawGame();
     } else if (currentMode == MODE_LICHESS && modeInitialized && chessLichess != nullptr) {
       chessLichess->drawGame();
@@ -324,6 +402,11 @@ void loop() {
       case 4:
         currentMode = MODE_SENSOR_TEST;
         break;
+      case 5:
+        currentMode = MODE_BOT_OFFLINE;
+        botConfig = wifiManager.getBotConfig();
+        botConfig.useLocalEngine = true;
+        break;
       default:
         Serial.println("Invalid game mode selected via WiFi");
         selectedMode = 0;
@@ -338,6 +421,8 @@ void loop() {
   }
 
   if (currentMode == MODE_SELECTION) {
+    // Selection screen up and responsive counts as playable
+    BootProfile::markPlayable();
     handleGameSelection();
     return;
   }
@@ -345,6 +430,7 @@ void loop() {
   if (!modeInitialized) {
     initializeSelectedMode(currentMode);
     modeInitialized = true;
+    BootProfile::markPlayable(); // Covers the resumed-game boot path
     delay(1); // HACK: Ensure any starting animations acquire the LED mutex before proceeding
   }
 
@@ -358,6 +444,7 @@ void loop() {
       }
       break;
     case MODE_BOT:
+    case MODE_BOT_OFFLINE:
       if (chessBot != nullptr) {
         if (chessBot->isGameOver())
           showGameSelection();
@@ -389,6 +476,18 @@ void loop() {
   delay(SENSOR_READ_DELAY_MS);
 }
 
+static void appTask(void* param) {
+  (void)param;
+  while (true)
+    appLoop();
+}
+
+void loop() {
+  // Everything runs on dedicated tasks (core_layout.h) — the application
+  // loop on CORE_APP, sensor/LED/UART on CORE_REALTIME. Nothing left here.
+  vTaskDelay(pdMS_TO_TICKS(1000));
+}
+
 void showGameSelection() {
   currentMode = MODE_SELECTION;
   modeInitialized = false;
@@ -510,8 +609,11 @@ void initializeSelectedMode(GameMode mode) {
       chessMoves = new ChessMoves(&boardDriver, &chessEngine, &wifiManager, &moveHistory);
       chessMoves->begin();
       break;
+    case MODE_BOT_OFFLINE:
+      botConfig.useLocalEngine = true;
+      // fall through: offline bot is a ChessBot with the on-device engine
     case MODE_BOT:
-      Serial.printf("Starting 'Chess Bot' (Depth: %d, Player is %s)...\n", botConfig.stockfishSettings.depth, botConfig.playerIsWhite ? "White" : "Black");
+      Serial.printf("Starting 'Chess Bot' (%s, Depth: %d, Player is %s)...\n", botConfig.useLocalEngine ? "On-device" : "Stockfish API", botConfig.stockfishSettings.depth, botConfig.playerIsWhite ? "White" : "Black");
       if (chessBot != nullptr)
         delete chessBot;
       chessBot = new ChessBot(&boardDriver, &chessEngine, &wifiManager, &moveHistory, botConfig);
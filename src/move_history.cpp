@@ -1,18 +1,103 @@
 #include "move_history.h"
 #include "chess_game.h"
 #include "chess_utils.h"
+#include "core_layout.h"
+#include "perf_stats.h"
 #include <ArduinoJson.h>
 #include <algorithm>
 #include <sys/stat.h>
 #include <time.h>
 
-MoveHistory::MoveHistory() : recording(false) {
+std::atomic<uint64_t> MoveHistory::bytesLive{0};
+std::atomic<uint64_t> MoveHistory::bytesFen{0};
+std::atomic<uint64_t> MoveHistory::bytesSnapshot{0};
+std::atomic<uint64_t> MoveHistory::bytesFinalize{0};
+
+MoveHistory::MoveHistory() : recording(false), moveBufLen(0), lastFlushMs(0), finalizeTaskHandle(nullptr), finalizePending(false) {
   memset(&header, 0, sizeof(header));
 }
 
 void MoveHistory::begin() {
   if (!quietExists(GAMES_DIR))
     LittleFS.mkdir(GAMES_DIR);
+  // Build the games index on first boot after the feature landed (or if the
+  // file was lost) so old archives keep showing up
+  if (!quietExists(INDEX_PATH))
+    rebuildGamesIndex();
+
+  // A live file whose header already records a terminal result means the
+  // device rebooted between finishGame and finalization — finish the merge
+  // now, before resume logic looks for a live game
+  if (quietExists(LIVE_MOVES_PATH)) {
+    File f = LittleFS.open(LIVE_MOVES_PATH, "r");
+    if (f && f.size() >= sizeof(GameHeader)) {
+      GameHeader hdr;
+      f.read((uint8_t*)&hdr, sizeof(hdr));
+      f.close();
+      if (hdr.result != RESULT_IN_PROGRESS) {
+        Serial.println("MoveHistory: finalizing game interrupted by reboot");
+        finalizeLiveGame();
+      }
+    } else if (f) {
+      f.close();
+    }
+  }
+
+  xTaskCreatePinnedToCore(finalizeTask, "GameFinalize", 4096, this, 1, &finalizeTaskHandle, CORE_APP);
+}
+
+static GameIndexEntry indexEntryFromHeader(int id, const GameHeader& hdr) {
+  GameIndexEntry e;
+  memset(&e, 0, sizeof(e));
+  e.id = (uint16_t)id;
+  e.mode = hdr.mode;
+  e.result = hdr.result;
+  e.winnerColor = hdr.winnerColor;
+  e.playerColor = hdr.playerColor;
+  e.botDepth = hdr.botDepth;
+  e.moveCount = hdr.moveCount;
+  e.timestamp = hdr.timestamp;
+  return e;
+}
+
+void MoveHistory::appendIndexEntry(int id, const GameHeader& hdr) {
+  File f = LittleFS.open(INDEX_PATH, "a");
+  if (!f) return;
+  GameIndexEntry e = indexEntryFromHeader(id, hdr);
+  f.write((const uint8_t*)&e, sizeof(e));
+  f.close();
+  bytesFinalize += sizeof(e);
+}
+
+void MoveHistory::removeIndexEntry(int id) {
+  File f = LittleFS.open(INDEX_PATH, "r");
+  if (!f) return;
+  std::vector<GameIndexEntry> entries(f.size() / sizeof(GameIndexEntry));
+  f.read((uint8_t*)entries.data(), entries.size() * sizeof(GameIndexEntry));
+  f.close();
+
+  File fw = LittleFS.open(INDEX_PATH, "w");
+  if (!fw) return;
+  for (const auto& e : entries)
+    if (e.id != (uint16_t)id)
+      fw.write((const uint8_t*)&e, sizeof(e));
+  fw.close();
+}
+
+void MoveHistory::rebuildGamesIndex() {
+  File fw = LittleFS.open(INDEX_PATH, "w");
+  if (!fw) return;
+  for (int id : listGameIds()) {
+    File f = LittleFS.open(gamePath(id), "r");
+    if (!f || f.size() < sizeof(GameHeader)) continue;
+    GameHeader hdr;
+    f.read((uint8_t*)&hdr, sizeof(hdr));
+    f.close();
+    GameIndexEntry e = indexEntryFromHeader(id, hdr);
+    fw.write((const uint8_t*)&e, sizeof(e));
+  }
+  fw.close();
+  Serial.println("MoveHistory: games index rebuilt");
 }
 
 uint32_t MoveHistory::getTimestamp() {
@@ -115,6 +200,7 @@ void MoveHistory::enforceStorageLimits() {
   // 1. Enforce MAX_GAMES
   while ((int)ids.size() > MAX_GAMES) {
     LittleFS.remove(gamePath(ids.front()));
+    removeIndexEntry(ids.front());
     ids.erase(ids.begin());
     Serial.println("MoveHistory: deleted oldest game (max game limit)");
   }
@@ -126,12 +212,15 @@ void MoveHistory::enforceStorageLimits() {
     if (total == 0 || (float)used / (float)total <= MAX_USAGE_PERCENT)
       break;
     LittleFS.remove(gamePath(ids.front()));
+    removeIndexEntry(ids.front());
     ids.erase(ids.begin());
     Serial.println("MoveHistory: deleted oldest game (storage limit)");
   }
 }
 
 void MoveHistory::startGame(uint8_t mode, uint8_t playerColor, uint8_t botDepth) {
+  // The previous game's finalize may still be renaming live.bin
+  waitForFinalize();
   discardLiveGame();
 
   memset(&header, 0, sizeof(header));
@@ -143,12 +232,13 @@ void MoveHistory::startGame(uint8_t mode, uint8_t playerColor, uint8_t botDepth)
   header.botDepth = botDepth;
   header.timestamp = getTimestamp();
 
-  // Write initial header to live.bin
+  // Write initial header and keep live.bin open for the whole game
   File f = LittleFS.open(LIVE_MOVES_PATH, "w");
   if (f) {
     f.write((const uint8_t*)&header, sizeof(header));
     f.close();
   }
+  openLiveFile();
 
   // Create empty FEN table file
   File ft = LittleFS.open(LIVE_FEN_PATH, "w");
@@ -158,38 +248,71 @@ void MoveHistory::startGame(uint8_t mode, uint8_t playerColor, uint8_t botDepth)
   Serial.println("MoveHistory: new live game started");
 }
 
+bool MoveHistory::openLiveFile() {
+  moveBufLen = 0;
+  lastFlushMs = millis();
+  liveFile = LittleFS.open(LIVE_MOVES_PATH, "r+");
+  if (!liveFile)
+    Serial.println("MoveHistory: failed to open live.bin for recording");
+  return (bool)liveFile;
+}
+
+void MoveHistory::flushLive() {
+  if (!liveFile) return;
+  PERF_SCOPE(PERF_FLASH_LIVE_FLUSH);
+  bytesLive += moveBufLen + sizeof(header);
+  if (moveBufLen > 0) {
+    liveFile.seek(0, SeekEnd);
+    liveFile.write(moveBuffer, moveBufLen);
+    moveBufLen = 0;
+  }
+  // Header written after the entries it describes: on a crash the data can
+  // only be ahead of the header, which the resume scan tolerates
+  liveFile.seek(0);
+  liveFile.write((const uint8_t*)&header, sizeof(header));
+  liveFile.flush();
+  lastFlushMs = millis();
+}
+
+void MoveHistory::update() {
+  if (recording && moveBufLen > 0 && millis() - lastFlushMs >= LIVE_FLUSH_INTERVAL_MS)
+    flushLive();
+}
+
 void MoveHistory::addMove(int fromRow, int fromCol, int toRow, int toCol, char promotion) {
   if (!recording) return;
 
   uint16_t encoded = encodeMove(fromRow, fromCol, toRow, toCol, promotion);
-  File f = LittleFS.open(LIVE_MOVES_PATH, "a");
-  if (f) {
-    f.write((const uint8_t*)&encoded, 2);
-    f.close();
-    header.moveCount++;
-    updateLiveHeader();
-  }
+  memcpy(moveBuffer + moveBufLen, &encoded, 2);
+  moveBufLen += 2;
+  header.moveCount++;
+  if (moveBufLen >= MOVE_BUF_SIZE || millis() - lastFlushMs >= LIVE_FLUSH_INTERVAL_MS)
+    flushLive();
 }
 
-void MoveHistory::addFen(const String& fen) {
+void MoveHistory::addFen(const char* fen) {
   if (!recording) return;
 
-  // Write FEN_MARKER to moves file
+  // Buffer the FEN_MARKER entry, then flush so the marker reaches flash
+  // before its FEN table entry — the resume scan pairs them in order
   uint16_t marker = FEN_MARKER;
-  File fm = LittleFS.open(LIVE_MOVES_PATH, "a");
-  if (fm) {
-    fm.write((const uint8_t*)&marker, 2);
-    fm.close();
-    header.moveCount++;
-  }
-
-  // Write FEN entry to table file: 1-byte length + FEN string
+  memcpy(moveBuffer + moveBufLen, &marker, 2);
+  moveBufLen += 2;
+  header.moveCount++;
+  flushLive();
+
+  // Write the FEN table entry: 1-byte length + the full string. Every entry
+  // is a keyframe — the only non-initial callers are mid-game board edits
+  // (setBoardStateFromFEN), whose positions are arbitrary and NOT derivable
+  // from the recorded moves, so there is nothing safe to delta against.
+  PERF_SCOPE(PERF_FLASH_FEN_APPEND);
   File ft = LittleFS.open(LIVE_FEN_PATH, "a");
   if (ft) {
-    uint8_t len = (uint8_t)min((int)fen.length(), 255);
     header.lastFenOffset = (uint16_t)ft.size(); // Offset of this entry = current file size
+    uint8_t len = (uint8_t)min((int)strlen(fen), 254);
     ft.write(len);
-    ft.write((const uint8_t*)fen.c_str(), len);
+    ft.write((const uint8_t*)fen, len);
+    bytesFen += ft.size() - header.lastFenOffset;
     ft.close();
     header.fenEntryCnt++;
   }
@@ -198,6 +321,13 @@ void MoveHistory::addFen(const String& fen) {
 }
 
 void MoveHistory::updateLiveHeader() {
+  bytesLive += sizeof(header);
+  if (liveFile) {
+    liveFile.seek(0);
+    liveFile.write((const uint8_t*)&header, sizeof(header));
+    liveFile.flush();
+    return;
+  }
   File f = LittleFS.open(LIVE_MOVES_PATH, "r+");
   if (f) {
     f.seek(0);
@@ -216,7 +346,49 @@ void MoveHistory::finishGame(uint8_t result, char winnerColor) {
   uint32_t ts = getTimestamp();
   if (ts > 0) header.timestamp = ts;
 
-  updateLiveHeader();
+  flushLive(); // Buffered entries + final header
+
+  // Release the pre-opened handle; the finalize task reopens the file
+  if (liveFile) liveFile.close();
+
+  // The header now records a terminal result, so the game is durable even
+  // across a reboot here. The expensive part — FEN table merge, rename and
+  // storage trimming — runs on the finalize task so the endgame animation
+  // isn't competing with flash erases.
+  if (finalizeTaskHandle) {
+    finalizePending.store(true);
+    xTaskNotifyGive(finalizeTaskHandle);
+  } else {
+    finalizeLiveGame();
+  }
+}
+
+void MoveHistory::finalizeTask(void* param) {
+  MoveHistory* self = (MoveHistory*)param;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    self->finalizeLiveGame();
+    self->finalizePending.store(false);
+  }
+}
+
+void MoveHistory::waitForFinalize() {
+  while (finalizePending.load())
+    vTaskDelay(pdMS_TO_TICKS(10));
+}
+
+void MoveHistory::finalizeLiveGame() {
+  PERF_SCOPE(PERF_FLASH_FINALIZE);
+  // Self-contained: the header comes from the file, not the member, so the
+  // same path handles boot-time recovery of a finished-but-unmerged game
+  File fm = LittleFS.open(LIVE_MOVES_PATH, "r");
+  if (!fm || fm.size() < sizeof(GameHeader)) {
+    if (fm) fm.close();
+    return;
+  }
+  GameHeader hdr;
+  fm.read((uint8_t*)&hdr, sizeof(hdr));
+  fm.close();
 
   // Read FEN table
   std::vector<uint8_t> fenData;
@@ -231,10 +403,11 @@ void MoveHistory::finishGame(uint8_t result, char winnerColor) {
 
   // Append FEN table to live.bin
   if (!fenData.empty()) {
-    File fm = LittleFS.open(LIVE_MOVES_PATH, "a");
-    if (fm) {
-      fm.write(fenData.data(), fenData.size());
-      fm.close();
+    File fa = LittleFS.open(LIVE_MOVES_PATH, "a");
+    if (fa) {
+      fa.write(fenData.data(), fenData.size());
+      fa.close();
+      bytesFinalize += fenData.size();
     }
   }
 
@@ -245,9 +418,11 @@ void MoveHistory::finishGame(uint8_t result, char winnerColor) {
   int id = nextGameId();
   String dest = gamePath(id);
   LittleFS.rename(LIVE_MOVES_PATH, dest.c_str());
-  discardLiveGame();
+  appendIndexEntry(id, hdr);
+  LittleFS.remove(LIVE_FEN_PATH);
+  if (quietExists(SNAPSHOT_PATH)) LittleFS.remove(SNAPSHOT_PATH);
 
-  Serial.printf("MoveHistory: game saved as %s (%d moves) (%d FEN entries)\n", dest.c_str(), header.moveCount, header.fenEntryCnt);
+  Serial.printf("MoveHistory: game saved as %s (%d moves) (%d FEN entries)\n", dest.c_str(), hdr.moveCount, hdr.fenEntryCnt);
 }
 
 bool MoveHistory::quietExists(const char* path) {
@@ -259,11 +434,16 @@ bool MoveHistory::quietExists(const char* path) {
 
 void MoveHistory::discardLiveGame() {
   recording = false;
+  moveBufLen = 0;
+  if (liveFile) liveFile.close();
   if (quietExists(LIVE_MOVES_PATH)) LittleFS.remove(LIVE_MOVES_PATH);
   if (quietExists(LIVE_FEN_PATH)) LittleFS.remove(LIVE_FEN_PATH);
+  if (quietExists(SNAPSHOT_PATH)) LittleFS.remove(SNAPSHOT_PATH);
 }
 
 bool MoveHistory::hasLiveGame() {
+  // Don't report a finished game that is mid-rename on the finalize task
+  waitForFinalize();
   return quietExists(LIVE_MOVES_PATH);
 }
 
@@ -284,9 +464,116 @@ bool MoveHistory::getLiveGameInfo(uint8_t& mode, uint8_t& playerColor, uint8_t&
   return true;
 }
 
+void MoveHistory::saveResumeSnapshot(ChessGame* game) {
+  if (!recording || !game) return;
+
+  // live.bin must never lag the snapshot, or an archived game would be
+  // missing moves the snapshot already reflects
+  flushLive();
+
+  ResumeSnapshot snap;
+  memset(&snap, 0, sizeof(snap));
+  snap.version = SNAPSHOT_VERSION;
+  snap.currentTurn = game->currentTurn;
+  ChessEngine* eng = game->chessEngine;
+  snap.castlingRights = eng->getCastlingRights();
+  int epRow, epCol;
+  eng->getEnPassantTarget(epRow, epCol);
+  snap.epRow = (int8_t)epRow;
+  snap.epCol = (int8_t)epCol;
+  snap.halfmoveClock = (uint16_t)eng->getHalfmoveClock();
+  snap.fullmoveClock = (uint16_t)eng->getFullmoveClock();
+  snap.moveCount = header.moveCount;
+  memcpy(snap.board, game->board, sizeof(snap.board));
+
+  uint64_t hashes[SNAPSHOT_MAX_REP_ENTRIES];
+  uint8_t counts[SNAPSHOT_MAX_REP_ENTRIES];
+  int n = eng->exportRepetitionState(hashes, counts, SNAPSHOT_MAX_REP_ENTRIES);
+  snap.repEntries = (uint8_t)n;
+  snap.lastRepCount = eng->getLastRecordedCount();
+
+  // Write to a temp file and rename so a power cut mid-write leaves the
+  // previous snapshot intact (LittleFS renames are atomic)
+  PERF_SCOPE(PERF_FLASH_SNAPSHOT);
+  File f = LittleFS.open(SNAPSHOT_TMP_PATH, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&snap, sizeof(snap));
+  for (int i = 0; i < n; i++) {
+    f.write((const uint8_t*)&hashes[i], sizeof(uint64_t));
+    f.write(&counts[i], 1);
+  }
+  f.close();
+  bytesSnapshot += sizeof(snap) + n * (sizeof(uint64_t) + 1);
+  LittleFS.rename(SNAPSHOT_TMP_PATH, SNAPSHOT_PATH);
+}
+
+bool MoveHistory::restoreResumeSnapshot(ChessGame* game) {
+  File f = LittleFS.open(SNAPSHOT_PATH, "r");
+  if (!f) return false;
+
+  ResumeSnapshot snap;
+  if (f.read((uint8_t*)&snap, sizeof(snap)) != sizeof(snap) || snap.version != SNAPSHOT_VERSION) {
+    f.close();
+    return false;
+  }
+  uint64_t hashes[SNAPSHOT_MAX_REP_ENTRIES];
+  uint8_t counts[SNAPSHOT_MAX_REP_ENTRIES];
+  int n = min((int)snap.repEntries, SNAPSHOT_MAX_REP_ENTRIES);
+  for (int i = 0; i < n; i++) {
+    if (f.read((uint8_t*)&hashes[i], sizeof(uint64_t)) != sizeof(uint64_t) || f.read(&counts[i], 1) != 1) {
+      f.close();
+      return false;
+    }
+  }
+  f.close();
+
+  // Cross-check against live.bin: the snapshot must describe exactly the
+  // moves on flash, otherwise replay from the FEN keyframes is safer
+  File fm = LittleFS.open(LIVE_MOVES_PATH, "r");
+  if (!fm || fm.size() < sizeof(GameHeader)) {
+    if (fm) fm.close();
+    return false;
+  }
+  GameHeader hdr;
+  fm.read((uint8_t*)&hdr, sizeof(hdr));
+  uint16_t diskMoves = (uint16_t)((fm.size() - sizeof(GameHeader)) / 2);
+  fm.close();
+  if (hdr.version != FORMAT_VERSION || diskMoves != snap.moveCount)
+    return false;
+
+  // Restore game and engine state in place
+  memcpy(game->board, snap.board, sizeof(snap.board));
+  game->currentTurn = snap.currentTurn;
+  game->materialScore = ChessUtils::evaluatePosition(game->board);
+  game->lastUciMove = "";
+  ChessEngine* eng = game->chessEngine;
+  eng->setCastlingRights(snap.castlingRights);
+  if (snap.epRow >= 0)
+    eng->setEnPassantTarget(snap.epRow, snap.epCol);
+  else
+    eng->clearEnPassantTarget();
+  eng->setHalfmoveClock(snap.halfmoveClock);
+  eng->setFullmoveClock(snap.fullmoveClock);
+  eng->importRepetitionState(hashes, counts, n, snap.lastRepCount);
+
+  header = hdr;
+  header.moveCount = snap.moveCount;
+  if (!openLiveFile())
+    return false;
+  updateLiveHeader();
+  recording = true;
+
+  Serial.printf("MoveHistory: restored %d-move game from resume snapshot\n", snap.moveCount);
+  return true;
+}
+
 bool MoveHistory::replayIntoGame(ChessGame* game) {
   if (!game) return false;
 
+  // Fast path: one read of the snapshot instead of replaying every move
+  if (restoreResumeSnapshot(game))
+    return true;
+
   // Read live header and moves
   File fm = LittleFS.open(LIVE_MOVES_PATH, "r");
   if (!fm || fm.size() < sizeof(GameHeader)) return false;
@@ -303,9 +590,14 @@ bool MoveHistory::replayIntoGame(ChessGame* game) {
     return false;
   }
 
-  // Read all 2-byte move entries
-  std::vector<uint16_t> moves(hdr.moveCount);
-  for (uint16_t i = 0; i < hdr.moveCount; i++) {
+  // Derive the entry count from the file size rather than trusting the
+  // header: with buffered appends a crash can leave the header one flush
+  // behind the data (never ahead — flushLive writes entries first). A
+  // partial trailing byte is dropped.
+  size_t payload = fm.size() - sizeof(GameHeader);
+  uint16_t diskMoves = (uint16_t)(payload / 2);
+  std::vector<uint16_t> moves(diskMoves);
+  for (uint16_t i = 0; i < diskMoves; i++) {
     uint16_t val;
     if (fm.read((uint8_t*)&val, 2) != 2) {
       fm.close();
@@ -315,41 +607,72 @@ bool MoveHistory::replayIntoGame(ChessGame* game) {
   }
   fm.close();
 
-  // Read last FEN directly via lastFenOffset
-  String lastFen;
+  // Walk the FEN table for complete entries — its tail may also be
+  // partially flushed. Every entry addFen writes is a full keyframe
+  // (length + FEN); the 1-byte delta tag is still recognized so files from
+  // firmware that elided edit positions parse instead of desyncing the walk.
+  std::vector<uint8_t> table;
+  std::vector<uint16_t> fenOffsets;
+  std::vector<bool> isKeyframe;
   {
     File ft = LittleFS.open(LIVE_FEN_PATH, "r");
     if (!ft) return false;
-    ft.seek(hdr.lastFenOffset);
-    uint8_t len = ft.read();
-    if (len > 0) {
-      char* buf = new char[len + 1];
-      ft.read((uint8_t*)buf, len);
-      buf[len] = '\0';
-      lastFen = String(buf);
-      delete[] buf;
-    }
+    table.resize(ft.size());
+    ft.read(table.data(), table.size());
     ft.close();
+    size_t pos = 0;
+    while (pos < table.size()) {
+      uint8_t len = table[pos];
+      if (len == FEN_DELTA_TAG) {
+        fenOffsets.push_back((uint16_t)pos);
+        isKeyframe.push_back(false);
+        pos += 1;
+        continue;
+      }
+      if (len == 0 || pos + 1 + len > table.size())
+        break;
+      fenOffsets.push_back((uint16_t)pos);
+      isKeyframe.push_back(true);
+      pos += 1 + len;
+    }
   }
 
-  if (lastFen.isEmpty()) {
-    Serial.println("MoveHistory: failed to read last FEN");
+  // Pair markers with complete FEN entries in order, then resume from the
+  // LAST paired entry: only the moves recorded after it are derivable by
+  // replay. Resuming from an earlier entry would apply post-marker moves to
+  // a pre-marker board — markers record board edits, not move positions.
+  std::vector<int> markerIdx;
+  for (int i = 0; i < (int)moves.size(); i++)
+    if (moves[i] == FEN_MARKER)
+      markerIdx.push_back(i);
+  size_t paired = min(markerIdx.size(), fenOffsets.size());
+  if (paired == 0) {
+    Serial.println("MoveHistory: no complete FEN entry, cannot resume");
     return false;
   }
-
-  // Find last FEN marker in moves (scan backwards)
-  int lastFenIdx = -1;
-  for (int i = (int)moves.size() - 1; i >= 0; i--) {
+  int last = (int)paired - 1;
+  if (!isKeyframe[last]) {
+    // Delta tag from an older firmware build: the edited position was never
+    // stored, so the game genuinely cannot be reconstructed
+    Serial.println("MoveHistory: FEN entry is a delta tag, position unrecoverable");
+    return false;
+  }
+  int lastFenIdx = markerIdx[last];
+  // A marker past the resume point means an edit whose FEN never reached
+  // flash (crash between marker flush and table append) — the moves after
+  // it reference a position we don't have
+  for (int i = lastFenIdx + 1; i < (int)moves.size(); i++) {
     if (moves[i] == FEN_MARKER) {
-      lastFenIdx = i;
-      break;
+      Serial.println("MoveHistory: marker without FEN entry, cannot resume");
+      return false;
     }
   }
-
-  if (lastFenIdx < 0) {
-    Serial.println("MoveHistory: FEN marker not found in moves");
-    return false;
-  }
+  uint16_t fenOff = fenOffsets[last];
+  uint8_t fenLen = table[fenOff];
+  String lastFen;
+  lastFen.reserve(fenLen);
+  for (uint8_t i = 0; i < fenLen; i++)
+    lastFen += (char)table[fenOff + 1 + i];
 
   Serial.println("MoveHistory: resuming from FEN: " + lastFen);
 
@@ -357,9 +680,9 @@ bool MoveHistory::replayIntoGame(ChessGame* game) {
   recording = false;
   game->setBoardStateFromFEN(lastFen);
 
-  // Replay UCI moves after the last FEN marker
+  // Replay UCI moves after the last FEN marker (no markers remain past it —
+  // checked above)
   for (int i = lastFenIdx + 1; i < (int)moves.size(); i++) {
-    if (moves[i] == FEN_MARKER) continue;
     int fromRow, fromCol, toRow, toCol;
     char promotion;
     decodeMove(moves[i], fromRow, fromCol, toRow, toCol, promotion);
@@ -367,45 +690,86 @@ bool MoveHistory::replayIntoGame(ChessGame* game) {
     game->advanceTurn();
   }
 
-  // Restore header for continued recording
+  // Restore the header with counts reconstructed from what is actually on
+  // flash, not what the pre-crash header claimed
   header = hdr;
+  header.moveCount = diskMoves;
+  header.fenEntryCnt = (uint16_t)fenOffsets.size();
+  header.lastFenOffset = fenOffsets.back();
+
+  // Repair a partially flushed tail byte so continued appends stay aligned
+  if ((payload & 1) != 0) {
+    File fw = LittleFS.open(LIVE_MOVES_PATH, "w");
+    if (fw) {
+      fw.write((const uint8_t*)&header, sizeof(header));
+      fw.write((const uint8_t*)moves.data(), moves.size() * 2);
+      fw.close();
+    }
+  }
+
+  if (!openLiveFile())
+    return false;
+  updateLiveHeader();
   recording = true;
 
   Serial.printf("MoveHistory: replayed %d moves from last FEN marker, game resumed\n", (moves.size() - 1) - lastFenIdx);
   return true;
 }
 
-String MoveHistory::getGameListJSON() {
-  auto ids = listGameIds();
-  JsonDocument doc;
-  JsonArray arr = doc["games"].to<JsonArray>();
-
-  for (int id : ids) {
-    File f = LittleFS.open(gamePath(id), "r");
-    if (!f || f.size() < sizeof(GameHeader)) continue;
+void MoveHistory::fillGameListJSON(JsonDocument& doc) {
+  // One sequential read of the index instead of opening every game file
+  if (!quietExists(INDEX_PATH))
+    rebuildGamesIndex();
 
-    GameHeader hdr;
-    f.read((uint8_t*)&hdr, sizeof(hdr));
+  std::vector<GameIndexEntry> entries;
+  File f = LittleFS.open(INDEX_PATH, "r");
+  if (f) {
+    entries.resize(f.size() / sizeof(GameIndexEntry));
+    f.read((uint8_t*)entries.data(), entries.size() * sizeof(GameIndexEntry));
     f.close();
+  }
+  std::sort(entries.begin(), entries.end(), [](const GameIndexEntry& a, const GameIndexEntry& b) { return a.id < b.id; });
 
+  JsonArray arr = doc["games"].to<JsonArray>();
+  for (const auto& e : entries) {
     JsonObject obj = arr.add<JsonObject>();
-    obj["id"] = id;
-    obj["mode"] = hdr.mode;
-    obj["result"] = hdr.result;
-    obj["winner"] = String((char)hdr.winnerColor);
-    obj["playerColor"] = hdr.playerColor ? String((char)hdr.playerColor) : String("?");
-    obj["botDepth"] = hdr.botDepth;
-    obj["moveCount"] = hdr.moveCount;
-    obj["timestamp"] = hdr.timestamp;
+    obj["id"] = e.id;
+    obj["mode"] = e.mode;
+    obj["result"] = e.result;
+    obj["winner"] = String((char)e.winnerColor);
+    obj["playerColor"] = e.playerColor ? String((char)e.playerColor) : String("?");
+    obj["botDepth"] = e.botDepth;
+    obj["moveCount"] = e.moveCount;
+    obj["timestamp"] = e.timestamp;
   }
+}
 
-  String out;
-  serializeJson(doc, out);
-  return out;
+void MoveHistory::fillFlashStatsJSON(JsonDocument& doc) {
+  uint64_t live = bytesLive.load();
+  uint64_t fen = bytesFen.load();
+  uint64_t snap = bytesSnapshot.load();
+  uint64_t fin = bytesFinalize.load();
+  JsonObject flash = doc["flash"].to<JsonObject>();
+  flash["live_bytes"] = live;
+  flash["fen_bytes"] = fen;
+  flash["snapshot_bytes"] = snap;
+  flash["finalize_bytes"] = fin;
+  flash["total_bytes"] = live + fen + snap + fin;
+  size_t total = LittleFS.totalBytes();
+  flash["fs_used"] = LittleFS.usedBytes();
+  flash["fs_total"] = total;
+  // LittleFS spreads writes across the whole partition, so cumulative bytes
+  // over partition size approximates the erase cycles this boot has consumed
+  // — hold it against NOR endurance (~100k cycles) for a wear rate
+  if (total > 0)
+    flash["est_erase_cycles"] = (float)((double)(live + fen + snap + fin) / total);
 }
 
 bool MoveHistory::deleteGame(int id) {
   String path = gamePath(id);
   if (!quietExists(path.c_str())) return false;
-  return LittleFS.remove(path);
+  bool removed = LittleFS.remove(path);
+  if (removed)
+    removeIndexEntry(id);
+  return removed;
 }
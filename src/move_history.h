@@ -2,7 +2,9 @@
 #define MOVE_HISTORY_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <atomic>
 #include <vector>
 
 // Forward declaration
@@ -25,7 +27,7 @@ enum GameModeCode : uint8_t {
 };
 
 struct __attribute__((packed)) GameHeader {
-  uint8_t version;        // Format version (currently 1)
+  uint8_t version;        // Format version (currently 2: delta-encoded FEN table)
   uint8_t mode;           // GameModeCode
   uint8_t result;         // GameResult
   uint8_t winnerColor;    // 'w', 'b', 'd' (draw), '?' (in-progress)
@@ -38,6 +40,41 @@ struct __attribute__((packed)) GameHeader {
 };
 static_assert(sizeof(GameHeader) == 16, "GameHeader must be 16 bytes");
 
+// One completed game's row in the persistent games index (/games/index.bin).
+// Carries everything getGameListJSON needs so listing the archive is a
+// single sequential read of one small file.
+struct __attribute__((packed)) GameIndexEntry {
+  uint16_t id;
+  uint8_t mode;
+  uint8_t result;
+  uint8_t winnerColor;
+  uint8_t playerColor;
+  uint8_t botDepth;
+  uint8_t reserved;
+  uint16_t moveCount;
+  uint32_t timestamp;
+};
+static_assert(sizeof(GameIndexEntry) == 14, "GameIndexEntry must be 14 bytes");
+
+// Fixed head of the fast-resume snapshot (/games/resume.bin), followed by
+// repEntries × (uint64_t hash, uint8_t count) repetition pairs. Written
+// atomically after each move so a resumed game restores in one read instead
+// of replaying every move since the last FEN keyframe.
+struct __attribute__((packed)) ResumeSnapshot {
+  uint8_t version;        // SNAPSHOT_VERSION
+  char currentTurn;
+  uint8_t castlingRights;
+  int8_t epRow;           // En passant target (-1 if none)
+  int8_t epCol;
+  uint16_t halfmoveClock;
+  uint16_t fullmoveClock;
+  uint16_t moveCount;     // Must match live.bin's on-disk entry count
+  uint8_t repEntries;     // Repetition pairs following this struct
+  uint8_t lastRepCount;   // Occurrence count of the current position
+  char board[8][8];
+};
+static_assert(sizeof(ResumeSnapshot) == 77, "ResumeSnapshot must be 77 bytes");
+
 class MoveHistory {
  public:
   MoveHistory();
@@ -48,17 +85,28 @@ class MoveHistory {
   // Call once when a new game begins (writes header + starting FEN)
   void startGame(uint8_t mode, uint8_t playerColor = '?', uint8_t botDepth = 0);
 
-  // Append a move (2-byte UCI encoding) to the live file
+  // Append a move (2-byte UCI encoding) to the live game's RAM buffer;
+  // costs a memcpy unless the buffer is full or the flush interval elapsed
   void addMove(int fromRow, int fromCol, int toRow, int toCol, char promotion = ' ');
 
-  // Append a FEN marker to the live moves file and write the FEN string into the live FEN table file
-  void addFen(const String& fen);
+  // Append a FEN marker to the live moves file and a full FEN table entry.
+  // Non-initial entries record mid-game board edits — arbitrary positions
+  // that cannot be reconstructed from the move stream — so every entry
+  // stores the complete string
+  void addFen(const char* fen);
+  void addFen(const String& fen) { addFen(fen.c_str()); }
 
-  // Finalize the live game: update header, merge FEN table, rename to a completed-game file, enforce storage limits
+  // Mark the live game finished (cheap header flush); the FEN table merge,
+  // rename and storage trimming run on the background finalize task so the
+  // endgame animation stays smooth
   void finishGame(uint8_t result, char winnerColor);
 
   void discardLiveGame();
 
+  // Flush buffered moves once the flush interval elapses; call from the
+  // main loop so a lone buffered move can't sit in RAM indefinitely
+  void update();
+
   bool isRecording() const { return recording; }
 
   // Returns true if live.bin exists on flash
@@ -67,15 +115,29 @@ class MoveHistory {
   // Read mode/config from the live header (for mode selection)
   bool getLiveGameInfo(uint8_t& mode, uint8_t& playerColor, uint8_t& botDepth);
 
-  // Replay the live game into a ChessGame instance:
-  //  1. Finds the last FEN marker and its FEN string
+  // Restore the live game into a ChessGame instance. The fast path reads
+  // the resume snapshot in one go; only when the snapshot is missing or
+  // inconsistent with live.bin does it fall back to the replay path:
+  //  1. Finds the last FEN keyframe and its FEN string
   //  2. Calls game->setBoardStateFromFEN() with that FEN
-  //  3. Replays all UCI moves after the last FEN using game->applyMove()
+  //  3. Replays all UCI moves after the keyframe using game->applyMove()
   // Recording is suppressed automatically during replay
   bool replayIntoGame(ChessGame* game);
 
-  // JSON array of game metadata (id, mode, result, timestamp …)
-  String getGameListJSON();
+  // Write the fast-resume snapshot; called after every completed move
+  void saveResumeSnapshot(ChessGame* game);
+
+  // Fill a JSON array of game metadata (id, mode, result, timestamp …);
+  // the caller serializes straight into its response stream
+  void fillGameListJSON(JsonDocument& doc);
+
+  // Add a "flash" section to `doc`: per-path byte counters since boot,
+  // filesystem usage, and a wear estimate (cumulative bytes over partition
+  // size ≈ erase cycles consumed, since LittleFS levels wear across the
+  // partition). Latency histograms for the same paths live in the perf
+  // sections; together they tell "flash is slow" apart from "network is
+  // slow" when a venue reports post-move lag.
+  static void fillFlashStatsJSON(JsonDocument& doc);
 
   // Delete a single completed game by id
   bool deleteGame(int id);
@@ -94,17 +156,70 @@ class MoveHistory {
   // Decode 2 bytes back into row/col/promotion
   static void decodeMove(uint16_t encoded, int& fromRow, int& fromCol, int& toRow, int& toCol, char& promotion);
 
- private:
-  bool recording;
-  GameHeader header;
+  // Sentinel entry interleaved with moves marking a FEN checkpoint; consumers
+  // decoding the move stream (replay, PGN export) must skip these
+  static constexpr uint16_t FEN_MARKER = 0xFFFF;
 
+ private:
   static constexpr const char* GAMES_DIR = "/games";
   static constexpr const char* LIVE_MOVES_PATH = "/games/live.bin";
   static constexpr const char* LIVE_FEN_PATH = "/games/live_fen.bin";
+  static constexpr const char* INDEX_PATH = "/games/index.bin";
+  static constexpr const char* SNAPSHOT_PATH = "/games/resume.bin";
+  static constexpr const char* SNAPSHOT_TMP_PATH = "/games/resume.tmp";
+  static constexpr uint8_t SNAPSHOT_VERSION = 1;
+  static constexpr int SNAPSHOT_MAX_REP_ENTRIES = 160; // 50-move rule bounds live entries to ~100
   static constexpr int MAX_GAMES = 50;
   static constexpr float MAX_USAGE_PERCENT = 0.80f;
-  static constexpr uint8_t FORMAT_VERSION = 1;
-  static constexpr uint16_t FEN_MARKER = 0xFFFF;
+  static constexpr uint8_t FORMAT_VERSION = 2;
+  // Length byte marking a delta entry. Never written anymore — delta
+  // encoding assumed FEN entries were derivable from the move stream, but
+  // they record board edits, which aren't. Still recognized on read so
+  // tables written by firmware that emitted tags parse without desyncing
+  // (resume refuses them instead of reconstructing a wrong position).
+  static constexpr uint8_t FEN_DELTA_TAG = 0xFF;
+  static constexpr size_t MOVE_BUF_SIZE = 64;               // 32 buffered entries
+  static constexpr unsigned long LIVE_FLUSH_INTERVAL_MS = 2000;
+
+  bool recording;
+  GameHeader header;
+
+  // Live-game write buffering: live.bin stays open for the whole game and
+  // move entries collect in RAM, so a half-move no longer pays file-open,
+  // flash-program and directory-update latency in the post-move sequence
+  File liveFile;
+  uint8_t moveBuffer[MOVE_BUF_SIZE];
+  size_t moveBufLen;
+  unsigned long lastFlushMs;
+
+  // Write buffered entries and the current header through to flash
+  void flushLive();
+  bool openLiveFile();
+
+  // Bytes written per path since boot (written from the app and finalize
+  // tasks, read from the web server task)
+  static std::atomic<uint64_t> bytesLive;
+  static std::atomic<uint64_t> bytesFen;
+  static std::atomic<uint64_t> bytesSnapshot;
+  static std::atomic<uint64_t> bytesFinalize;
+
+  // Deferred game finalization: finishGame notifies the task, which merges
+  // the FEN table into live.bin, renames it and trims storage. begin() calls
+  // finalizeLiveGame directly to recover from a reboot mid-finalization.
+  TaskHandle_t finalizeTaskHandle;
+  std::atomic<bool> finalizePending;
+  static void finalizeTask(void* param);
+  void finalizeLiveGame();
+  void waitForFinalize();
+
+  // Fast path of replayIntoGame: restore state from the resume snapshot
+  bool restoreResumeSnapshot(ChessGame* game);
+
+  // Games index maintenance: append on finishGame, filter on deletions,
+  // full rebuild from the game files when the index is missing
+  void appendIndexEntry(int id, const GameHeader& hdr);
+  void removeIndexEntry(int id);
+  void rebuildGamesIndex();
 
   // Map promotion character to 4-bit code and back
   static uint8_t promoCharToCode(char p);
@@ -0,0 +1,112 @@
+#include "opening_book.h"
+#include <LittleFS.h>
+
+#define BOOK_ENTRY_SIZE 16
+#define BOOK_MAX_MOVES 16 // Moves considered per position (book lines rarely branch wider)
+
+OpeningBook::OpeningBook() : bookPath(OPENING_BOOK_PATH), entryCount(0) {}
+
+bool OpeningBook::begin(const char* path) {
+  if (entryCount > 0)
+    return true; // Already opened
+
+  bookPath = path;
+  File f = LittleFS.open(bookPath, "r");
+  if (!f) {
+    Serial.printf("Opening book: %s not found, playing without book\n", path);
+    return false;
+  }
+  entryCount = f.size() / BOOK_ENTRY_SIZE;
+  f.close();
+  Serial.printf("Opening book: %u entries (%s)\n", (unsigned)entryCount, path);
+  return entryCount > 0;
+}
+
+static uint64_t readKey(File& f, size_t index) {
+  uint8_t raw[8];
+  f.seek(index * BOOK_ENTRY_SIZE);
+  f.read(raw, sizeof(raw));
+  uint64_t key = 0;
+  for (int i = 0; i < 8; i++)
+    key = (key << 8) | raw[i];
+  return key;
+}
+
+bool OpeningBook::probe(uint64_t key, const char board[8][8], String& uciMove) {
+  if (entryCount == 0)
+    return false;
+
+  File f = LittleFS.open(bookPath, "r");
+  if (!f)
+    return false;
+
+  // Binary search for the first entry with this key
+  size_t lo = 0, hi = entryCount;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (readKey(f, mid) < key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // Collect all moves stored for this position
+  uint16_t moves[BOOK_MAX_MOVES];
+  uint16_t weights[BOOK_MAX_MOVES];
+  uint32_t totalWeight = 0;
+  int count = 0;
+  while (lo + count < entryCount && count < BOOK_MAX_MOVES) {
+    uint8_t raw[BOOK_ENTRY_SIZE];
+    f.seek((lo + count) * BOOK_ENTRY_SIZE);
+    f.read(raw, sizeof(raw));
+    uint64_t entryKey = 0;
+    for (int i = 0; i < 8; i++)
+      entryKey = (entryKey << 8) | raw[i];
+    if (entryKey != key)
+      break;
+    moves[count] = (uint16_t)((raw[8] << 8) | raw[9]);
+    weights[count] = (uint16_t)((raw[10] << 8) | raw[11]);
+    if (weights[count] == 0)
+      weights[count] = 1;
+    totalWeight += weights[count];
+    count++;
+  }
+  f.close();
+
+  if (count == 0)
+    return false;
+
+  // Weighted random pick so the bot varies its openings like the book does
+  uint32_t r = (uint32_t)random(totalWeight);
+  int pick = 0;
+  for (; pick < count - 1; pick++) {
+    if (r < weights[pick])
+      break;
+    r -= weights[pick];
+  }
+
+  // Decode: to-file | to-rank<<3 | from-file<<6 | from-rank<<9 | promo<<12
+  // (rank 0 = rank 1 = row 7)
+  uint16_t move = moves[pick];
+  int toCol = move & 7;
+  int toRow = 7 - ((move >> 3) & 7);
+  int fromCol = (move >> 6) & 7;
+  int fromRow = 7 - ((move >> 9) & 7);
+  int promo = (move >> 12) & 7;
+
+  // Standard Polyglot tools encode castling as king-takes-own-rook
+  // (e.g. e1h1); translate to the actual king move when the mover is a king
+  char mover = board[fromRow][fromCol];
+  if ((mover == 'K' || mover == 'k') && fromCol == 4 && fromRow == toRow && (toCol == 7 || toCol == 0))
+    toCol = (toCol == 7) ? 6 : 2;
+
+  uciMove = "";
+  uciMove += (char)('a' + fromCol);
+  uciMove += (char)('0' + (8 - fromRow));
+  uciMove += (char)('a' + toCol);
+  uciMove += (char)('0' + (8 - toRow));
+  static const char promoChars[] = {' ', 'n', 'b', 'r', 'q'};
+  if (promo >= 1 && promo <= 4)
+    uciMove += promoChars[promo];
+  return true;
+}
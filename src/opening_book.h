@@ -0,0 +1,39 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// ---------------------------
+// Opening book
+// ---------------------------
+// Polyglot-format .bin book on LittleFS: 16-byte big-endian entries
+// (key, move, weight, learn) sorted by key, probed with a binary search over
+// the file so early-game bot moves come back in milliseconds without any
+// network round trip. Keys are the firmware's own Zobrist hashes
+// (ChessEngine::computeZobristHash), so the book is generated with
+// tools/book_gen, not standard Polyglot tools. The file ships in data/
+// alongside the web assets (source copy in src/book/).
+
+#define OPENING_BOOK_PATH "/book.bin"
+
+class OpeningBook {
+ public:
+  OpeningBook();
+
+  // Check the book file exists and cache its entry count (idempotent).
+  // Returns false if the file is missing; probes then always miss.
+  bool begin(const char* path = OPENING_BOOK_PATH);
+  bool isAvailable() const { return entryCount > 0; }
+
+  // Look up `key` and pick one of its book moves, weighted by popularity.
+  // `board` is needed to translate the Polyglot king-takes-rook castling
+  // encoding some book tools emit. Returns the move as UCI.
+  bool probe(uint64_t key, const char board[8][8], String& uciMove);
+
+ private:
+  String bookPath;
+  size_t entryCount; // 0 = no book
+};
+
+#endif // OPENING_BOOK_H
@@ -1,5 +1,6 @@
 #include "ota_updater.h"
 #include "board_driver.h"
+#include "core_layout.h"
 #include "led_colors.h"
 #include "version.h"
 #include <ArduinoJson.h>
@@ -7,6 +8,8 @@
 #include <LittleFS.h>
 #include <Update.h>
 #include <WiFi.h>
+#include <esp_ota_ops.h>
+#include <vector>
 
 // TAR header is always 512 bytes
 static const size_t TAR_BLOCK_SIZE = 512;
@@ -72,11 +75,185 @@ size_t OtaUpdater::readStreamBytes(Stream& stream, uint8_t* buffer, size_t lengt
   return bytesRead;
 }
 
-bool OtaUpdater::skipTarBlocks(Stream& stream, size_t fileSize, size_t& bytesProcessed) {
+// How often a dropped download may be resumed before the update fails
+static const int OTA_RESUME_ATTEMPTS = 4;
+
+bool OtaUpdater::resumeDownload(OtaDownload& dl) {
+  if (!dl.http || dl.url.isEmpty())
+    return false; // Plain stream (uploaded file) — nothing to reconnect
+
+  // Give WiFi a window to come back before retrying
+  for (int i = 0; i < 30 && WiFi.status() != WL_CONNECTED; i++)
+    delay(500);
+  if (WiFi.status() != WL_CONNECTED)
+    return false;
+
+  Serial.printf("OTA: Resuming download at byte %u\n", (unsigned)dl.offset);
+  dl.http->end();
+  if (!dl.http->begin(dl.url))
+    return false;
+  char range[40];
+  snprintf(range, sizeof(range), "bytes=%u-", (unsigned)dl.offset);
+  dl.http->addHeader("Range", range);
+  int code = dl.http->GET();
+  // 206 resumes where we left off; a 200 is only usable from byte zero
+  if (code != 206 && !(code == 200 && dl.offset == 0)) {
+    Serial.printf("OTA: Resume failed, HTTP %d (server may not support ranges)\n", code);
+    dl.http->end();
+    return false;
+  }
+  dl.stream = dl.http->getStreamPtr();
+  return true;
+}
+
+size_t OtaUpdater::readDownloadBytes(OtaDownload& dl, uint8_t* buffer, size_t length, unsigned long timeoutMs) {
+  size_t got = 0;
+  int attempts = 0;
+  while (got < length) {
+    size_t r = readStreamBytes(*dl.stream, buffer + got, length - got, timeoutMs);
+    got += r;
+    dl.offset += r;
+    if (got == length)
+      break;
+    if (++attempts > OTA_RESUME_ATTEMPTS || !resumeDownload(dl))
+      break;
+  }
+  return got;
+}
+
+// ---------------------------
+// Double-buffered OTA pipeline
+// ---------------------------
+// Update.writeStream() reads a chunk, then programs it, serially — the
+// network idles during every flash erase/program and the flash idles during
+// every network read. Here a writer task programs one buffer while the
+// caller refills the other, overlapping the two.
+static const size_t OTA_PIPE_BUF_SIZE = 8192;
+
+struct OtaPipe {
+  uint8_t* buf[2];
+  size_t len[2];
+  SemaphoreHandle_t filled[2];  // Reader hands a full buffer to the writer
+  SemaphoreHandle_t drained[2]; // Writer hands an empty buffer back
+  SemaphoreHandle_t done;       // Writer has exited its loop
+  std::atomic<bool> writeFailed;
+  size_t written;
+};
+
+static void otaFlashWriterTask(void* param) {
+  OtaPipe* pipe = (OtaPipe*)param;
+  int i = 0;
+  while (true) {
+    xSemaphoreTake(pipe->filled[i], portMAX_DELAY);
+    size_t n = pipe->len[i];
+    if (n == 0)
+      break; // Sentinel: download finished or aborted
+    if (!pipe->writeFailed.load()) {
+      if (Update.write(pipe->buf[i], n) == n)
+        pipe->written += n;
+      else
+        pipe->writeFailed.store(true);
+    }
+    xSemaphoreGive(pipe->drained[i]);
+    i ^= 1;
+  }
+  xSemaphoreGive(pipe->done);
+  vTaskDelete(nullptr);
+}
+
+size_t OtaUpdater::pipelineStreamToUpdate(OtaDownload& dl) {
+  OtaPipe pipe;
+  pipe.buf[0] = (uint8_t*)malloc(OTA_PIPE_BUF_SIZE);
+  pipe.buf[1] = (uint8_t*)malloc(OTA_PIPE_BUF_SIZE);
+  if (!pipe.buf[0] || !pipe.buf[1]) {
+    // Not enough heap for the pipeline — fall back to the serial path
+    free(pipe.buf[0]);
+    free(pipe.buf[1]);
+    return Update.writeStream(*dl.stream);
+  }
+  for (int i = 0; i < 2; i++) {
+    pipe.len[i] = 0;
+    pipe.filled[i] = xSemaphoreCreateBinary();
+    pipe.drained[i] = xSemaphoreCreateBinary();
+    xSemaphoreGive(pipe.drained[i]); // Both buffers start empty
+  }
+  pipe.done = xSemaphoreCreateBinary();
+  pipe.writeFailed.store(false);
+  pipe.written = 0;
+
+  TaskHandle_t writer = nullptr;
+  xTaskCreatePinnedToCore(otaFlashWriterTask, "OtaFlash", 4096, &pipe, 1, &writer, CORE_APP);
+
+  bool sentinelSent = false;
+  size_t remaining = dl.totalLen;
+  int i = 0;
+  while (remaining > 0) {
+    xSemaphoreTake(pipe.drained[i], portMAX_DELAY);
+    if (pipe.writeFailed.load()) {
+      pipe.len[i] = 0;
+      xSemaphoreGive(pipe.filled[i]);
+      sentinelSent = true;
+      break;
+    }
+    size_t want = min(remaining, OTA_PIPE_BUF_SIZE);
+    size_t r = readDownloadBytes(dl, pipe.buf[i], want);
+    pipe.len[i] = r;
+    xSemaphoreGive(pipe.filled[i]);
+    if (r == 0) {
+      sentinelSent = true; // Stream timed out; the empty buffer doubles as the sentinel
+      break;
+    }
+    remaining -= r;
+    i ^= 1;
+  }
+  if (!sentinelSent) {
+    xSemaphoreTake(pipe.drained[i], portMAX_DELAY);
+    pipe.len[i] = 0;
+    xSemaphoreGive(pipe.filled[i]);
+  }
+  xSemaphoreTake(pipe.done, portMAX_DELAY);
+
+  for (int j = 0; j < 2; j++) {
+    vSemaphoreDelete(pipe.filled[j]);
+    vSemaphoreDelete(pipe.drained[j]);
+    free(pipe.buf[j]);
+  }
+  vSemaphoreDelete(pipe.done);
+  return pipe.written;
+}
+
+// CRC32, reflected, poly 0xEDB88320 (same as zip/zlib). Bitwise to avoid a
+// 1 KB lookup table; scanning the ~1.5 MB running partition takes well under
+// a second, which is noise next to the download it replaces.
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & -(crc & 1));
+  }
+  return ~crc;
+}
+
+uint32_t OtaUpdater::crc32File(const String& path) {
+  File f = LittleFS.open(path, "r");
+  if (!f) return 0;
+  uint32_t crc = 0;
+  uint8_t buf[256];
+  while (true) {
+    size_t n = f.read(buf, sizeof(buf));
+    if (n == 0) break;
+    crc = crc32Update(crc, buf, n);
+  }
+  f.close();
+  return crc;
+}
+
+bool OtaUpdater::skipTarBlocks(OtaDownload& dl, size_t fileSize, size_t& bytesProcessed) {
   uint8_t skip[TAR_BLOCK_SIZE];
   size_t blocks = (fileSize + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE;
   for (size_t b = 0; b < blocks; b++) {
-    size_t r = readStreamBytes(stream, skip, TAR_BLOCK_SIZE);
+    size_t r = readDownloadBytes(dl, skip, TAR_BLOCK_SIZE);
     bytesProcessed += r;
     if (r < TAR_BLOCK_SIZE) return false;
   }
@@ -111,7 +288,7 @@ void OtaUpdater::removeWebAssets(const String& dirPath) {
 // ========== Public Methods ==========
 
 OtaUpdateInfo OtaUpdater::checkForUpdate() {
-  OtaUpdateInfo info = {false, "", "", ""};
+  OtaUpdateInfo info = {false, "", "", "", ""};
 
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println("OTA: No WiFi connection, skipping update check");
@@ -150,7 +327,9 @@ OtaUpdateInfo OtaUpdater::checkForUpdate() {
   }
   info.available = true;
 
-  // Find firmware.bin and web_assets.tar in release assets
+  // Find firmware.bin, web_assets.tar and a delta patch built from exactly
+  // the running version among the release assets
+  String patchName = String("firmware-") + FIRMWARE_VERSION + ".patch";
   JsonArray assets = doc["assets"];
   for (JsonObject asset : assets) {
     String name = asset["name"] | "";
@@ -159,11 +338,14 @@ OtaUpdateInfo OtaUpdater::checkForUpdate() {
       info.firmwareUrl = url;
     else if (name == "web_assets.tar")
       info.webAssetsUrl = url;
+    else if (name == patchName)
+      info.firmwarePatchUrl = url;
   }
 
   Serial.printf("OTA: Update available: v%s\n", info.version.c_str());
   if (info.firmwareUrl.length()) Serial.println("OTA: Firmware URL: " + info.firmwareUrl);
   if (info.webAssetsUrl.length()) Serial.println("OTA: Web assets URL: " + info.webAssetsUrl);
+  if (info.firmwarePatchUrl.length()) Serial.println("OTA: Delta patch URL: " + info.firmwarePatchUrl);
 
   return info;
 }
@@ -198,7 +380,8 @@ bool OtaUpdater::applyFirmwareFromUrl(const String& url) {
 
   std::atomic<bool>* stopFlag = boardDriver->startWaitingAnimation();
 
-  size_t written = Update.writeStream(*stream);
+  OtaDownload dl = {&http, stream, url, 0, (size_t)contentLength};
+  size_t written = pipelineStreamToUpdate(dl);
 
   if (stopFlag) stopFlag->store(true);
 
@@ -223,6 +406,142 @@ bool OtaUpdater::applyFirmwareFromUrl(const String& url) {
   return true;
 }
 
+// ---------------------------
+// Delta firmware patches
+// ---------------------------
+// "OCDP" patch format, produced by the release tooling as a binary diff from
+// the previous firmware.bin to the new one. After the fixed header the patch
+// is a stream of ops that rebuild the new image into the inactive partition:
+//   0x01 COPY <uint32 srcOffset> <uint32 length>  — bytes from the running partition
+//   0x02 ADD  <uint32 length> <length bytes>      — literal bytes from the patch
+// Integers are little-endian. A typical release is mostly COPY ops, so the
+// download shrinks to roughly the changed code plus op overhead.
+struct __attribute__((packed)) OtaPatchHeader {
+  char magic[4];    // "OCDP"
+  uint32_t srcSize; // Size of the image the patch was built against
+  uint32_t srcCrc;  // CRC32 of that image, verified before patching
+  uint32_t dstSize; // Size of the patched image
+};
+
+static const uint8_t PATCH_OP_COPY = 0x01;
+static const uint8_t PATCH_OP_ADD = 0x02;
+
+bool OtaUpdater::applyFirmwarePatchFromUrl(const String& url) {
+  if (url.isEmpty()) return false;
+
+  Serial.println("OTA: Downloading firmware patch from: " + url);
+
+  HTTPClient http;
+  if (!beginHttpGet(http, url)) return false;
+
+  int contentLength = http.getSize();
+  if (contentLength <= (int)sizeof(OtaPatchHeader)) {
+    Serial.println("OTA: Invalid patch content length");
+    http.end();
+    return false;
+  }
+
+  OtaDownload dl = {&http, http.getStreamPtr(), url, 0, (size_t)contentLength};
+
+  OtaPatchHeader hdr;
+  if (readDownloadBytes(dl, (uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+      memcmp(hdr.magic, "OCDP", 4) != 0) {
+    Serial.println("OTA: Bad patch header");
+    http.end();
+    return false;
+  }
+
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  if (!running || hdr.srcSize > running->size) {
+    Serial.println("OTA: Patch source larger than running partition");
+    http.end();
+    return false;
+  }
+
+  // The patch only applies to the exact image it was built against — verify
+  // the running partition before touching the inactive one
+  uint8_t buf[1024];
+  uint32_t crc = 0;
+  for (size_t off = 0; off < hdr.srcSize; off += sizeof(buf)) {
+    size_t n = min(sizeof(buf), (size_t)(hdr.srcSize - off));
+    if (esp_partition_read(running, off, buf, n) != ESP_OK) {
+      http.end();
+      return false;
+    }
+    crc = crc32Update(crc, buf, n);
+  }
+  if (crc != hdr.srcCrc) {
+    Serial.println("OTA: Running image does not match patch base");
+    http.end();
+    return false;
+  }
+
+  if (!Update.begin(hdr.dstSize, U_FLASH)) {
+    Serial.printf("OTA: Not enough space for firmware update. Error: %s\n", Update.errorString());
+    http.end();
+    return false;
+  }
+
+  Serial.printf("OTA: Applying delta patch (%d bytes -> %u byte image)\n", contentLength, (unsigned)hdr.dstSize);
+
+  std::atomic<bool>* stopFlag = boardDriver->startWaitingAnimation();
+
+  size_t written = 0;
+  bool ok = true;
+  while (ok && written < hdr.dstSize) {
+    uint8_t op;
+    if (readDownloadBytes(dl, &op, 1) != 1) {
+      ok = false;
+    } else if (op == PATCH_OP_COPY) {
+      uint32_t args[2]; // srcOffset, length
+      ok = readDownloadBytes(dl, (uint8_t*)args, 8) == 8 &&
+           args[1] <= hdr.srcSize && args[0] <= hdr.srcSize - args[1] &&
+           args[1] <= hdr.dstSize - written;
+      for (uint32_t done = 0; ok && done < args[1];) {
+        size_t n = min(sizeof(buf), (size_t)(args[1] - done));
+        ok = esp_partition_read(running, args[0] + done, buf, n) == ESP_OK &&
+             Update.write(buf, n) == n;
+        done += n;
+        written += n;
+      }
+    } else if (op == PATCH_OP_ADD) {
+      uint32_t len;
+      ok = readDownloadBytes(dl, (uint8_t*)&len, 4) == 4 && len <= hdr.dstSize - written;
+      for (uint32_t done = 0; ok && done < len;) {
+        size_t n = min(sizeof(buf), (size_t)(len - done));
+        ok = readDownloadBytes(dl, buf, n) == n && Update.write(buf, n) == n;
+        done += n;
+        written += n;
+      }
+    } else {
+      Serial.printf("OTA: Unknown patch op 0x%02x\n", op);
+      ok = false;
+    }
+  }
+
+  if (stopFlag) stopFlag->store(true);
+
+  if (!ok || written != hdr.dstSize) {
+    Serial.printf("OTA: Patch apply failed at %u/%u bytes\n", (unsigned)written, (unsigned)hdr.dstSize);
+    Update.abort();
+    http.end();
+    return false;
+  }
+
+  if (!Update.end(true)) {
+    Serial.printf("OTA: Firmware finalize failed: %s\n", Update.errorString());
+    http.end();
+    return false;
+  }
+
+  Serial.println("OTA: Delta firmware update successful! Rebooting...");
+  boardDriver->flashBoardAnimation(LedColors::Blue, 2);
+  http.end();
+  delay(1000);
+  ESP.restart();
+  return true;
+}
+
 bool OtaUpdater::applyWebAssetsFromUrl(const String& url) {
   if (url.isEmpty()) {
     Serial.println("OTA: No web assets URL provided");
@@ -242,25 +561,82 @@ bool OtaUpdater::applyWebAssetsFromUrl(const String& url) {
   }
 
   std::atomic<bool>* stopFlag = boardDriver->startWaitingAnimation();
-  WiFiClient* stream = http.getStreamPtr();
-  bool success = applyWebAssetsFromStream(*stream, contentLength);
+  OtaDownload dl = {&http, http.getStreamPtr(), url, 0, (size_t)contentLength};
+  bool success = applyWebAssetsFromDownload(dl);
   if (stopFlag) stopFlag->store(true);
   http.end();
   return success;
 }
 
 bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
+  // Plain-stream entry point (uploaded TAR file): no resume support
+  OtaDownload dl = {nullptr, &stream, String(), 0, totalSize};
+  return applyWebAssetsFromDownload(dl);
+}
+
+// One line of the TAR's ".ota_index" entry: CRC32 and path of a shipped file
+struct AssetIndexEntry {
+  String path;
+  uint32_t crc;
+};
+
+// Index-based counterpart of removeWebAssets: delete only the files the new
+// release no longer ships, leaving /games/ and listed assets untouched
+static void removeStaleAssets(const std::vector<AssetIndexEntry>& index, const String& dirPath) {
+  File dir = LittleFS.open(dirPath);
+  if (!dir || !dir.isDirectory()) return;
+
+  File entry = dir.openNextFile();
+  while (entry) {
+    String name = entry.name();
+    String fullPath = dirPath.endsWith("/") ? dirPath + name : dirPath + "/" + name;
+    bool isDir = entry.isDirectory();
+    entry.close();
+
+    if (!fullPath.startsWith("/games") && fullPath != "/ota_temp.tar") {
+      if (isDir) {
+        removeStaleAssets(index, fullPath);
+      } else {
+        bool listed = false;
+        for (const AssetIndexEntry& e : index) {
+          if (e.path == fullPath) {
+            listed = true;
+            break;
+          }
+        }
+        if (!listed) {
+          Serial.printf("OTA: Removing stale asset %s\n", fullPath.c_str());
+          LittleFS.remove(fullPath);
+        }
+      }
+    }
+
+    entry = dir.openNextFile();
+  }
+  dir.close();
+}
+
+bool OtaUpdater::applyWebAssetsFromDownload(OtaDownload& dl) {
+  size_t totalSize = dl.totalLen;
   Serial.printf("OTA: Starting web assets update (%d bytes)\n", totalSize);
 
   uint8_t header[TAR_BLOCK_SIZE];
   int filesWritten = 0;
+  int filesSkipped = 0;
   size_t bytesRead = 0;
 
-  removeWebAssets("/");
+  // Per-file CRC index (".ota_index" as the archive's first entry, one
+  // "<8-hex crc32> <path>" line per file). With an index, files whose size
+  // and CRC already match on LittleFS keep their flash blocks and only
+  // stale files are removed afterwards. Index-less archives keep the old
+  // behavior: wipe everything, extract everything.
+  std::vector<AssetIndexEntry> index;
+  bool haveIndex = false;
+  bool wipedLegacy = false;
 
   while (true) {
     // Read TAR header block (512 bytes)
-    size_t headerRead = readStreamBytes(stream, header, TAR_BLOCK_SIZE);
+    size_t headerRead = readDownloadBytes(dl, header, TAR_BLOCK_SIZE);
     bytesRead += headerRead;
     if (headerRead < TAR_BLOCK_SIZE) break;
 
@@ -290,7 +666,7 @@ bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
 
     // Skip directories, symlinks, and zero-size entries
     if (typeFlag == '5' || typeFlag == '2' || fileSize == 0) {
-      skipTarBlocks(stream, fileSize, bytesRead);
+      skipTarBlocks(dl, fileSize, bytesRead);
       continue;
     }
 
@@ -300,10 +676,68 @@ bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
 
     // Skip files in /games/ directory
     if (outPath.startsWith("/games/") || outPath == "/games") {
-      skipTarBlocks(stream, fileSize, bytesRead);
+      skipTarBlocks(dl, fileSize, bytesRead);
+      continue;
+    }
+
+    // Consume the CRC index rather than extracting it
+    if (outPath == "/.ota_index" && !haveIndex) {
+      String idx;
+      idx.reserve(fileSize);
+      size_t idxRemaining = fileSize;
+      size_t idxAligned = ((fileSize + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE) * TAR_BLOCK_SIZE;
+      uint8_t idxBuf[TAR_BLOCK_SIZE];
+      for (size_t done = 0; done < idxAligned;) {
+        size_t r = readDownloadBytes(dl, idxBuf, TAR_BLOCK_SIZE);
+        bytesRead += r;
+        size_t useLen = min(r, idxRemaining);
+        idx.concat((const char*)idxBuf, useLen);
+        idxRemaining -= useLen;
+        done += r;
+        if (r < TAR_BLOCK_SIZE) break;
+      }
+      int pos = 0;
+      while (pos < (int)idx.length()) {
+        int nl = idx.indexOf('\n', pos);
+        String line = nl < 0 ? idx.substring(pos) : idx.substring(pos, nl);
+        pos = nl < 0 ? (int)idx.length() : nl + 1;
+        line.trim();
+        int sp = line.indexOf(' ');
+        if (sp < 8) continue; // Expect an 8-digit hex CRC before the path
+        AssetIndexEntry e;
+        e.crc = strtoul(line.substring(0, sp).c_str(), nullptr, 16);
+        e.path = line.substring(sp + 1);
+        if (!e.path.startsWith("/")) e.path = "/" + e.path;
+        index.push_back(e);
+      }
+      haveIndex = !index.empty();
+      Serial.printf("OTA: Asset index lists %d files\n", (int)index.size());
       continue;
     }
 
+    if (haveIndex) {
+      const AssetIndexEntry* indexed = nullptr;
+      for (const AssetIndexEntry& e : index) {
+        if (e.path == outPath) {
+          indexed = &e;
+          break;
+        }
+      }
+      if (indexed && LittleFS.exists(outPath)) {
+        File existing = LittleFS.open(outPath, "r");
+        bool sameSize = existing && (size_t)existing.size() == fileSize;
+        if (existing) existing.close();
+        if (sameSize && crc32File(outPath) == indexed->crc) {
+          skipTarBlocks(dl, fileSize, bytesRead);
+          filesSkipped++;
+          continue;
+        }
+      }
+    } else if (!wipedLegacy) {
+      removeWebAssets("/");
+      wipedLegacy = true;
+    }
+
     // Create parent directories (LittleFS.mkdir creates intermediate directories)
     int lastSlash = outPath.lastIndexOf('/');
     if (lastSlash > 0) {
@@ -315,7 +749,7 @@ bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
     File outFile = LittleFS.open(outPath, "w");
     if (!outFile) {
       Serial.printf("OTA: Failed to create file: %s\n", outPath.c_str());
-      skipTarBlocks(stream, fileSize, bytesRead);
+      skipTarBlocks(dl, fileSize, bytesRead);
       continue;
     }
 
@@ -327,7 +761,7 @@ bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
 
     while (dataRead < blockAlignedSize) {
       size_t toRead = min(sizeof(buf), blockAlignedSize - dataRead);
-      size_t chunkRead = readStreamBytes(stream, buf, toRead);
+      size_t chunkRead = readDownloadBytes(dl, buf, toRead);
       bytesRead += chunkRead;
 
       // Write only actual file data (not TAR block padding)
@@ -345,14 +779,17 @@ bool OtaUpdater::applyWebAssetsFromStream(Stream& stream, size_t totalSize) {
     filesWritten++;
   }
 
-  Serial.printf("OTA: Web assets update complete. %d files extracted.\n", filesWritten);
+  if (haveIndex)
+    removeStaleAssets(index, "/");
 
-  if (filesWritten > 0)
+  Serial.printf("OTA: Web assets update complete. %d files extracted, %d unchanged.\n", filesWritten, filesSkipped);
+
+  if (filesWritten + filesSkipped > 0)
     boardDriver->flashBoardAnimation(LedColors::Cyan, 2);
   else
     boardDriver->flashBoardAnimation(LedColors::Red, 2);
 
-  return filesWritten > 0;
+  return filesWritten + filesSkipped > 0;
 }
 
 void OtaUpdater::applyUpdate(const OtaUpdateInfo& info) {
@@ -365,7 +802,15 @@ void OtaUpdater::applyUpdate(const OtaUpdateInfo& info) {
       Serial.println("OTA: Web assets update failed");
   }
 
-  // Apply firmware update (triggers reboot on success)
+  // Apply firmware update (triggers reboot on success). Prefer the delta
+  // patch when the release carries one for the running version; any failure
+  // (base mismatch, dropped download) falls back to the full image.
+  if (!info.firmwarePatchUrl.isEmpty()) {
+    Serial.println("OTA: Updating firmware from delta patch...");
+    if (applyFirmwarePatchFromUrl(info.firmwarePatchUrl))
+      return;
+    Serial.println("OTA: Delta update failed, falling back to full image");
+  }
   if (!info.firmwareUrl.isEmpty()) {
     Serial.println("OTA: Updating firmware...");
     if (!applyFirmwareFromUrl(info.firmwareUrl))
@@ -3,16 +3,33 @@
 
 #include <Arduino.h>
 
+class HTTPClient;
+
+// A resumable HTTP-backed download. Tracks the URL and bytes consumed so
+// the stream can be reopened with a Range request after a WiFi drop instead
+// of restarting the whole transfer. http == nullptr means a plain stream
+// (e.g. a LittleFS file) with no resume support.
+struct OtaDownload {
+  HTTPClient* http;
+  Stream* stream;
+  String url;
+  size_t offset; // Bytes consumed so far
+  size_t totalLen;
+};
+
 // Forward declarations
 class BoardDriver;
 class HTTPClient;
 
-// OTA update check result
+// OTA update check result. firmwarePatchUrl is set when the release carries
+// a delta patch built against the running version ("firmware-<current>.patch");
+// applyUpdate prefers it and falls back to the full image if patching fails.
 struct OtaUpdateInfo {
   bool available;
   String version;
   String firmwareUrl;
   String webAssetsUrl;
+  String firmwarePatchUrl;
 };
 
 class OtaUpdater {
@@ -23,6 +40,12 @@ class OtaUpdater {
 
   bool applyFirmwareFromUrl(const String& url);
 
+  // Apply a binary-diff patch ("OCDP" format, see ota_updater.cpp) against the
+  // running partition into the inactive one. Verifies the running image's CRC
+  // against the patch header first; returns false on any mismatch so the
+  // caller can fall back to the full firmware image.
+  bool applyFirmwarePatchFromUrl(const String& url);
+
   bool applyWebAssetsFromUrl(const String& url);
 
   bool applyWebAssetsFromStream(Stream& stream, size_t contentLength);
@@ -49,8 +72,27 @@ class OtaUpdater {
   // Read exactly 'length' bytes from a stream with timeout. Returns actual bytes read.
   static size_t readStreamBytes(Stream& stream, uint8_t* buffer, size_t length, unsigned long timeoutMs = 10000);
 
+  // readStreamBytes on an OtaDownload: a stalled read triggers a Range-based
+  // reconnect at the current offset before giving up
+  static size_t readDownloadBytes(OtaDownload& dl, uint8_t* buffer, size_t length, unsigned long timeoutMs = 10000);
+
+  // Wait for WiFi to come back and reopen dl with Range: bytes=<offset>-
+  static bool resumeDownload(OtaDownload& dl);
+
+  // Stream dl.totalLen bytes into the Update partition through a two-buffer
+  // pipeline: a writer task programs flash while the caller fills the other
+  // buffer from the network. Returns the number of bytes written.
+  static size_t pipelineStreamToUpdate(OtaDownload& dl);
+
+  // TAR extraction worker shared by the URL (resumable) and uploaded-file paths
+  bool applyWebAssetsFromDownload(OtaDownload& dl);
+
   // Skip the TAR data blocks for an entry of the given file size. Updates bytesProcessed.
-  static bool skipTarBlocks(Stream& stream, size_t fileSize, size_t& bytesProcessed);
+  static bool skipTarBlocks(OtaDownload& dl, size_t fileSize, size_t& bytesProcessed);
+
+  // CRC32 (reflected, poly 0xEDB88320 — same as zip/zlib) of a LittleFS file,
+  // used to detect unchanged web assets against the TAR's .ota_index entries
+  static uint32_t crc32File(const String& path);
 
   // Recursively remove all LittleFS files except those under /games/
   static void removeWebAssets(const String& dirPath = "/");
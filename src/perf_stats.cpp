@@ -0,0 +1,98 @@
+#include "perf_stats.h"
+
+PerfStats::Section PerfStats::sections[PERF_SECTION_COUNT] = {};
+portMUX_TYPE PerfStats::mux = portMUX_INITIALIZER_UNLOCKED;
+
+const char* PerfStats::sectionName(int i) {
+  switch (i) {
+    case PERF_SENSOR_SWEEP: return "sensorSweep";
+    case PERF_SHOW_LEDS: return "showLEDs";
+    case PERF_APPLY_MOVE: return "applyMove";
+    case PERF_UPDATE_GAME_STATUS: return "updateGameStatus";
+    case PERF_STOCKFISH_REQUEST: return "stockfishRequest";
+    case PERF_UI_STATE_PUSH: return "uiStatePush";
+    case PERF_SENSOR_TO_LED: return "sensorToLed";
+    case PERF_FLASH_LIVE_FLUSH: return "flashLiveFlush";
+    case PERF_FLASH_FEN_APPEND: return "flashFenAppend";
+    case PERF_FLASH_SNAPSHOT: return "flashSnapshot";
+    case PERF_FLASH_FINALIZE: return "flashFinalize";
+    default: return "?";
+  }
+}
+
+void PerfStats::record(PerfSection section, uint32_t cycles) {
+  // Bucket index = position of the highest set bit (log2 of the sample)
+  int bucket = 31 - __builtin_clz(cycles | 1);
+  Section& s = sections[section];
+  portENTER_CRITICAL(&mux);
+  s.count++;
+  s.sumCycles += cycles;
+  if (s.count == 1 || cycles < s.minCycles) s.minCycles = cycles;
+  if (cycles > s.maxCycles) s.maxCycles = cycles;
+  s.histogram[bucket]++;
+  portEXIT_CRITICAL(&mux);
+}
+
+uint32_t PerfStats::p99Cycles(const Section& s) {
+  if (s.count == 0) return 0;
+  uint64_t threshold = ((uint64_t)s.count * 99 + 99) / 100; // ceil(count * 0.99)
+  uint64_t cumulative = 0;
+  for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+    cumulative += s.histogram[b];
+    if (cumulative >= threshold) {
+      // Upper bound of this bucket, capped by the true maximum
+      uint64_t upper = (b >= 31) ? UINT32_MAX : ((uint64_t)2 << b) - 1;
+      return (upper > s.maxCycles) ? s.maxCycles : (uint32_t)upper;
+    }
+  }
+  return s.maxCycles;
+}
+
+void PerfStats::fillJSON(JsonDocument& doc) {
+  uint32_t mhz = getCpuFrequencyMhz();
+  doc["cpu_mhz"] = mhz;
+  JsonArray arr = doc["sections"].to<JsonArray>();
+  for (int i = 0; i < PERF_SECTION_COUNT; i++) {
+    // Snapshot under the lock so count/sum/histogram agree
+    portENTER_CRITICAL(&mux);
+    Section s = sections[i];
+    portEXIT_CRITICAL(&mux);
+    JsonObject o = arr.add<JsonObject>();
+    o["name"] = sectionName(i);
+    o["count"] = s.count;
+    if (s.count > 0) {
+      o["min_us"] = s.minCycles / mhz;
+      o["avg_us"] = (uint32_t)(s.sumCycles / s.count) / mhz;
+      o["max_us"] = s.maxCycles / mhz;
+      o["p99_us"] = p99Cycles(s) / mhz;
+    }
+  }
+}
+
+void PerfStats::dump() {
+  uint32_t mhz = getCpuFrequencyMhz();
+  Serial.println("===== Perf stats (us) =====");
+  Serial.printf("%-18s %9s %9s %9s %9s %9s\n", "section", "count", "min", "avg", "max", "p99");
+  for (int i = 0; i < PERF_SECTION_COUNT; i++) {
+    portENTER_CRITICAL(&mux);
+    Section s = sections[i];
+    portEXIT_CRITICAL(&mux);
+    if (s.count == 0) {
+      Serial.printf("%-18s %9u\n", sectionName(i), 0u);
+      continue;
+    }
+    Serial.printf("%-18s %9lu %9lu %9lu %9lu %9lu\n", sectionName(i),
+                  (unsigned long)s.count,
+                  (unsigned long)(s.minCycles / mhz),
+                  (unsigned long)((uint32_t)(s.sumCycles / s.count) / mhz),
+                  (unsigned long)(s.maxCycles / mhz),
+                  (unsigned long)(p99Cycles(s) / mhz));
+  }
+  Serial.println("===========================");
+}
+
+void PerfStats::reset() {
+  portENTER_CRITICAL(&mux);
+  memset(sections, 0, sizeof(sections));
+  portEXIT_CRITICAL(&mux);
+}
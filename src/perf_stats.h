@@ -0,0 +1,88 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ---------------------------
+// Hot-path latency instrumentation
+// ---------------------------
+// Cycle-counter scoped timers around the paths players can feel. Each
+// section accumulates count/min/max/sum plus a log2 histogram of cycle
+// counts, cheap enough to stay enabled on deployed boards: one cycle-count
+// read on entry and a short critical section on exit. Results are exposed
+// as JSON from the /perf web endpoint and dumpable over serial, so tuning
+// work has before/after numbers from real hardware.
+//
+// Usage: PERF_SCOPE(PERF_READ_SENSORS); at the top of the timed function —
+// the destructor records when the scope exits.
+//
+// Samples are 32-bit cycle counts, so a single timed call longer than ~18 s
+// (at 240 MHz) wraps and records garbage; that only matters for the network
+// section, whose request timeout stays well under the limit.
+
+enum PerfSection {
+  PERF_SENSOR_SWEEP = 0, // BoardDriver::scanMatrix (one full matrix sweep)
+  PERF_SHOW_LEDS,        // BoardDriver::showLEDs (render + RMT transmit)
+  PERF_APPLY_MOVE,       // ChessGame::applyMove
+  PERF_UPDATE_GAME_STATUS, // ChessGame::updateGameStatus
+  PERF_STOCKFISH_REQUEST,  // ChessBot::makeStockfishRequest (network)
+  PERF_UI_STATE_PUSH,      // UIComm::sendStateUpdate (frame build + UART)
+  PERF_SENSOR_TO_LED,      // Debounced sensor edge to LED frame out (SensorTest tracer)
+  PERF_FLASH_LIVE_FLUSH,   // MoveHistory::flushLive (buffered entries + header)
+  PERF_FLASH_FEN_APPEND,   // MoveHistory::addFen FEN table write
+  PERF_FLASH_SNAPSHOT,     // MoveHistory::saveResumeSnapshot (write + rename)
+  PERF_FLASH_FINALIZE,     // MoveHistory::finalizeLiveGame (merge + rename + trim)
+  PERF_SECTION_COUNT
+};
+
+class PerfStats {
+ public:
+  // Log2 histogram: bucket b counts samples with 2^b <= cycles < 2^(b+1)
+  static const int HISTOGRAM_BUCKETS = 32;
+
+  // Add one sample (in CPU cycles) to a section
+  static void record(PerfSection section, uint32_t cycles);
+
+  // Fill `doc` with per-section stats in microseconds:
+  // { "cpu_mhz": n, "sections": [ { name, count, min_us, avg_us, max_us, p99_us } ] }
+  static void fillJSON(JsonDocument& doc);
+
+  // Print the same table over serial
+  static void dump();
+
+  // Zero all sections (e.g. to measure a single game cleanly)
+  static void reset();
+
+ private:
+  struct Section {
+    uint32_t count;
+    uint64_t sumCycles;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t histogram[HISTOGRAM_BUCKETS];
+  };
+
+  static Section sections[PERF_SECTION_COUNT];
+  static portMUX_TYPE mux; // Sections are updated from several tasks
+
+  static const char* sectionName(int i);
+  // p99 from the histogram: upper bound of the bucket where the 99th
+  // percentile falls (resolution is the bucket's power of two)
+  static uint32_t p99Cycles(const Section& s);
+};
+
+// RAII scoped timer: records the enclosing scope's duration on destruction
+class PerfScope {
+ public:
+  explicit PerfScope(PerfSection section) : section_(section), start_(ESP.getCycleCount()) {}
+  ~PerfScope() { PerfStats::record(section_, ESP.getCycleCount() - start_); }
+
+ private:
+  PerfSection section_;
+  uint32_t start_;
+};
+
+#define PERF_SCOPE(section) PerfScope _perf_scope_##section(section)
+
+#endif // PERF_STATS_H
@@ -0,0 +1,216 @@
+// Native perft harness for the chess engine.
+//
+// Runs move-generation node counts (perft) from standard test positions and
+// compares them against known-good values, then reports throughput. Build with
+// the [env:native] PlatformIO environment:
+//
+//   pio run -e native && .pio/build/native/program
+//
+// Every engine optimization should keep this green: a single wrong node count
+// means a legality bug (castling, en passant, promotion, pins, ...).
+
+#include "chess_engine.h"
+#include "chess_utils.h"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+SerialShim Serial;
+
+static ChessEngine engine;
+
+// Saved engine state for make/unmake at the perft driver level
+struct EngineState {
+  uint8_t castlingRights;
+  int epRow, epCol;
+  int halfmoveClock;
+};
+
+static EngineState saveEngineState() {
+  EngineState st;
+  st.castlingRights = engine.getCastlingRights();
+  engine.getEnPassantTarget(st.epRow, st.epCol);
+  st.halfmoveClock = engine.getHalfmoveClock();
+  return st;
+}
+
+static void restoreEngineState(const EngineState& st) {
+  engine.setCastlingRights(st.castlingRights);
+  if (st.epRow >= 0)
+    engine.setEnPassantTarget(st.epRow, st.epCol);
+  else
+    engine.clearEnPassantTarget();
+  engine.setHalfmoveClock(st.halfmoveClock);
+}
+
+// Mirror of ChessGame::updateCastlingRightsAfterMove (the game-level rule,
+// replicated here because ChessGame drags in the whole hardware stack)
+static void updateCastlingRights(int fromRow, int fromCol, int toRow, int toCol, char movedPiece, char capturedPiece) {
+  uint8_t rights = engine.getCastlingRights();
+
+  if (movedPiece == 'K')
+    rights &= ~(0x01 | 0x02);
+  else if (movedPiece == 'k')
+    rights &= ~(0x04 | 0x08);
+
+  if (movedPiece == 'R') {
+    if (fromRow == 7 && fromCol == 7) rights &= ~0x01;
+    if (fromRow == 7 && fromCol == 0) rights &= ~0x02;
+  } else if (movedPiece == 'r') {
+    if (fromRow == 0 && fromCol == 7) rights &= ~0x04;
+    if (fromRow == 0 && fromCol == 0) rights &= ~0x08;
+  }
+
+  if (capturedPiece == 'R') {
+    if (toRow == 7 && toCol == 7) rights &= ~0x01;
+    if (toRow == 7 && toCol == 0) rights &= ~0x02;
+  } else if (capturedPiece == 'r') {
+    if (toRow == 0 && toCol == 7) rights &= ~0x04;
+    if (toRow == 0 && toCol == 0) rights &= ~0x08;
+  }
+
+  engine.setCastlingRights(rights);
+}
+
+// Mirror of the board/state mutations in ChessGame::applyMove (minus all the
+// LED/sensor/recording side effects)
+static void applyMoveLocal(char board[8][8], int fromRow, int fromCol, int toRow, int toCol, char promotion) {
+  char piece = board[fromRow][fromCol];
+  char capturedPiece = board[toRow][toCol];
+
+  bool isCastling = ChessUtils::isCastlingMove(fromRow, fromCol, toRow, toCol, piece);
+  bool isEnPassantCapture = ChessUtils::isEnPassantMove(fromRow, fromCol, toRow, toCol, piece, capturedPiece);
+
+  if (toupper(piece) == 'P' && (toRow - fromRow == 2 || fromRow - toRow == 2)) {
+    engine.setEnPassantTarget((fromRow + toRow) / 2, fromCol);
+  } else {
+    engine.clearEnPassantTarget();
+  }
+  if (isEnPassantCapture) {
+    int capturedPawnRow = ChessUtils::getEnPassantCapturedPawnRow(toRow, piece);
+    capturedPiece = board[capturedPawnRow][toCol];
+    board[capturedPawnRow][toCol] = ' ';
+  }
+
+  board[toRow][toCol] = piece;
+  board[fromRow][fromCol] = ' ';
+
+  if (isCastling) {
+    int rookFromCol = (toCol - fromCol == 2) ? 7 : 0;
+    int rookToCol = (toCol - fromCol == 2) ? 5 : 3;
+    char rookPiece = ChessUtils::isWhitePiece(piece) ? 'R' : 'r';
+    board[toRow][rookToCol] = rookPiece;
+    board[toRow][rookFromCol] = ' ';
+  }
+
+  updateCastlingRights(fromRow, fromCol, toRow, toCol, piece, capturedPiece);
+
+  if (promotion != ' ')
+    board[toRow][toCol] = ChessUtils::isWhitePiece(piece) ? toupper(promotion) : tolower(promotion);
+}
+
+static uint64_t perft(char board[8][8], char sideToMove, int depth) {
+  if (depth == 0)
+    return 1;
+
+  uint64_t nodes = 0;
+  char opponent = (sideToMove == 'w') ? 'b' : 'w';
+
+  for (int row = 0; row < 8; row++) {
+    for (int col = 0; col < 8; col++) {
+      char piece = board[row][col];
+      if (piece == ' ' || ChessUtils::getPieceColor(piece) != sideToMove)
+        continue;
+
+      int moveCount = 0;
+      int moves[28][2];
+      engine.getPossibleMoves(board, row, col, moveCount, moves);
+
+      for (int i = 0; i < moveCount; i++) {
+        int toRow = moves[i][0];
+        int toCol = moves[i][1];
+
+        // Promotions count once per promotion piece
+        static const char PROMO_PIECES[] = {'q', 'r', 'b', 'n'};
+        int promoChoices = engine.isPawnPromotion(piece, toRow) ? 4 : 1;
+
+        for (int p = 0; p < promoChoices; p++) {
+          char saved[8][8];
+          memcpy(saved, board, sizeof(saved));
+          EngineState st = saveEngineState();
+
+          applyMoveLocal(board, row, col, toRow, toCol, promoChoices == 4 ? PROMO_PIECES[p] : ' ');
+          nodes += perft(board, opponent, depth - 1);
+
+          memcpy(board, saved, sizeof(saved));
+          restoreEngineState(st);
+        }
+      }
+    }
+  }
+
+  return nodes;
+}
+
+struct PerftCase {
+  const char* name;
+  const char* fen;
+  uint64_t expected[5]; // expected node counts for depth 1..5 (0 = skip)
+};
+
+// Standard positions from the chessprogramming wiki perft results page
+static const PerftCase PERFT_CASES[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {20, 400, 8902, 197281, 4865609}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862, 4085603, 0}},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624}},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", {46, 2079, 89890, 3894594, 0}},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379, 2103487, 0}},
+};
+
+int main(int argc, char** argv) {
+  int maxDepth = 5;
+  if (argc > 1)
+    maxDepth = atoi(argv[1]);
+  if (maxDepth < 1 || maxDepth > 5)
+    maxDepth = 5;
+
+  bool allPassed = true;
+  uint64_t totalNodes = 0;
+  double totalSeconds = 0.0;
+
+  for (const PerftCase& tc : PERFT_CASES) {
+    printf("=== %s ===\n", tc.name);
+    char board[8][8];
+    char sideToMove = 'w';
+    ChessUtils::fenToBoard(tc.fen, board, sideToMove, &engine);
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+      if (tc.expected[depth - 1] == 0)
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+      uint64_t nodes = perft(board, sideToMove, depth);
+      auto end = std::chrono::steady_clock::now();
+      double seconds = std::chrono::duration<double>(end - start).count();
+
+      totalNodes += nodes;
+      totalSeconds += seconds;
+
+      bool ok = (nodes == tc.expected[depth - 1]);
+      if (!ok)
+        allPassed = false;
+      printf("  perft(%d) = %llu (expected %llu) %s  [%.3fs, %.0f nodes/s]\n",
+             depth,
+             (unsigned long long)nodes,
+             (unsigned long long)tc.expected[depth - 1],
+             ok ? "OK" : "FAIL",
+             seconds,
+             seconds > 0 ? nodes / seconds : 0.0);
+    }
+  }
+
+  printf("\nTotal: %llu nodes in %.3fs (%.0f nodes/s)\n", (unsigned long long)totalNodes, totalSeconds, totalSeconds > 0 ? totalNodes / totalSeconds : 0.0);
+  printf(allPassed ? "ALL PERFT CHECKS PASSED\n" : "PERFT CHECKS FAILED\n");
+  return allPassed ? 0 : 1;
+}
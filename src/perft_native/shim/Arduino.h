@@ -0,0 +1,114 @@
+#ifndef PERFT_NATIVE_ARDUINO_SHIM_H
+#define PERFT_NATIVE_ARDUINO_SHIM_H
+
+// Minimal Arduino compatibility shim for the [env:native] perft harness.
+// Provides just enough of the Arduino core (String, Serial, PROGMEM) to
+// compile chess_engine.cpp and chess_utils.cpp on the host. Not a general
+// purpose emulation layer - extend only when the engine sources need it.
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define PROGMEM
+typedef uint8_t byte;
+
+inline unsigned long millis() {
+  return 0;
+}
+
+// Subset of the Arduino String API used by chess_utils.cpp
+class String {
+ public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned int v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(float v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f", (double)v);
+    s_ = buf;
+  }
+
+  size_t length() const { return s_.length(); }
+  const char* c_str() const { return s_.c_str(); }
+  char charAt(size_t i) const { return i < s_.length() ? s_[i] : '\0'; }
+  char operator[](size_t i) const { return charAt(i); }
+
+  int indexOf(char c) const {
+    size_t p = s_.find(c);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const char* sub) const {
+    size_t p = s_.find(sub);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+
+  String substring(size_t from) const { return String(from < s_.length() ? s_.substr(from) : std::string()); }
+  String substring(size_t from, size_t to) const {
+    if (from >= s_.length() || to <= from) return String();
+    return String(s_.substr(from, to - from));
+  }
+
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+
+  String& operator+=(const String& o) {
+    s_ += o.s_;
+    return *this;
+  }
+  String& operator+=(const char* o) {
+    s_ += o;
+    return *this;
+  }
+  String& operator+=(char c) {
+    s_ += c;
+    return *this;
+  }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b) { return String(a.s_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s_); }
+
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == o; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+
+ private:
+  std::string s_;
+};
+
+// Serial output goes straight to stdout on the host
+class SerialShim {
+ public:
+  void begin(unsigned long) {}
+  void print(const String& s) { fputs(s.c_str(), stdout); }
+  void print(const char* s) { fputs(s, stdout); }
+  void println() { fputc('\n', stdout); }
+  void println(const String& s) {
+    fputs(s.c_str(), stdout);
+    fputc('\n', stdout);
+  }
+  void println(const char* s) {
+    fputs(s, stdout);
+    fputc('\n', stdout);
+  }
+  void printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+  }
+};
+
+extern SerialShim Serial;
+
+#endif // PERFT_NATIVE_ARDUINO_SHIM_H
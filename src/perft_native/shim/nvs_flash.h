@@ -0,0 +1,17 @@
+#ifndef PERFT_NATIVE_NVS_SHIM_H
+#define PERFT_NATIVE_NVS_SHIM_H
+
+// NVS stub for the native perft harness (chess_utils.cpp includes nvs_flash.h
+// for ChessUtils::ensureNvsInitialized, which is never called on the host).
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+static inline esp_err_t nvs_flash_init(void) {
+  return ESP_OK;
+}
+static inline esp_err_t nvs_flash_erase(void) {
+  return ESP_OK;
+}
+
+#endif // PERFT_NATIVE_NVS_SHIM_H
@@ -0,0 +1,145 @@
+#include "rmt_led_strip.h"
+
+// WS2812B timing (ns). Each data bit becomes one RMT item: a high pulse
+// followed by a low pulse whose widths encode 0 or 1.
+#define WS2812_T0H_NS 350
+#define WS2812_T0L_NS 1000
+#define WS2812_T1H_NS 1000
+#define WS2812_T1L_NS 350
+// The strip latches the frame after the line idles low this long
+#define WS2812_RESET_US 80
+
+// One dedicated channel is enough: the board has a single strip
+#define LED_RMT_CHANNEL RMT_CHANNEL_0
+// APB 80 MHz / 2 = 40 MHz counter -> 25 ns per tick
+#define LED_RMT_CLK_DIV 2
+
+static uint32_t t0hTicks, t0lTicks, t1hTicks, t1lTicks;
+
+// Translator callback: the RMT driver calls this from its ISR to convert
+// pixel bytes into RMT items on the fly, refilling the peripheral's ring
+// buffer as transmission progresses — no CPU busy-waiting, no giant
+// pre-rendered item array.
+static void IRAM_ATTR ws2812RmtAdapter(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wantedNum, size_t* translatedSize, size_t* itemNum) {
+  if (src == nullptr || dest == nullptr) {
+    *translatedSize = 0;
+    *itemNum = 0;
+    return;
+  }
+  const rmt_item32_t bit0 = {{{t0hTicks, 1, t0lTicks, 0}}};
+  const rmt_item32_t bit1 = {{{t1hTicks, 1, t1lTicks, 0}}};
+  size_t bytes = 0;
+  size_t items = 0;
+  const uint8_t* data = (const uint8_t*)src;
+  while (bytes < srcSize && items + 8 <= wantedNum) {
+    for (int bit = 7; bit >= 0; bit--) {
+      dest[items++] = (*data & (1 << bit)) ? bit1 : bit0;
+    }
+    data++;
+    bytes++;
+  }
+  *translatedSize = bytes;
+  *itemNum = items;
+}
+
+RmtLedStrip::RmtLedStrip(uint16_t count, uint8_t pin) : count(count), pin(pin), brightness(255), installed(false), lastFrameStartUs(0) {
+  pixels = (uint8_t*)calloc(count * 3, 1);
+  txBuffer = (uint8_t*)calloc(count * 3, 1);
+  rebuildBrightnessLut();
+}
+
+// The frame render in show() becomes one table read per byte. This is also
+// the single place a gamma curve could fold in later without touching any
+// call site.
+void RmtLedStrip::rebuildBrightnessLut() {
+  uint16_t scale = (uint16_t)brightness + 1; // 1-256, so 255 maps to itself
+  for (int i = 0; i < 256; i++)
+    brightnessLut[i] = (i * scale) >> 8;
+}
+
+RmtLedStrip::~RmtLedStrip() {
+  uninstall();
+  free(pixels);
+  free(txBuffer);
+}
+
+void RmtLedStrip::install() {
+  rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, LED_RMT_CHANNEL);
+  config.clk_div = LED_RMT_CLK_DIV;
+  rmt_config(&config);
+  rmt_driver_install(LED_RMT_CHANNEL, 0, 0);
+
+  // Convert the WS2812 pulse widths into counter ticks at the chosen divider
+  uint32_t ticksPerUs = 80000000UL / LED_RMT_CLK_DIV / 1000000UL;
+  t0hTicks = ticksPerUs * WS2812_T0H_NS / 1000;
+  t0lTicks = ticksPerUs * WS2812_T0L_NS / 1000;
+  t1hTicks = ticksPerUs * WS2812_T1H_NS / 1000;
+  t1lTicks = ticksPerUs * WS2812_T1L_NS / 1000;
+  rmt_translator_init(LED_RMT_CHANNEL, ws2812RmtAdapter);
+  installed = true;
+}
+
+void RmtLedStrip::uninstall() {
+  if (!installed)
+    return;
+  rmt_wait_tx_done(LED_RMT_CHANNEL, portMAX_DELAY);
+  rmt_driver_uninstall(LED_RMT_CHANNEL);
+  installed = false;
+}
+
+void RmtLedStrip::begin() {
+  if (!installed)
+    install();
+  show(); // Latch the cleared buffer so the strip starts dark
+}
+
+void RmtLedStrip::setPin(uint8_t newPin) {
+  if (pin == newPin)
+    return;
+  pin = newPin;
+  if (installed) {
+    uninstall();
+    install();
+  }
+}
+
+void RmtLedStrip::setBrightness(uint8_t value) {
+  // Unlike Adafruit's destructive rescale, brightness is applied when the
+  // frame is rendered into the TX buffer, so changing it never loses color
+  // information — the next show() picks it up
+  if (value == brightness)
+    return;
+  brightness = value;
+  rebuildBrightnessLut();
+}
+
+void RmtLedStrip::setPixelColor(uint16_t index, uint32_t color) {
+  if (index >= count)
+    return;
+  uint8_t* p = &pixels[index * 3];
+  p[0] = (color >> 8) & 0xFF; // G
+  p[1] = (color >> 16) & 0xFF; // R
+  p[2] = color & 0xFF; // B
+}
+
+void RmtLedStrip::show() {
+  if (!installed)
+    return;
+
+  // The previous frame may still be streaming out of the peripheral; its
+  // translator reads txBuffer, so wait before rendering the next frame
+  rmt_wait_tx_done(LED_RMT_CHANNEL, portMAX_DELAY);
+
+  // Keep the line idle long enough for the strip to latch the previous
+  // frame before starting a new one
+  unsigned long frameUs = (unsigned long)count * 24UL * 125UL / 100UL; // 1.25 us per bit
+  unsigned long latchAt = lastFrameStartUs + frameUs + WS2812_RESET_US;
+  while ((long)(latchAt - micros()) > 0)
+    delayMicroseconds(5);
+
+  for (int i = 0; i < count * 3; i++)
+    txBuffer[i] = brightnessLut[pixels[i]];
+
+  lastFrameStartUs = micros();
+  rmt_write_sample(LED_RMT_CHANNEL, txBuffer, count * 3, false);
+}
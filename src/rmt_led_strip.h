@@ -0,0 +1,46 @@
+#ifndef RMT_LED_STRIP_H
+#define RMT_LED_STRIP_H
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+
+// ---------------------------
+// RMT-backed WS2812B strip driver
+// ---------------------------
+// Drop-in replacement for the subset of the Adafruit_NeoPixel API the board
+// driver uses. Adafruit's show() bit-bangs the protocol with interrupts
+// disabled for the whole 64-LED frame (~2 ms), which jittered the sensor
+// debounce timers and the UART to the UI slave. Here the RMT peripheral
+// clocks the waveform out in hardware: show() hands the frame to the driver
+// and returns while transmission runs, so the CPU keeps scanning sensors.
+// Pixel order on the wire is GRB, matching the previous NEO_GRB config.
+class RmtLedStrip {
+ public:
+  RmtLedStrip(uint16_t count, uint8_t pin);
+  ~RmtLedStrip();
+
+  void begin();
+  void setPin(uint8_t pin); // Re-installs the RMT channel if already begun
+  void setBrightness(uint8_t value);
+  void setPixelColor(uint16_t index, uint32_t color);
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+  void show();
+
+ private:
+  uint16_t count;
+  uint8_t pin;
+  uint8_t brightness;
+  uint8_t brightnessLut[256]; // Scale table rebuilt only when brightness changes
+  uint8_t* pixels;            // Composed colors in GRB order, brightness not applied
+  uint8_t* txBuffer;          // Brightness-scaled copy owned by the in-flight frame
+  bool installed;
+  unsigned long lastFrameStartUs;
+
+  void install();
+  void uninstall();
+  void rebuildBrightnessLut();
+};
+
+#endif // RMT_LED_STRIP_H
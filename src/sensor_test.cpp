@@ -1,8 +1,9 @@
 #include "sensor_test.h"
 #include "chess_utils.h"
+#include "perf_stats.h"
 #include <Arduino.h>
 
-SensorTest::SensorTest(BoardDriver* bd) : boardDriver(bd), complete(false) {
+SensorTest::SensorTest(BoardDriver* bd) : boardDriver(bd), complete(false), lastChatterReport(0), traceCount(0), traceSumUs(0), traceMinUs(0), traceMaxUs(0) {
   memset(visited, false, sizeof(visited));
 }
 
@@ -10,6 +11,10 @@ void SensorTest::begin() {
   Serial.println("Sensor Test: Visit all squares with a piece to complete the test!");
   complete = false;
   memset(visited, false, sizeof(visited));
+  traceCount = 0;
+  traceSumUs = 0;
+  traceMinUs = 0;
+  traceMaxUs = 0;
   boardDriver->clearAllLEDs();
 }
 
@@ -17,23 +22,67 @@ void SensorTest::update() {
   if (complete) return;
 
   boardDriver->readSensors();
+
+  // Drain this frame's debounced transitions; each carries the timestamp of
+  // its sensor edge, closed out against the LED frame below
+  SensorEvent pending[SENSOR_EVENT_QUEUE_LEN];
+  int pendingCount = 0;
+  SensorEvent ev;
+  while (boardDriver->getSensorEvent(ev))
+    if (pendingCount < SENSOR_EVENT_QUEUE_LEN)
+      pending[pendingCount++] = ev;
+
   boardDriver->clearAllLEDs(false);
 
   int visitedCount = 0;
   for (int row = 0; row < 8; row++) {
     for (int col = 0; col < 8; col++) {
-      if (boardDriver->getSensorState(row, col))
+      if (boardDriver->getSensorState(row, col)) {
         visited[row][col] = true;
-      if (visited[row][col]) {
-        boardDriver->setSquareLED(row, col, LedColors::White);
-        visitedCount++;
+        // Live occupancy in green so lifts change the frame too — both edge
+        // directions stay traceable for the whole session
+        boardDriver->setSquareLED(row, col, LedColors::Green);
+      } else if (visited[row][col]) {
+        // Yellow marks squares the adaptive debounce has demoted to the
+        // long window because of chatter — worth a look at the sensor
+        boardDriver->setSquareLED(row, col, boardDriver->isSquareChattery(row, col) ? LedColors::Yellow : LedColors::White);
       }
+      if (visited[row][col])
+        visitedCount++;
     }
   }
   boardDriver->showLEDs();
+
+  // The LEDs now reflect every drained transition: record edge-to-frame
+  // latency for each, both locally and in the /perf distribution
+  if (pendingCount > 0) {
+    int64_t now = esp_timer_get_time();
+    uint32_t mhz = getCpuFrequencyMhz();
+    for (int i = 0; i < pendingCount; i++) {
+      uint32_t us = (uint32_t)(now - pending[i].timestampUs);
+      PerfStats::record(PERF_SENSOR_TO_LED, us * mhz);
+      traceCount++;
+      traceSumUs += us;
+      if (traceCount == 1 || us < traceMinUs) traceMinUs = us;
+      if (us > traceMaxUs) traceMaxUs = us;
+    }
+  }
+
+  // Periodic chatter report so flaky sensors can be identified over serial
+  if (millis() - lastChatterReport >= 5000) {
+    lastChatterReport = millis();
+    for (int row = 0; row < 8; row++)
+      for (int col = 0; col < 8; col++)
+        if (boardDriver->getChatterScore(row, col) > 0)
+          Serial.printf("Sensor %c%d: chatter score %u%s\n", (char)('a' + col), 8 - row, boardDriver->getChatterScore(row, col), boardDriver->isSquareChattery(row, col) ? " (slow debounce)" : "");
+    if (traceCount > 0)
+      Serial.printf("Sensor->LED latency: %lu edges, min %lu avg %lu max %lu us\n",
+                    (unsigned long)traceCount, (unsigned long)traceMinUs,
+                    (unsigned long)(traceSumUs / traceCount), (unsigned long)traceMaxUs);
+  }
   if (visitedCount == 64) {
     complete = true;
     Serial.println("Sensor Test complete! All squares verified");
     boardDriver->fireworkAnimation();
   }
-}
\ No newline at end of file
+}
@@ -6,11 +6,24 @@
 // ---------------------------
 // Sensor Test Mode Class
 // ---------------------------
+// Besides verifying every square, the test traces end-to-end latency: each
+// debounced sensor transition carries its edge timestamp, the square's LED
+// is driven through the normal setSquareLED/showLEDs path, and the delta is
+// recorded. The distribution lands in the /perf endpoint (sensorToLed
+// section) and a summary prints over serial during the session — the
+// acceptance number for debounce, scanning and LED driver changes.
 class SensorTest {
  private:
   BoardDriver* boardDriver;
-  bool visited[8][8]; // Track which squares have been visited
-  bool complete;      // True when all squares visited
+  bool visited[8][8];             // Track which squares have been visited
+  bool complete;                  // True when all squares visited
+  unsigned long lastChatterReport; // Last periodic chatter score dump
+
+  // Sensor-to-LED latency over this test session (microseconds)
+  uint32_t traceCount;
+  uint64_t traceSumUs;
+  uint32_t traceMinUs;
+  uint32_t traceMaxUs;
 
  public:
   SensorTest(BoardDriver* bd);
@@ -19,4 +32,4 @@ class SensorTest {
   bool isComplete() const { return complete; }
 };
 
-#endif // SENSOR_TEST_H
\ No newline at end of file
+#endif // SENSOR_TEST_H
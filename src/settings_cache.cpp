@@ -0,0 +1,260 @@
+#include "settings_cache.h"
+#include "chess_utils.h"
+#include "core_layout.h"
+#include <Preferences.h>
+
+// A burst of setter calls (slider dragged in the web UI) collapses into one
+// commit this many milliseconds after the last nudge
+#define SETTINGS_COMMIT_DELAY_MS 250
+
+LedSettingsNV SettingsCache::led = {};
+WifiCredsNV SettingsCache::wifi = {};
+LastApNV SettingsCache::lastAp = {};
+String SettingsCache::lichessToken;
+bool SettingsCache::autoOta = false;
+HwConfigNV SettingsCache::hw = {};
+uint32_t SettingsCache::dirtyBits = 0;
+SemaphoreHandle_t SettingsCache::mutex = nullptr;
+TaskHandle_t SettingsCache::commitTaskHandle = nullptr;
+
+void SettingsCache::begin() {
+  if (mutex != nullptr)
+    return;
+  mutex = xSemaphoreCreateMutex();
+
+  if (!ChessUtils::ensureNvsInitialized()) {
+    Serial.println("SettingsCache: NVS init failed - settings not loaded");
+  } else {
+    Preferences prefs;
+
+    prefs.begin("ledSettings", false);
+    led.valid = prefs.isKey("brightness");
+    led.brightness = prefs.getUChar("brightness", 0);
+    led.dimMultiplier = prefs.getUChar("dimMult", 70);
+    prefs.end();
+
+    prefs.begin("wifiCreds", false);
+    wifi.valid = prefs.isKey("ssid");
+    if (wifi.valid) {
+      wifi.ssid = prefs.getString("ssid", "");
+      wifi.pass = prefs.getString("pass", "");
+    }
+    wifi.scanAllValid = prefs.isKey("scanAll");
+    wifi.scanAll = prefs.getBool("scanAll", false);
+    lastAp.valid = prefs.getBytes("lastBssid", lastAp.bssid, sizeof(lastAp.bssid)) == sizeof(lastAp.bssid);
+    lastAp.channel = prefs.getInt("lastChannel", 0);
+    lastAp.ssid = prefs.getString("lastSsid", "");
+    prefs.end();
+
+    prefs.begin("lichess", false);
+    if (prefs.isKey("token"))
+      lichessToken = prefs.getString("token", "");
+    prefs.end();
+
+    prefs.begin("ota", false);
+    autoOta = prefs.getBool("autoUpdate", false);
+    prefs.end();
+
+    prefs.begin("hwConfig", false);
+    hw.valid = prefs.isKey("ver");
+    if (hw.valid) {
+      hw.ledPin = prefs.getUChar("ledPin", 0);
+      hw.srClkPin = prefs.getUChar("srClk", 0);
+      hw.srLatchPin = prefs.getUChar("srLatch", 0);
+      hw.srDataPin = prefs.getUChar("srData", 0);
+      hw.srInvertOutputs = prefs.getBool("srInvert", false);
+      hw.rowPinsValid = prefs.getBytesLength("rowPins") == sizeof(hw.rowPins);
+      if (hw.rowPinsValid)
+        prefs.getBytes("rowPins", hw.rowPins, sizeof(hw.rowPins));
+    }
+    prefs.end();
+  }
+
+  xTaskCreatePinnedToCore(commitTask, "SettingsCommit", 4096, nullptr, 1, &commitTaskHandle, CORE_APP);
+}
+
+void SettingsCache::markDirty(uint32_t bit) {
+  dirtyBits |= bit; // Caller holds the mutex
+  if (commitTaskHandle)
+    xTaskNotifyGive(commitTaskHandle);
+}
+
+void SettingsCache::commitTask(void* param) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    vTaskDelay(pdMS_TO_TICKS(SETTINGS_COMMIT_DELAY_MS));
+    // Drain nudges that arrived during the delay — they're covered by
+    // the commit below
+    while (ulTaskNotifyTake(pdTRUE, 0) > 0) {
+    }
+    commitDirty();
+  }
+}
+
+void SettingsCache::commitDirty() {
+  // Snapshot under the lock, write outside it: NVS commits take
+  // milliseconds and setters must not block on them
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t bits = dirtyBits;
+  dirtyBits = 0;
+  LedSettingsNV ledSnap = led;
+  WifiCredsNV wifiSnap = wifi;
+  LastApNV lastApSnap = lastAp;
+  String tokenSnap = lichessToken;
+  bool otaSnap = autoOta;
+  HwConfigNV hwSnap = hw;
+  xSemaphoreGive(mutex);
+
+  if (bits == 0 || !ChessUtils::ensureNvsInitialized())
+    return;
+
+  Preferences prefs;
+  if (bits & DIRTY_LED) {
+    prefs.begin("ledSettings", false);
+    prefs.putUChar("brightness", ledSnap.brightness);
+    prefs.putUChar("dimMult", ledSnap.dimMultiplier);
+    prefs.end();
+  }
+  if (bits & (DIRTY_WIFI | DIRTY_LAST_AP)) {
+    prefs.begin("wifiCreds", false);
+    if (bits & DIRTY_WIFI) {
+      if (wifiSnap.valid) {
+        prefs.putString("ssid", wifiSnap.ssid);
+        prefs.putString("pass", wifiSnap.pass);
+      }
+      if (wifiSnap.scanAllValid)
+        prefs.putBool("scanAll", wifiSnap.scanAll);
+    }
+    if ((bits & DIRTY_LAST_AP) && lastApSnap.valid) {
+      prefs.putBytes("lastBssid", lastApSnap.bssid, sizeof(lastApSnap.bssid));
+      prefs.putInt("lastChannel", lastApSnap.channel);
+      prefs.putString("lastSsid", lastApSnap.ssid);
+    }
+    prefs.end();
+  }
+  if (bits & DIRTY_LICHESS) {
+    prefs.begin("lichess", false);
+    prefs.putString("token", tokenSnap);
+    prefs.end();
+  }
+  if (bits & DIRTY_OTA) {
+    prefs.begin("ota", false);
+    prefs.putBool("autoUpdate", otaSnap);
+    prefs.end();
+  }
+  if (bits & DIRTY_HW) {
+    prefs.begin("hwConfig", false);
+    prefs.putUChar("ver", 1);
+    prefs.putUChar("ledPin", hwSnap.ledPin);
+    prefs.putUChar("srClk", hwSnap.srClkPin);
+    prefs.putUChar("srLatch", hwSnap.srLatchPin);
+    prefs.putUChar("srData", hwSnap.srDataPin);
+    prefs.putBool("srInvert", hwSnap.srInvertOutputs);
+    prefs.putBytes("rowPins", hwSnap.rowPins, sizeof(hwSnap.rowPins));
+    prefs.end();
+  }
+}
+
+LedSettingsNV SettingsCache::getLed() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  LedSettingsNV s = led;
+  xSemaphoreGive(mutex);
+  return s;
+}
+
+void SettingsCache::setLed(uint8_t brightness, uint8_t dimMultiplier) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  led.valid = true;
+  led.brightness = brightness;
+  led.dimMultiplier = dimMultiplier;
+  markDirty(DIRTY_LED);
+  xSemaphoreGive(mutex);
+}
+
+WifiCredsNV SettingsCache::getWifi() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  WifiCredsNV s = wifi;
+  xSemaphoreGive(mutex);
+  return s;
+}
+
+void SettingsCache::setWifiCreds(const String& ssid, const String& pass) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  wifi.valid = true;
+  wifi.ssid = ssid;
+  wifi.pass = pass;
+  markDirty(DIRTY_WIFI);
+  xSemaphoreGive(mutex);
+}
+
+void SettingsCache::setScanAll(bool scanAll) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  wifi.scanAll = scanAll;
+  wifi.scanAllValid = true;
+  markDirty(DIRTY_WIFI);
+  xSemaphoreGive(mutex);
+}
+
+LastApNV SettingsCache::getLastAp() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  LastApNV s = lastAp;
+  xSemaphoreGive(mutex);
+  return s;
+}
+
+void SettingsCache::setLastAp(const uint8_t bssid[6], int32_t channel, const String& ssid) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  lastAp.valid = true;
+  memcpy(lastAp.bssid, bssid, sizeof(lastAp.bssid));
+  lastAp.channel = channel;
+  lastAp.ssid = ssid;
+  markDirty(DIRTY_LAST_AP);
+  xSemaphoreGive(mutex);
+}
+
+String SettingsCache::getLichessToken() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  String s = lichessToken;
+  xSemaphoreGive(mutex);
+  return s;
+}
+
+void SettingsCache::setLichessToken(const String& token) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  lichessToken = token;
+  markDirty(DIRTY_LICHESS);
+  xSemaphoreGive(mutex);
+}
+
+bool SettingsCache::getAutoOta() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  bool b = autoOta;
+  xSemaphoreGive(mutex);
+  return b;
+}
+
+void SettingsCache::setAutoOta(bool enabled) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  autoOta = enabled;
+  markDirty(DIRTY_OTA);
+  xSemaphoreGive(mutex);
+}
+
+HwConfigNV SettingsCache::getHw() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  HwConfigNV s = hw;
+  xSemaphoreGive(mutex);
+  return s;
+}
+
+void SettingsCache::setHw(const HwConfigNV& newHw) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  hw = newHw;
+  hw.valid = true;
+  markDirty(DIRTY_HW);
+  xSemaphoreGive(mutex);
+}
+
+void SettingsCache::flush() {
+  commitDirty();
+}
@@ -0,0 +1,112 @@
+#ifndef SETTINGS_CACHE_H
+#define SETTINGS_CACHE_H
+
+#include <Arduino.h>
+
+// ---------------------------
+// NVS settings cache
+// ---------------------------
+// RAM-resident cache over the small NVS-backed settings that used to be
+// read and written with one Preferences open/commit per call site. begin()
+// loads every namespace once at boot; getters copy out of RAM, setters mark
+// the group dirty and nudge a commit task that coalesces bursts and writes
+// on CORE_APP — so a settings change from a web handler never runs a flash
+// commit on the async TCP task mid-animation.
+//
+// Board calibration ("boardCal") stays on direct Preferences access: it is
+// blob-heavy, written once per calibration, and immediately followed by a
+// reboot.
+//
+// Each group mirrors one NVS namespace with its existing keys, so boards
+// upgrading to this firmware keep their settings. `valid` is false when the
+// namespace had no saved value — the caller applies its compile-time
+// default, exactly like the old isKey checks.
+
+struct LedSettingsNV {
+  bool valid;
+  uint8_t brightness;
+  uint8_t dimMultiplier;
+};
+
+struct WifiCredsNV {
+  bool valid; // ssid/pass saved
+  String ssid;
+  String pass;
+  bool scanAll;
+  bool scanAllValid; // scanAll ever saved (else the compile-time default applies)
+};
+
+// Last associated AP, for the directed fast-reconnect path
+struct LastApNV {
+  bool valid;
+  uint8_t bssid[6];
+  int32_t channel;
+  String ssid;
+};
+
+struct HwConfigNV {
+  bool valid;
+  uint8_t ledPin;
+  uint8_t srClkPin;
+  uint8_t srLatchPin;
+  uint8_t srDataPin;
+  bool srInvertOutputs;
+  uint8_t rowPins[8];
+  bool rowPinsValid;
+};
+
+class SettingsCache {
+ public:
+  // Load all namespaces and start the commit task; call right after NVS init
+  static void begin();
+
+  static LedSettingsNV getLed();
+  static void setLed(uint8_t brightness, uint8_t dimMultiplier);
+
+  static WifiCredsNV getWifi();
+  static void setWifiCreds(const String& ssid, const String& pass);
+  static void setScanAll(bool scanAll);
+
+  static LastApNV getLastAp();
+  static void setLastAp(const uint8_t bssid[6], int32_t channel, const String& ssid);
+
+  static String getLichessToken();
+  static void setLichessToken(const String& token);
+
+  static bool getAutoOta();
+  static void setAutoOta(bool enabled);
+
+  static HwConfigNV getHw();
+  static void setHw(const HwConfigNV& hw);
+
+  // Commit all dirty groups on the calling task; for paths that reboot
+  // right after saving
+  static void flush();
+
+ private:
+  enum DirtyBit : uint32_t {
+    DIRTY_LED = 1 << 0,
+    DIRTY_WIFI = 1 << 1,
+    DIRTY_LAST_AP = 1 << 2,
+    DIRTY_LICHESS = 1 << 3,
+    DIRTY_OTA = 1 << 4,
+    DIRTY_HW = 1 << 5,
+  };
+
+  static void markDirty(uint32_t bit);
+  static void commitTask(void* param);
+  static void commitDirty();
+
+  static LedSettingsNV led;
+  static WifiCredsNV wifi;
+  static LastApNV lastAp;
+  static String lichessToken;
+  static bool autoOta;
+  static HwConfigNV hw;
+
+  static uint32_t dirtyBits;      // Guarded by mutex
+  static SemaphoreHandle_t mutex; // Strings cross tasks — a critical section won't do
+  static TaskHandle_t commitTaskHandle;
+};
+
+#endif // SETTINGS_CACHE_H
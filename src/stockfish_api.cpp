@@ -1,4 +1,160 @@
 #include "stockfish_api.h"
+#include "wifi_manager_esp32.h"
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+// ---------------------------
+// Persistent keep-alive connection
+// ---------------------------
+// A TLS handshake takes 2-4 seconds on the ESP32 and used to be paid on
+// every single request — at low search depths it dominated the bot's
+// response time. One WiFiClientSecure is kept open across requests with
+// HTTP keep-alive and reconnected only on error or once the server-side
+// idle window has likely expired. Every caller (bot moves, ponder
+// prefetch, UI hints) goes through request() so connection management
+// lives in one place; a mutex serializes them across tasks.
+
+static WiFiClientSecure apiClient;
+static unsigned long lastRequestMs = 0;
+static SemaphoreHandle_t apiMutex = nullptr;
+
+// Past the typical server keep-alive window, assume the connection is
+// already half-closed and reconnect up front instead of discovering it
+// with a failed request
+#define STOCKFISH_KEEPALIVE_IDLE_MS 55000UL
+
+static bool connectionUsable() {
+  return apiClient.connected() && (millis() - lastRequestMs) < STOCKFISH_KEEPALIVE_IDLE_MS;
+}
+
+void StockfishAPI::closeConnection() {
+  apiClient.stop();
+}
+
+// Read one HTTP response off the shared connection. With keep-alive the
+// connection staying open no longer delimits the body, so the response is
+// framed by Content-Length (or chunked encoding, decoded here). Returns
+// headers + body — parseResponse strips the headers — or "" on timeout.
+static String readHttpResponse(int timeoutMs) {
+  unsigned long start = millis();
+  String headers = "";
+  while (!headers.endsWith("\r\n\r\n")) {
+    if (millis() - start >= (unsigned long)timeoutMs)
+      return "";
+    if (apiClient.available()) {
+      headers += (char)apiClient.read();
+    } else if (!apiClient.connected()) {
+      return "";
+    } else {
+      delay(10);
+    }
+  }
+
+  String body = "";
+  if (headers.indexOf("Transfer-Encoding: chunked") != -1 || headers.indexOf("transfer-encoding: chunked") != -1) {
+    // Chunked: size line in hex, chunk bytes, CRLF — until the zero chunk
+    while (millis() - start < (unsigned long)timeoutMs) {
+      String sizeLine = apiClient.readStringUntil('\n');
+      long chunkSize = strtol(sizeLine.c_str(), nullptr, 16);
+      if (chunkSize <= 0)
+        break;
+      while (chunkSize > 0 && millis() - start < (unsigned long)timeoutMs) {
+        if (apiClient.available()) {
+          body += (char)apiClient.read();
+          chunkSize--;
+        } else if (!apiClient.connected()) {
+          return "";
+        } else {
+          delay(2);
+        }
+      }
+      apiClient.readStringUntil('\n'); // Trailing CRLF after the chunk
+    }
+    apiClient.readStringUntil('\n'); // Final CRLF after the zero chunk
+  } else {
+    int contentLength = -1;
+    int clPos = headers.indexOf("Content-Length:");
+    if (clPos == -1)
+      clPos = headers.indexOf("content-length:");
+    if (clPos != -1)
+      contentLength = headers.substring(clPos + 15).toInt();
+    if (contentLength < 0) {
+      // No framing info — the server will close to delimit the body
+      while (millis() - start < (unsigned long)timeoutMs && (apiClient.connected() || apiClient.available())) {
+        while (apiClient.available())
+          body += (char)apiClient.read();
+        if (!apiClient.connected())
+          break;
+        delay(10);
+      }
+      apiClient.stop();
+      return headers + body;
+    }
+    body.reserve(contentLength);
+    while ((int)body.length() < contentLength) {
+      if (millis() - start >= (unsigned long)timeoutMs)
+        return "";
+      if (apiClient.available()) {
+        body += (char)apiClient.read();
+      } else if (!apiClient.connected()) {
+        return "";
+      } else {
+        delay(2);
+      }
+    }
+  }
+
+  // Honour a server-initiated close; otherwise the socket stays warm
+  if (headers.indexOf("Connection: close") != -1 || headers.indexOf("connection: close") != -1)
+    apiClient.stop();
+  return headers + body;
+}
+
+String StockfishAPI::request(const String& fen, const StockfishSettings& settings) {
+  if (apiMutex == nullptr)
+    apiMutex = xSemaphoreCreateMutex();
+  xSemaphoreTake(apiMutex, portMAX_DELAY);
+
+  String path = buildRequestURL(fen, settings.depth);
+  Serial.println("Stockfish request: " STOCKFISH_API_URL + path);
+  for (int attempt = 1; attempt <= settings.maxRetries; attempt++) {
+    if (attempt > 1)
+      Serial.println("Attempt: " + String(attempt) + "/" + String(settings.maxRetries));
+    bool reused = connectionUsable();
+    if (!reused) {
+      apiClient.stop();
+      // Set insecure mode for SSL (or add proper certificate validation)
+      apiClient.setInsecure();
+      if (!WiFiManagerESP32::connectWithDnsCache(apiClient, STOCKFISH_API_URL, STOCKFISH_API_PORT)) {
+        Serial.println("Connection failed");
+        if (attempt < settings.maxRetries)
+          delay(500);
+        continue;
+      }
+    }
+    apiClient.print("GET " + path + " HTTP/1.1\r\nHost: " STOCKFISH_API_URL "\r\nConnection: keep-alive\r\n\r\n");
+    String response = readHttpResponse(settings.timeoutMs);
+    if (response.length() > 0) {
+      lastRequestMs = millis();
+      if (reused)
+        Serial.println("Reused TLS connection (no handshake)");
+      xSemaphoreGive(apiMutex);
+      return response;
+    }
+    // A reused socket may have been closed server-side since the last
+    // request — an occasional failure here is expected. Reconnect fresh.
+    apiClient.stop();
+    Serial.println("API request timeout or empty response");
+    if (attempt < settings.maxRetries) {
+      Serial.println("Retrying...");
+      delay(500);
+    }
+  }
+
+  Serial.println("All API request attempts failed");
+  xSemaphoreGive(apiMutex);
+  return "";
+}
 
 bool StockfishAPI::parseResponse(const String& response, StockfishResponse& stockfishResp) {
   if (response.length() == 0) {
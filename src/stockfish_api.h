@@ -1,6 +1,7 @@
 #ifndef STOCKFISH_API_H
 #define STOCKFISH_API_H
 
+#include "stockfish_settings.h"
 #include <ArduinoJson.h>
 
 // Stockfish API Endpoint
@@ -28,6 +29,14 @@ class StockfishAPI {
 
   // Build the API request URL
   static String buildRequestURL(const String& fen, int depth);
+
+  // Perform the GET over the shared keep-alive TLS connection, with retries.
+  // Callers from any task are serialized internally. Returns the raw HTTP
+  // response (headers + body) or "" after all attempts failed.
+  static String request(const String& fen, const StockfishSettings& settings);
+
+  // Drop the persistent connection (e.g. after WiFi loss)
+  static void closeConnection();
 };
 
 #endif // STOCKFISH_API_H
@@ -0,0 +1,76 @@
+#include "stockfish_cache.h"
+#include <LittleFS.h>
+#include <string.h>
+
+StockfishCache::StockfishCache() : nextVictim(0), begun(false) {
+  memset(entries, 0, sizeof(entries));
+}
+
+void StockfishCache::begin() {
+  if (begun)
+    return;
+  begun = true;
+
+  File f = LittleFS.open(STOCKFISH_CACHE_PATH, "r");
+  if (!f)
+    return;
+  size_t loaded = f.read((uint8_t*)entries, sizeof(entries)) / sizeof(Entry);
+  f.close();
+  // Resume ring replacement after the loaded entries
+  nextVictim = 0;
+  for (int i = 0; i < STOCKFISH_CACHE_SIZE; i++)
+    if (entries[i].depth == 0) {
+      nextVictim = i;
+      break;
+    }
+  Serial.printf("Stockfish cache: loaded %u persisted entries\n", (unsigned)loaded);
+}
+
+bool StockfishCache::lookup(uint64_t key, int depth, String& bestMove, float& evaluation) {
+  for (int i = 0; i < STOCKFISH_CACHE_SIZE; i++) {
+    if (entries[i].depth != 0 && entries[i].key == key && (int)entries[i].depth >= depth) {
+      bestMove = entries[i].bestMove;
+      evaluation = entries[i].evaluation;
+      return true;
+    }
+  }
+  return false;
+}
+
+void StockfishCache::store(uint64_t key, int depth, const String& bestMove, float evaluation) {
+  if (bestMove.length() == 0 || bestMove.length() >= sizeof(entries[0].bestMove))
+    return;
+
+  // Reuse the slot if the position is already cached (deeper result wins)
+  Entry* slot = nullptr;
+  for (int i = 0; i < STOCKFISH_CACHE_SIZE; i++) {
+    if (entries[i].depth != 0 && entries[i].key == key) {
+      if ((int)entries[i].depth > depth)
+        return;
+      slot = &entries[i];
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    slot = &entries[nextVictim];
+    nextVictim = (nextVictim + 1) % STOCKFISH_CACHE_SIZE;
+  }
+
+  slot->key = key;
+  slot->depth = (uint8_t)(depth > 0 ? depth : 1);
+  slot->evaluation = evaluation;
+  strncpy(slot->bestMove, bestMove.c_str(), sizeof(slot->bestMove) - 1);
+  slot->bestMove[sizeof(slot->bestMove) - 1] = '\0';
+
+  persist();
+}
+
+void StockfishCache::persist() {
+  // Whole-array rewrite: 32 entries is well under one flash page, and
+  // stores happen at most once per bot move
+  File f = LittleFS.open(STOCKFISH_CACHE_PATH, "w");
+  if (!f)
+    return;
+  f.write((const uint8_t*)entries, sizeof(entries));
+  f.close();
+}
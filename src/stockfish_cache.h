@@ -0,0 +1,48 @@
+#ifndef STOCKFISH_CACHE_H
+#define STOCKFISH_CACHE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// ---------------------------
+// Stockfish response cache
+// ---------------------------
+// Small RAM cache of API results keyed by (Zobrist hash, depth), consulted
+// before any network request. Positions repeat — board-editor takebacks,
+// replayIntoGame resumes, players shuffling pieces back — and re-querying
+// the API for a position already analysed at the same depth wastes a full
+// TLS round trip. The cache is persisted to LittleFS on every store so a
+// resumed game finds the position it left off in already answered.
+
+#define STOCKFISH_CACHE_SIZE 32
+#define STOCKFISH_CACHE_PATH "/sfcache.bin"
+
+class StockfishCache {
+ public:
+  StockfishCache();
+
+  // Load persisted entries from LittleFS (idempotent)
+  void begin();
+
+  // Hit when the position was analysed at `depth` or deeper
+  bool lookup(uint64_t key, int depth, String& bestMove, float& evaluation);
+
+  // Insert (ring replacement of the oldest entry) and persist
+  void store(uint64_t key, int depth, const String& bestMove, float evaluation);
+
+ private:
+  struct Entry {
+    uint64_t key;
+    float evaluation;
+    uint8_t depth; // 0 = slot empty
+    char bestMove[6]; // UCI, NUL-terminated ("e7e8q")
+  };
+
+  Entry entries[STOCKFISH_CACHE_SIZE];
+  int nextVictim; // Ring index for replacement
+  bool begun;
+
+  void persist();
+};
+
+#endif // STOCKFISH_CACHE_H
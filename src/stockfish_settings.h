@@ -20,6 +20,7 @@ struct StockfishSettings {
 struct BotConfig {
   StockfishSettings stockfishSettings;
   bool playerIsWhite;
+  bool useLocalEngine; // Skip the Stockfish API and use the on-device search
 };
 
 #endif // STOCKFISH_SETTINGS_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "sys_diag.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define SYS_DIAG_LOG_INTERVAL_MS 60000
+// More tasks than the firmware plus the Arduino/WiFi stack ever run
+#define SYS_DIAG_MAX_TASKS 24
+
+namespace SysDiag {
+
+static void fillHeap(JsonDocument& doc) {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  JsonObject heap = doc["heap"].to<JsonObject>();
+  heap["free"] = freeHeap;
+  heap["min_free_ever"] = esp_get_minimum_free_heap_size();
+  heap["largest_block"] = largest;
+  // 0 = one contiguous region, 100 = hopelessly shattered. The number that
+  // matters for the multi-day crashes: free can stay high while this climbs
+  heap["fragmentation_pct"] = (freeHeap > 0) ? (uint8_t)(100 - (uint64_t)largest * 100 / freeHeap) : 0;
+  if (psramFound()) {
+    heap["psram_free"] = ESP.getFreePsram();
+    heap["psram_largest_block"] = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+  }
+  doc["uptime_s"] = (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+static void fillTasks(JsonDocument& doc) {
+  JsonArray tasks = doc["tasks"].to<JsonArray>();
+#if configUSE_TRACE_FACILITY
+  TaskStatus_t status[SYS_DIAG_MAX_TASKS];
+  uint32_t totalRunTime = 0;
+  UBaseType_t n = uxTaskGetSystemState(status, SYS_DIAG_MAX_TASKS, &totalRunTime);
+  for (UBaseType_t i = 0; i < n; i++) {
+    JsonObject t = tasks.add<JsonObject>();
+    t["name"] = status[i].pcTaskName;
+    t["prio"] = (int)status[i].uxCurrentPriority;
+    // Closest the stack ever came to overflow, in bytes
+    t["stack_free_min"] = (uint32_t)status[i].usStackHighWaterMark;
+#if configGENERATE_RUN_TIME_STATS
+    if (totalRunTime > 0)
+      t["cpu_pct"] = (uint8_t)((uint64_t)status[i].ulRunTimeCounter * 100 / totalRunTime);
+#else
+    (void)totalRunTime;
+#endif
+  }
+#endif
+}
+
+void fillJSON(JsonDocument& doc) {
+  fillHeap(doc);
+  fillTasks(doc);
+}
+
+void logIfDue() {
+  static unsigned long lastLogMs = 0;
+  unsigned long now = millis();
+  if (lastLogMs != 0 && now - lastLogMs < SYS_DIAG_LOG_INTERVAL_MS)
+    return;
+  lastLogMs = now;
+  Serial.printf("SysDiag: heap free=%u min=%u largest=%u psram=%u uptime=%us\n",
+                (unsigned)ESP.getFreeHeap(),
+                (unsigned)esp_get_minimum_free_heap_size(),
+                (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+                psramFound() ? (unsigned)ESP.getFreePsram() : 0,
+                (unsigned)(esp_timer_get_time() / 1000000));
+}
+
+} // namespace SysDiag
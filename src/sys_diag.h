@@ -0,0 +1,31 @@
+#ifndef SYS_DIAG_H
+#define SYS_DIAG_H
+
+#include <ArduinoJson.h>
+
+// ---------------------------
+// System diagnostics
+// ---------------------------
+// Heap, fragmentation and task health for boards that reboot after days in
+// the field: free heap, minimum-ever free heap, largest allocatable block
+// (free vs largest tells exhaustion apart from fragmentation), and per-task
+// stack high-water marks. CPU share per task comes from the FreeRTOS
+// runtime-stats counters when the core is built with
+// CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS; the stock Arduino core is not,
+// so the field is omitted there rather than reported as zero.
+//
+// Published in the /perf endpoint's JSON and logged at interval from the
+// app loop, so a crash report comes with the numbers leading up to it.
+
+namespace SysDiag {
+
+// Add "heap" and "tasks" sections to `doc`
+void fillJSON(JsonDocument& doc);
+
+// One-line heap summary over serial, rate-limited to once per minute;
+// call from a loop that always runs
+void logIfDue();
+
+} // namespace SysDiag
+
+#endif // SYS_DIAG_H
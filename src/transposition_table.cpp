@@ -0,0 +1,129 @@
+#include "transposition_table.h"
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+// The lock-free scheme folds everything after the key into one 64-bit
+// payload word for the XOR checksum; the layout must keep it that way
+static_assert(sizeof(TTEntry) - offsetof(TTEntry, score) == sizeof(uint64_t), "TTEntry payload must be exactly 8 bytes");
+
+static inline uint64_t entryPayload(const TTEntry& e) {
+  uint64_t d;
+  memcpy(&d, (const uint8_t*)&e + offsetof(TTEntry, score), sizeof(d));
+  return d;
+}
+
+TranspositionTable::TranspositionTable() : table(nullptr), entryCount(0), generation(0), hits(0), misses(0), stores(0), replacements(0) {}
+
+bool TranspositionTable::begin(size_t byteBudget) {
+  if (table != nullptr)
+    return true; // Already allocated
+
+#ifdef ESP_PLATFORM
+  // Prefer PSRAM when the board has it; internal RAM is precious. On
+  // internal heap, never take more than half the largest free block so the
+  // networking stack and LittleFS keep working.
+  size_t budget = byteBudget;
+  bool usePsram = psramFound();
+  if (!usePsram) {
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    if (budget > largest / 2)
+      budget = largest / 2;
+  }
+#else
+  size_t budget = byteBudget;
+  bool usePsram = false;
+#endif
+
+  // Round entry count down to a power of 2 for mask indexing
+  size_t entries = budget / sizeof(TTEntry);
+  size_t pow2 = 1;
+  while (pow2 * 2 <= entries)
+    pow2 *= 2;
+  if (pow2 < 256)
+    return false; // Not worth running with a tiny table
+
+#ifdef ESP_PLATFORM
+  table = (TTEntry*)heap_caps_malloc(pow2 * sizeof(TTEntry), usePsram ? MALLOC_CAP_SPIRAM : MALLOC_CAP_8BIT);
+  if (table == nullptr && usePsram) {
+    // PSRAM allocation failed; retry from internal heap with the clamp
+    usePsram = false;
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    while (pow2 > 256 && pow2 * sizeof(TTEntry) > largest / 2)
+      pow2 /= 2;
+    table = (TTEntry*)heap_caps_malloc(pow2 * sizeof(TTEntry), MALLOC_CAP_8BIT);
+  }
+#else
+  table = (TTEntry*)malloc(pow2 * sizeof(TTEntry));
+#endif
+  if (table == nullptr)
+    return false;
+
+  entryCount = pow2;
+  clear();
+  Serial.printf("Transposition table: %u entries (%u KB, %s)\n", (unsigned)entryCount, (unsigned)(entryCount * sizeof(TTEntry) / 1024), usePsram ? "PSRAM" : "internal RAM");
+  return true;
+}
+
+void TranspositionTable::clear() {
+  if (table == nullptr)
+    return;
+  memset(table, 0, entryCount * sizeof(TTEntry));
+  generation = 0;
+  hits = misses = stores = replacements = 0;
+}
+
+void TranspositionTable::newSearch() {
+  generation = (generation + 1) & 0x3F; // 6 bits; bound uses the low 2
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) {
+  if (entryCount == 0)
+    return false;
+  // Copy the slot once; a store racing from the other worker can tear the
+  // copy, in which case the XOR checksum fails and this is a clean miss
+  TTEntry e = table[key & (entryCount - 1)];
+  if (e.depth != 0 && (e.key ^ entryPayload(e)) == key) {
+    out = e;
+    out.key = key;
+    out.bound &= 0x03; // Strip the generation bits for the caller
+    hits++;
+    return true;
+  }
+  misses++;
+  return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int16_t score, uint8_t bound, const EngineMove& move) {
+  if (entryCount == 0)
+    return;
+  TTEntry& slot = table[key & (entryCount - 1)];
+  // Snapshot for the replacement decision; a torn read here can at worst
+  // misjudge the heuristic, never corrupt what gets written
+  TTEntry cur = slot;
+  uint64_t curKey = cur.key ^ entryPayload(cur);
+  // Depth-preferred within the current generation: keep deeper results for
+  // the same search, but always evict entries from earlier searches
+  bool sameGeneration = (cur.bound >> 2) == generation;
+  if (cur.depth != 0 && curKey != key && sameGeneration && (int)cur.depth > depth)
+    return;
+  if (cur.depth != 0 && curKey != key)
+    replacements++;
+  TTEntry e;
+  e.score = score;
+  e.depth = (uint8_t)(depth > 0 ? depth : 1);
+  e.bound = (uint8_t)((generation << 2) | (bound & 0x03));
+  e.move = move;
+  e.key = key ^ entryPayload(e);
+  slot = e;
+  stores++;
+}
+
+void TranspositionTable::printStats() const {
+  uint32_t probes = hits + misses;
+  Serial.printf("TT stats: %u hits / %u probes (%.1f%%), %u stores, %u replacements\n", hits, probes, probes > 0 ? (100.0f * hits) / probes : 0.0f, stores, replacements);
+}
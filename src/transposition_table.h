@@ -0,0 +1,72 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include "chess_engine.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ---------------------------
+// Transposition table
+// ---------------------------
+// Zobrist-keyed cache of search results so the on-device engine doesn't
+// re-expand positions it has already analysed. Sized from a byte budget at
+// begin() time: the budget is clamped against the largest free heap block,
+// and the table is placed in PSRAM when a WROVER-style board has it.
+// Replacement is depth-preferred within the current search generation;
+// entries from older searches are always replaceable.
+//
+// Probe and store are lock-free: the two root-search workers hit the table
+// from both cores, and a mutex here would serialise the hottest read in the
+// whole search. Instead the stored key is XORed with the entry's 8-byte
+// payload, so a probe that races a store reads a torn entry whose checksum
+// fails and is treated as a miss — never as a wrong score.
+
+// Default budget; ChessBot passes this unless configured otherwise
+#define TT_DEFAULT_BUDGET (64 * 1024)
+
+// Bound type of a stored score
+#define TT_BOUND_EXACT 0
+#define TT_BOUND_LOWER 1 // Score is a lower bound (fail-high / beta cutoff)
+#define TT_BOUND_UPPER 2 // Score is an upper bound (fail-low)
+
+struct TTEntry {
+  uint64_t key;      // In the table: Zobrist key XOR payload word (see above)
+  int16_t score;     // Centipawns, mate scores ply-adjusted by the search
+  uint8_t depth;     // Remaining depth the score was computed with
+  uint8_t bound;     // TT_BOUND_* in the low bits, generation in the high bits
+  EngineMove move;   // Best/refutation move for ordering
+};
+
+class TranspositionTable {
+ public:
+  TranspositionTable();
+
+  // Allocate the table (idempotent). Returns false if no memory could be
+  // obtained; the search then simply runs without a TT.
+  bool begin(size_t byteBudget = TT_DEFAULT_BUDGET);
+
+  // Wipe all entries (new game)
+  void clear();
+
+  // Advance the search generation (call once per findBestMove) so stale
+  // entries become preferred replacement victims
+  void newSearch();
+
+  bool probe(uint64_t key, TTEntry& out);
+  void store(uint64_t key, int depth, int16_t score, uint8_t bound, const EngineMove& move);
+
+  // Hit/miss counters, printed over serial by the bot after each search.
+  // Bumped without locking, so concurrent workers may drop the odd
+  // increment — they are diagnostics, not bookkeeping.
+  void printStats() const;
+  uint32_t getHits() const { return hits; }
+  uint32_t getMisses() const { return misses; }
+
+ private:
+  TTEntry* table;
+  size_t entryCount; // Power of 2 (0 = not allocated)
+  uint8_t generation;
+  uint32_t hits, misses, stores, replacements;
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -1,103 +1,199 @@
 #include "ui_comm.h"
+#include "perf_stats.h"
 
 static HardwareSerial UI_SERIAL(2);
-static String recvLine = "";
 static ui_touch_handler_t touchHandler = nullptr;
 
+// RX frame accumulator: bytes up to the next 0x00 delimiter
+static uint8_t rxBuf[UIP_MAX_ENCODED];
+static size_t rxLen = 0;
+
+// Board image as last pushed to the slave, for computing square deltas
+// (piece chars, 0 = empty, row 0 = rank 8)
+static char lastBoard[8][8];
+static bool haveLastBoard = false;
+// Slave asked for a full board (boot, or it dropped a corrupt frame).
+// Set on the UART event task, consumed by the sender — hence volatile
+static volatile bool resyncRequested = false;
+
 namespace UIComm {
 
+static void onUartRx();
+
 void begin(int baud, int rxPin, int txPin) {
+  // A full STATE frame is ~70 bytes; 1 KB of ring buffer rides out the
+  // longest main-loop stall (bot thinking, flash writes) without overrun
+  UI_SERIAL.setRxBufferSize(1024);
   UI_SERIAL.begin(baud, SERIAL_8N1, rxPin, txPin);
+  // Event-driven RX: the UART interrupt fills the ring buffer and wakes the
+  // core's serial event task, which calls onUartRx with data pending
+  UI_SERIAL.onReceive(onUartRx);
+}
+
+void setTouchHandler(ui_touch_handler_t h) {
+  touchHandler = h;
 }
 
-static void callTouchHandler(const String& action, int x, int y) {
-  if (touchHandler) {
-    touchHandler(action.c_str(), x, y);
+bool resyncPending() {
+  return resyncRequested;
+}
+
+static void sendFrame(uint8_t type, const uint8_t* body, size_t bodyLen) {
+  uint8_t frame[UIP_MAX_ENCODED + 1];
+  size_t n = uip_build_frame(type, body, bodyLen, frame);
+  UI_SERIAL.write(frame, n);
+}
+
+// Parse the board field of a FEN into piece chars (0 = empty square)
+static void parseFenBoard(const char* fen, char board[8][8]) {
+  memset(board, 0, 64);
+  int r = 0, c = 0;
+  for (const char* p = fen; *p != '\0' && *p != ' ' && r < 8; p++) {
+    char ch = *p;
+    if (ch == '/') {
+      r++;
+      c = 0;
+    } else if (ch >= '1' && ch <= '8') {
+      c += ch - '0';
+    } else if (c < 8) {
+      board[r][c++] = ch;
+    }
   }
 }
 
-static String getValueForKey(const String& payload, const String& key) {
-  int idx = payload.indexOf(key + "=");
-  if (idx < 0) return String();
-  idx += key.length() + 1;
-  int end = payload.indexOf(';', idx);
-  if (end < 0) end = payload.length();
-  return payload.substring(idx, end);
+// Parse a UCI move ("e2e4", "e7e8q") into square indices and promo char
+static void parseUciMove(const char* uci, uint8_t& from, uint8_t& to, uint8_t& promo) {
+  from = to = UIP_SQ_NONE;
+  promo = 0;
+  size_t len = strlen(uci);
+  if (len < 4) return;
+  char ff = uci[0], fr = uci[1], tf = uci[2], tr = uci[3];
+  if (ff < 'a' || ff > 'h' || tf < 'a' || tf > 'h') return;
+  if (fr < '1' || fr > '8' || tr < '1' || tr > '8') return;
+  from = (8 - (fr - '0')) * 8 + (ff - 'a');
+  to = (8 - (tr - '0')) * 8 + (tf - 'a');
+  if (len >= 5) promo = (uint8_t)uci[4];
 }
 
-static void parseLine(const String& line) {
-  if (line.length() == 0) return;
-  int sep = line.indexOf('|');
-  String type = (sep > 0) ? line.substring(0, sep) : line;
-  String payload = (sep > 0) ? line.substring(sep + 1) : String();
-  type.trim();
-  payload.trim();
-  if (type == "TOUCH") {
-    String action = getValueForKey(payload, "action");
-    int x = -1, y = -1;
-    if (action == "board") {
-      // Board cell touches send row= and col= instead of x/y
-      String rs = getValueForKey(payload, "row");
-      String cs = getValueForKey(payload, "col");
-      x = rs.length() ? rs.toInt() : -1; // row
-      y = cs.length() ? cs.toInt() : -1; // col
-    } else if (action == "mode") {
-      // Mode selection sends value=N
-      String vs = getValueForKey(payload, "value");
-      x = vs.length() ? vs.toInt() : -1;
-    } else {
-      String xs = getValueForKey(payload, "x");
-      String ys = getValueForKey(payload, "y");
-      x = xs.length() ? xs.toInt() : -1;
-      y = ys.length() ? ys.toInt() : -1;
+static void handleFrame(const uint8_t* payload, size_t len) {
+  switch (payload[0]) {
+    case UIP_MSG_TOUCH: {
+      if (len < 4) return;
+      // Action codes map back to the strings the touch handler has always seen
+      static const char* ACTIONS[] = {"board", "mode", "hint", "undo", "home", "new", "resign", "swap", "nextgame"};
+      uint8_t action = payload[1];
+      if (action >= sizeof(ACTIONS) / sizeof(ACTIONS[0])) return;
+      int x = 0, y = 0;
+      if (action == UIP_TOUCH_BOARD) {
+        x = payload[2]; // row
+        y = payload[3]; // col
+      } else if (action == UIP_TOUCH_MODE) {
+        x = payload[2]; // selected mode
+        y = -1;
+      }
+      if (touchHandler) touchHandler(ACTIONS[action], x, y);
+      break;
     }
-    callTouchHandler(action, x, y);
-  } else if (type == "CMD") {
-    // Generic command from UI (log for now)
-    Serial.printf("UI CMD: %s\n", payload.c_str());
-  } else {
-    Serial.printf("Unknown UI msg: %s\n", line.c_str());
+    case UIP_MSG_RESYNC:
+      // Next state push goes out as a full board
+      resyncRequested = true;
+      break;
+    default:
+      Serial.printf("UIComm: unknown frame type 0x%02x\n", payload[0]);
+      break;
   }
 }
 
-void loop() {
+// Runs on the UART event task whenever received bytes are pending
+static void onUartRx() {
   while (UI_SERIAL.available()) {
-    char c = (char)UI_SERIAL.read();
-    if (c == '\r') continue;
-    if (c == '\n') {
-      parseLine(recvLine);
-      recvLine = "";
+    uint8_t b = (uint8_t)UI_SERIAL.read();
+    if (b == 0) {
+      if (rxLen > 0) {
+        uint8_t payload[UIP_MAX_ENCODED];
+        size_t n = uip_parse_frame(rxBuf, rxLen, payload);
+        if (n > 0)
+          handleFrame(payload, n);
+        else
+          Serial.println("UIComm: dropped corrupt frame");
+        rxLen = 0;
+      }
+    } else if (rxLen < sizeof(rxBuf)) {
+      rxBuf[rxLen++] = b;
     } else {
-      recvLine += c;
-      if (recvLine.length() > 1024) recvLine.remove(0, recvLine.length() - 1024);
+      rxLen = 0; // Oversized garbage — resync on the next delimiter
     }
   }
 }
 
-void setTouchHandler(ui_touch_handler_t h) {
-  touchHandler = h;
-}
-
 // Outgoing
-void sendSimple(const String& msg) {
-  UI_SERIAL.print(msg);
-  UI_SERIAL.print('\n');
-}
+void sendStateUpdate(const char* fen, const char* lastMove) {
+  PERF_SCOPE(PERF_UI_STATE_PUSH);
+  char board[8][8];
+  parseFenBoard(fen, board);
+
+  uint8_t from, to, promo;
+  parseUciMove(lastMove, from, to, promo);
 
-void sendStateUpdate(const String& fen, const String& lastMove) {
-  String payload = "STATE|fen=" + fen;
-  if (lastMove.length() > 0)
-    payload += ";move=" + lastMove;
-  sendSimple(payload);
+  uint8_t body[UIP_MAX_PAYLOAD - 3];
+  if (haveLastBoard && !resyncRequested) {
+    // Delta frame: only the squares that changed since the last push. A
+    // typical move touches 2–4 squares, so the frame is a few bytes instead
+    // of the full board. Past 31 squares a full frame is smaller anyway.
+    size_t n = 1;
+    int changed = 0;
+    for (int r = 0; r < 8 && changed >= 0; r++) {
+      for (int c = 0; c < 8; c++) {
+        if (board[r][c] == lastBoard[r][c]) continue;
+        if (changed == 31) {
+          changed = -1; // Too many — fall through to a full frame
+          break;
+        }
+        body[n++] = (uint8_t)(r * 8 + c);
+        body[n++] = (uint8_t)board[r][c];
+        changed++;
+      }
+    }
+    if (changed >= 0) {
+      body[0] = (uint8_t)changed;
+      body[n++] = from;
+      body[n++] = to;
+      body[n++] = promo;
+      sendFrame(UIP_MSG_STATE_DELTA, body, n);
+      memcpy(lastBoard, board, 64);
+      return;
+    }
+  }
+
+  size_t n = 0;
+  for (int r = 0; r < 8; r++)
+    for (int c = 0; c < 8; c++)
+      body[n++] = (uint8_t)board[r][c];
+  body[n++] = from;
+  body[n++] = to;
+  body[n++] = promo;
+  sendFrame(UIP_MSG_STATE_FULL, body, n);
+  memcpy(lastBoard, board, 64);
+  haveLastBoard = true;
+  resyncRequested = false;
 }
 
-void sendHintResponse(const String& san) {
-  String payload = "HINT|move=" + san;
-  sendSimple(payload);
+void sendHintResponse(const String& uci) {
+  uint8_t from, to, promo;
+  parseUciMove(uci.c_str(), from, to, promo);
+  if (from == UIP_SQ_NONE) return;
+  uint8_t body[2] = {from, to};
+  sendFrame(UIP_MSG_HINT, body, sizeof(body));
 }
 
 void sendMode(int mode) {
-  sendSimple("MODE|value=" + String(mode));
+  uint8_t body[1] = {(uint8_t)mode};
+  sendFrame(UIP_MSG_MODE, body, sizeof(body));
+}
+
+void sendError(uint8_t code) {
+  uint8_t body[1] = {code};
+  sendFrame(UIP_MSG_ERROR, body, sizeof(body));
 }
 
 } // namespace UIComm
@@ -1,20 +1,31 @@
 #pragma once
 
+#include "ui_protocol.h"
 #include <Arduino.h>
 
-// Simple UI communication over UART with a secondary ESP32 running LVGL.
-// Line-based messages: <TYPE>|key1=val1;key2=val2\n
+// UI communication over UART with a secondary ESP32 running LVGL.
+// Messages are COBS-framed, CRC-checked binary frames (see ui_protocol.h);
+// state pushes carry only the squares that changed since the last push,
+// with a full-board frame sent on request or after a resync.
+//
+// RX is event-driven: the UART driver's interrupt fills its ring buffer and
+// wakes the core's serial event task, which parses frames and dispatches
+// them as they complete. The touch handler therefore runs on that task, not
+// the main loop — keep it to flag-setting (which is all main.cpp's does).
 
 typedef void (*ui_touch_handler_t)(const char* action, int x, int y);
 
 namespace UIComm {
-void begin(int baud = 115200, int rxPin = 16, int txPin = 17);
-void loop();
+void begin(int baud = 921600, int rxPin = 16, int txPin = 17);
 void setTouchHandler(ui_touch_handler_t h);
 
-// Outgoing messages
-void sendStateUpdate(const String& fen, const String& lastMove);
-void sendHintResponse(const String& san);
+// True when the slave has asked for a full-board frame (boot, or it
+// dropped a corrupt frame) that no sendStateUpdate has answered yet
+bool resyncPending();
+
+// Outgoing messages (char* FEN so per-move state pushes stay heap-free)
+void sendStateUpdate(const char* fen, const char* lastMove);
+void sendHintResponse(const String& uci);
 void sendMode(int mode);
-void sendSimple(const String& msg);
+void sendError(uint8_t code);
 } // namespace UIComm
@@ -17,6 +17,7 @@ Import("env")
 
 BUILD_DIR = Path("src/web/build")
 DATA_DIR = Path("data")
+BOOK_DIR = Path("src/book")
 
 SUPPORTED_EXTENSIONS = {".html", ".css", ".js", ".svg", ".mp3"}
 
@@ -69,6 +70,12 @@ def prepare():
         elif entry.is_file():
             entry.unlink()
 
+    # Opening book (binary, already compact — no gzip)
+    if BOOK_DIR.exists():
+        for f in sorted(BOOK_DIR.glob("*.bin")):
+            shutil.copy(f, DATA_DIR / f.name)
+            count += 1
+
     print(f"LittleFS: Prepared {count} web assets in data/")
 
 
@@ -1,47 +1,124 @@
 #include "wifi_manager_esp32.h"
+#include "boot_profile.h"
+#include "chess_engine.h"
 #include "chess_lichess.h"
 #include "chess_utils.h"
+#include "core_layout.h"
 #include "move_history.h"
+#include "perf_stats.h"
+#include "settings_cache.h"
+#include "stockfish_api.h"
+#include "sys_diag.h"
 #include "version.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <Preferences.h>
 #include <Update.h>
+#include <WiFiClientSecure.h>
+#include <memory>
 
 static const char* INITIAL_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-WiFiManagerESP32::WiFiManagerESP32(BoardDriver* bd, MoveHistory* mh) : boardDriver(bd), moveHistory(mh), server(AP_PORT), wifiSSID(SECRET_SSID), wifiPassword(SECRET_PASS), gameMode("0"), lichessToken(""), botConfig(), scanAllChannels(WIFI_SCAN_ALL_CHANNELS), currentFen(INITIAL_FEN), hasPendingEdit(false), hasPendingResign(false), hasPendingDraw(false), pendingResignColor('?'), promotion{}, lastBoardPollTime(0), hasPendingWiFi(false), boardEvaluation(0.0f), otaUpdater(bd), autoOtaEnabled(false) {
+// ---------------------------
+// RAM-resident web asset cache
+// ---------------------------
+// The hottest pre-gzipped assets are read from LittleFS once at startup
+// (into PSRAM when available, heap otherwise) so warm page loads stream from
+// RAM instead of the filesystem read path. Responses carry an ETag keyed to
+// the firmware version: a client that already has the asset pays one
+// conditional request and gets a 304 until the next firmware update.
+namespace {
+
+struct CachedAsset {
+  const char* url;
+  const char* fsPath; // Pre-gzipped source on LittleFS
+  const char* contentType;
+  uint8_t* data;
+  size_t length;
+};
+
+CachedAsset assetCache[] = {
+    {"/", "/index.html.gz", "text/html", nullptr, 0},
+    {"/index.html", "/index.html.gz", "text/html", nullptr, 0},
+    {"/board.html", "/board.html.gz", "text/html", nullptr, 0},
+    {"/game.html", "/game.html.gz", "text/html", nullptr, 0},
+    {"/favicon.svg", "/favicon.svg.gz", "image/svg+xml", nullptr, 0},
+    {"/css/styles.css", "/css/styles.css.gz", "text/css", nullptr, 0},
+    {"/css/chessboard-1.0.0.min.css", "/css/chessboard-1.0.0.min.css.gz", "text/css", nullptr, 0},
+    {"/scripts/chess.js", "/scripts/chess.js.gz", "application/javascript", nullptr, 0},
+    {"/scripts/chessboard-1.0.0.min.js", "/scripts/chessboard-1.0.0.min.js.gz", "application/javascript", nullptr, 0},
+    {"/scripts/jquery-4.0.0.min.js", "/scripts/jquery-4.0.0.min.js.gz", "application/javascript", nullptr, 0},
+};
+
+void loadAssetCache() {
+  size_t total = 0;
+  for (auto& asset : assetCache) {
+    if (asset.data) {
+      // Reload path (after a web-assets OTA): drop the stale copy
+      free(asset.data);
+      asset.data = nullptr;
+      asset.length = 0;
+    }
+    File f = LittleFS.open(asset.fsPath, "r");
+    if (!f) continue;
+    size_t len = f.size();
+    uint8_t* buf = psramFound() ? (uint8_t*)ps_malloc(len) : (uint8_t*)malloc(len);
+    if (buf && f.read(buf, len) == len) {
+      asset.data = buf;
+      asset.length = len;
+      total += len;
+    } else {
+      free(buf); // Allocation or read failed — serveStatic covers this file
+    }
+    f.close();
+  }
+  Serial.printf("Web asset cache: %u bytes resident in %s\n", (unsigned)total, psramFound() ? "PSRAM" : "heap");
+}
+
+void serveCachedAsset(AsyncWebServerRequest* request, const CachedAsset& asset) {
+  if (!asset.data) {
+    // Cache reload failed for this file — stream it from LittleFS
+    request->send(LittleFS, asset.fsPath, asset.contentType);
+    return;
+  }
+  if (request->header("If-None-Match") == "\"" FIRMWARE_VERSION "\"") {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", "\"" FIRMWARE_VERSION "\"");
+    request->send(response);
+    return;
+  }
+  AsyncWebServerResponse* response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+  response->addHeader("Content-Encoding", "gzip");
+  // Cached but revalidated: the ETag changes with the firmware version, so
+  // updated pages are picked up right after an OTA
+  response->addHeader("Cache-Control", "no-cache");
+  response->addHeader("ETag", "\"" FIRMWARE_VERSION "\"");
+  request->send(response);
+}
+
+} // namespace
+
+WiFiManagerESP32::WiFiManagerESP32(BoardDriver* bd, MoveHistory* mh) : boardDriver(bd), moveHistory(mh), server(AP_PORT), ws("/ws"), lastWsCleanup(0), wifiSSID(SECRET_SSID), wifiPassword(SECRET_PASS), gameMode("0"), lichessToken(""), botConfig(), scanAllChannels(WIFI_SCAN_ALL_CHANNELS), currentFen(INITIAL_FEN), hasPendingEdit(false), hasPendingResign(false), hasPendingDraw(false), pendingResignColor('?'), lichessGamesJSON("[]"), hasPendingLichessSwitch(false), promotion{}, lastBoardPollTime(0), hasPendingWiFi(false), boardEvaluation(0.0f), otaUpdater(bd), autoOtaEnabled(false) {
   promotion.reset();
 }
 
 void WiFiManagerESP32::begin() {
   Serial.println("=== Starting OpenChess WiFi Manager (ESP32) ===");
 
-  if (!ChessUtils::ensureNvsInitialized()) {
-    Serial.println("NVS init failed - WiFi credentials not loaded");
-  } else {
-    prefs.begin("wifiCreds", false);
-    if (prefs.isKey("ssid")) {
-      wifiSSID = prefs.getString("ssid", SECRET_SSID);
-      wifiPassword = prefs.getString("pass", SECRET_PASS);
+  // All settings come out of the RAM cache loaded once in setup()
+  {
+    WifiCredsNV creds = SettingsCache::getWifi();
+    if (creds.valid) {
+      wifiSSID = creds.ssid;
+      wifiPassword = creds.pass;
     }
-    scanAllChannels = prefs.getBool("scanAll", WIFI_SCAN_ALL_CHANNELS);
-    prefs.end();
+    scanAllChannels = creds.scanAllValid ? creds.scanAll : WIFI_SCAN_ALL_CHANNELS;
 
-    // Load Lichess token
-    prefs.begin("lichess", false);
-    if (prefs.isKey("token")) {
-      lichessToken = prefs.getString("token", "");
-    }
-    prefs.end();
+    lichessToken = SettingsCache::getLichessToken();
     if (lichessToken.length() > 0) {
       Serial.println("Lichess API token loaded from NVS");
     }
 
-    // Load OTA auto-update preference
-    prefs.begin("ota", false);
-    autoOtaEnabled = prefs.getBool("autoUpdate", false);
-    prefs.end();
+    autoOtaEnabled = SettingsCache::getAutoOta();
   }
   if (!WiFi.softAP(AP_SSID, AP_PASSWORD)) {
     Serial.println("ERROR: Failed to create Access Point!");
@@ -68,21 +145,25 @@ void WiFiManagerESP32::begin() {
   otaUpdater.autoUpdate(lastUpdateInfo, autoOtaEnabled);
 
   // Set up web server routes with async handlers
-  server.on("/board-update", HTTP_GET, [this](AsyncWebServerRequest* request) { request->send(200, "application/json", this->getBoardUpdateJSON()); });
+  server.on("/board-update", HTTP_GET, [this](AsyncWebServerRequest* request) { this->getBoardUpdateJSON(request); });
   server.on("/board-update", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleBoardEditSuccess(request); });
   server.on("/promotion", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handlePromotion(request); });
   server.on("/resign", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleResign(request); });
   server.on("/draw", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleDraw(request); });
-  server.on("/wifi", HTTP_GET, [this](AsyncWebServerRequest* request) { request->send(200, "application/json", this->getWiFiInfoJSON()); });
+  server.on("/wifi", HTTP_GET, [this](AsyncWebServerRequest* request) { this->getWiFiInfoJSON(request); });
   server.on("/wifi", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleConnectWiFi(request); });
   server.on("/gameselect", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleGameSelection(request); });
   server.on("/lichess", HTTP_GET, [this](AsyncWebServerRequest* request) { request->send(200, "application/json", this->getLichessInfoJSON()); });
   server.on("/lichess", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleSaveLichessToken(request); });
-  server.on("/board-settings", HTTP_GET, [this](AsyncWebServerRequest* request) { request->send(200, "application/json", this->getBoardSettingsJSON()); });
+  server.on("/lichess/games", HTTP_GET, [this](AsyncWebServerRequest* request) { request->send(200, "application/json", this->lichessGamesJSON); });
+  server.on("/lichess/switch", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleLichessSwitch(request); });
+  server.on("/board-settings", HTTP_GET, [this](AsyncWebServerRequest* request) { this->getBoardSettingsJSON(request); });
+  server.on("/perf", HTTP_GET, [this](AsyncWebServerRequest* request) { this->getPerfStatsJSON(request); });
   server.on("/board-settings", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleBoardSettings(request); });
   server.on("/board-calibrate", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleBoardCalibration(request); });
   server.on("/games", HTTP_GET, [this](AsyncWebServerRequest* request) { this->handleGamesRequest(request); });
   server.on("/games", HTTP_DELETE, [this](AsyncWebServerRequest* request) { this->handleDeleteGame(request); });
+  server.on("/games/pgn", HTTP_GET, [this](AsyncWebServerRequest* request) { this->handleGamePgnRequest(request); });
   // OTA update endpoints
   server.on("/ota/status", HTTP_GET, [this](AsyncWebServerRequest* request) { this->handleOtaStatus(request); });
   server.on("/ota/settings", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleOtaSettings(request); });
@@ -102,32 +183,75 @@ void WiFiManagerESP32::begin() {
   // Hardware configuration endpoints
   server.on("/hardware-config", HTTP_GET, [this](AsyncWebServerRequest* request) { this->getHardwareConfigJSON(request); });
   server.on("/hardware-config", HTTP_POST, [this](AsyncWebServerRequest* request) { this->handleHardwareConfig(request); });
+  // RAM-cached hot assets; anything that failed to load (or isn't listed)
+  // falls through to the serveStatic mounts below
+  loadAssetCache();
+  for (auto& asset : assetCache) {
+    if (!asset.data) continue;
+    const CachedAsset* a = &asset;
+    server.on(asset.url, HTTP_GET, [a](AsyncWebServerRequest* request) { serveCachedAsset(request, *a); });
+  }
   // Serve sound files directly (no gzip variant exists, avoids .gz probe errors)
-  server.serveStatic("/sounds/", LittleFS, "/sounds/").setTryGzipFirst(false);
+  server.serveStatic("/sounds/", LittleFS, "/sounds/").setTryGzipFirst(false).setCacheControl("max-age=31536000, immutable");
   // Serve piece SVGs with aggressive caching, otherwise chrome doesn't actually use the cached versions
   server.serveStatic("/pieces/", LittleFS, "/pieces/").setCacheControl("max-age=31536000, immutable");
   // Serve all other static files from LittleFS (gzip handled automatically)
   server.serveStatic("/", LittleFS, "/").setDefaultFile("index.html");
   server.onNotFound([](AsyncWebServerRequest* request) { request->send(404, "text/plain", "Not Found"); });
+  // WebSocket push channel: a fresh client gets the current state once, then
+  // only change-driven pushes. Any inbound frame (the page pings every
+  // second) counts as liveness, same as a /board-update poll used to.
+  ws.onEvent([this](AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+      lastBoardPollTime = millis();
+      client->text(buildBoardStateJSON());
+    } else if (type == WS_EVT_DATA || type == WS_EVT_PONG) {
+      lastBoardPollTime = millis();
+    }
+  });
+  server.addHandler(&ws);
   server.begin();
   Serial.println("Web server started on port 80");
 }
 
-String WiFiManagerESP32::getBoardUpdateJSON() {
-  this->lastBoardPollTime = millis();
-  JsonDocument doc;
+void WiFiManagerESP32::fillBoardStateJSON(JsonDocument& doc) {
   doc["fen"] = currentFen;
   doc["evaluation"] = serialized(String(boardEvaluation, 2));
   if (promotion.pending) {
     JsonObject promo = doc["promotion"].to<JsonObject>();
     promo["color"] = String(promotion.color);
   }
+}
+
+String WiFiManagerESP32::buildBoardStateJSON() {
+  JsonDocument doc;
+  fillBoardStateJSON(doc);
   String output;
   serializeJson(doc, output);
   return output;
 }
 
-String WiFiManagerESP32::getWiFiInfoJSON() {
+void WiFiManagerESP32::getBoardUpdateJSON(AsyncWebServerRequest* request) {
+  this->lastBoardPollTime = millis();
+  JsonDocument doc;
+  fillBoardStateJSON(doc);
+  // Serialize straight into the response stream: no intermediate String,
+  // no full payload buffered per request
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  serializeJson(doc, *response);
+  request->send(response);
+}
+
+void WiFiManagerESP32::pushBoardUpdate() {
+  String state = buildBoardStateJSON();
+  if (state == lastPushedState)
+    return; // Nothing changed — don't wake clients
+  lastPushedState = state;
+  if (ws.count() > 0)
+    ws.textAll(state);
+}
+
+void WiFiManagerESP32::getWiFiInfoJSON(AsyncWebServerRequest* request) {
   JsonDocument doc;
   doc["ssid"] = wifiSSID;
   doc["password"] = wifiPassword;
@@ -136,9 +260,9 @@ String WiFiManagerESP32::getWiFiInfoJSON() {
   doc["ap_ip"] = WiFi.softAPIP().toString();
   doc["local_ip"] = (WiFi.status() == WL_CONNECTED) ? WiFi.localIP().toString() : "0.0.0.0";
   doc["scanAllChannels"] = scanAllChannels;
-  String output;
-  serializeJson(doc, output);
-  return output;
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  serializeJson(doc, *response);
+  request->send(response);
 }
 
 void WiFiManagerESP32::handleBoardEditSuccess(AsyncWebServerRequest* request) {
@@ -175,6 +299,17 @@ void WiFiManagerESP32::handleDraw(AsyncWebServerRequest* request) {
   request->send(200, "text/plain", "OK");
 }
 
+void WiFiManagerESP32::handleLichessSwitch(AsyncWebServerRequest* request) {
+  if (!request->hasArg("game")) {
+    request->send(400, "text/plain", "Missing 'game' parameter");
+    return;
+  }
+  pendingLichessSwitchId = request->arg("game");
+  hasPendingLichessSwitch = true;
+  Serial.println("Lichess game switch requested from web: " + pendingLichessSwitchId);
+  request->send(200, "text/plain", "OK");
+}
+
 void WiFiManagerESP32::handleConnectWiFi(AsyncWebServerRequest* request) {
   bool changed = false;
   String newWifiSSID = "";
@@ -187,14 +322,10 @@ void WiFiManagerESP32::handleConnectWiFi(AsyncWebServerRequest* request) {
   if (request->hasArg("scanAllChannels")) {
     bool newScanAll = request->arg("scanAllChannels") == "1";
     if (newScanAll != scanAllChannels) {
-      if (ChessUtils::ensureNvsInitialized()) {
-        prefs.begin("wifiCreds", false);
-        prefs.putBool("scanAll", newScanAll);
-        prefs.end();
-        scanAllChannels = newScanAll;
-        Serial.printf("WiFi scan all channels: %s\n", scanAllChannels ? "enabled" : "disabled");
-        changed = true;
-      }
+      SettingsCache::setScanAll(newScanAll);
+      scanAllChannels = newScanAll;
+      Serial.printf("WiFi scan all channels: %s\n", scanAllChannels ? "enabled" : "disabled");
+      changed = true;
     }
   }
 
@@ -287,15 +418,8 @@ void WiFiManagerESP32::handleSaveLichessToken(AsyncWebServerRequest* request) {
     return;
   }
 
-  // Save to NVS
-  if (!ChessUtils::ensureNvsInitialized()) {
-    request->send(500, "text/plain", "NVS init failed");
-    return;
-  }
-
-  prefs.begin("lichess", false);
-  prefs.putString("token", newToken);
-  prefs.end();
+  // Commit happens on the settings task, off this async TCP handler
+  SettingsCache::setLichessToken(newToken);
 
   lichessToken = newToken;
   Serial.println("Lichess API token saved to NVS");
@@ -303,13 +427,30 @@ void WiFiManagerESP32::handleSaveLichessToken(AsyncWebServerRequest* request) {
   request->send(200, "text/plain", "OK");
 }
 
-String WiFiManagerESP32::getBoardSettingsJSON() {
+// Hot-path latency stats (perf_stats.h). ?dump=1 also prints the table to
+// serial; ?reset=1 zeroes the counters after this report.
+void WiFiManagerESP32::getPerfStatsJSON(AsyncWebServerRequest* request) {
+  JsonDocument doc;
+  PerfStats::fillJSON(doc);
+  SysDiag::fillJSON(doc); // Heap/fragmentation/task health alongside latency
+  MoveHistory::fillFlashStatsJSON(doc); // Flash byte counters + wear estimate
+  BootProfile::fillJSON(doc); // Startup phase breakdown from RTC memory
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  serializeJson(doc, *response);
+  request->send(response);
+  if (request->hasArg("dump"))
+    PerfStats::dump();
+  if (request->hasArg("reset"))
+    PerfStats::reset();
+}
+
+void WiFiManagerESP32::getBoardSettingsJSON(AsyncWebServerRequest* request) {
   JsonDocument doc;
   doc["brightness"] = boardDriver->getBrightness();
   doc["dimMultiplier"] = boardDriver->getDimMultiplier();
-  String output;
-  serializeJson(doc, output);
-  return output;
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  serializeJson(doc, *response);
+  request->send(response);
 }
 
 void WiFiManagerESP32::handleBoardSettings(AsyncWebServerRequest* request) {
@@ -407,9 +548,10 @@ LichessConfig WiFiManagerESP32::getLichessConfig() {
   return config;
 }
 
-void WiFiManagerESP32::updateBoardState(const String& fen, float evaluation) {
+void WiFiManagerESP32::updateBoardState(const char* fen, float evaluation) {
   currentFen = fen;
   boardEvaluation = evaluation;
+  pushBoardUpdate();
 }
 
 bool WiFiManagerESP32::getPendingBoardEdit(String& fenOut) {
@@ -446,6 +588,23 @@ void WiFiManagerESP32::clearPendingDraw() {
   hasPendingDraw = false;
 }
 
+void WiFiManagerESP32::updateLichessGames(const String& gamesJson) {
+  lichessGamesJSON = gamesJson;
+}
+
+bool WiFiManagerESP32::getPendingLichessSwitch(String& gameIdOut) {
+  if (hasPendingLichessSwitch) {
+    gameIdOut = pendingLichessSwitchId;
+    return true;
+  }
+  return false;
+}
+
+void WiFiManagerESP32::clearPendingLichessSwitch() {
+  hasPendingLichessSwitch = false;
+  pendingLichessSwitchId = "";
+}
+
 void WiFiManagerESP32::handlePromotion(AsyncWebServerRequest* request) {
   if (!promotion.pending) {
     request->send(400, "text/plain", "No promotion pending");
@@ -471,17 +630,32 @@ void WiFiManagerESP32::startPromotionWait(char color) {
   promotion.choice = ' ';
   promotion.pending = true;
   Serial.printf("Promotion wait started for %s\n", color == 'w' ? "White" : "Black");
+  pushBoardUpdate();
 }
 
 void WiFiManagerESP32::clearPromotion() {
   promotion.reset();
+  pushBoardUpdate();
 }
 
 bool WiFiManagerESP32::isWebClientConnected() const {
-  // Consider web client connected if it polled within the last 2 seconds
+  // A live WebSocket client counts, as does a /board-update poll (or WS
+  // ping) within the last 2 seconds
+  if (ws.count() > 0)
+    return true;
   return lastBoardPollTime > 0 && (millis() - lastBoardPollTime < 2000);
 }
 
+void WiFiManagerESP32::update() {
+  // Drop WebSocket clients that vanished without a close frame so textAll
+  // doesn't keep queueing onto dead connections
+  unsigned long now = millis();
+  if (now - lastWsCleanup >= 1000) {
+    lastWsCleanup = now;
+    ws.cleanupClients();
+  }
+}
+
 void WiFiManagerESP32::checkPendingWiFi() {
   if (!hasPendingWiFi)
     return;
@@ -489,18 +663,98 @@ void WiFiManagerESP32::checkPendingWiFi() {
   String newSSID = pendingWiFiSSID;
   String newPass = pendingWiFiPassword;
   if (connectToWiFi(newSSID, newPass, true)) {
-    if (!ChessUtils::ensureNvsInitialized())
-      Serial.println("NVS init failed - WiFi credentials not saved");
-    prefs.begin("wifiCreds", false);
-    prefs.putString("ssid", newSSID);
-    prefs.putString("pass", newPass);
-    prefs.end();
+    SettingsCache::setWifiCreds(newSSID, newPass);
     wifiSSID = newSSID;
     wifiPassword = newPass;
     Serial.println("WiFi credentials updated and saved to NVS");
   }
 }
 
+// ---------------------------
+// DNS cache for API endpoints
+// ---------------------------
+// On congested 2.4 GHz a DNS lookup adds hundreds of milliseconds to
+// every connect and occasionally times out, failing the whole request.
+// The known API hosts are resolved once and cached with a TTL; a
+// low-priority task re-resolves them in the background, which also keeps
+// lwIP's resolver table warm so connect-by-hostname (needed for TLS SNI)
+// is answered from RAM. The cached address doubles as a direct-connect
+// fallback when a live lookup fails mid-game.
+
+struct DnsCacheEntry {
+  const char* host;
+  IPAddress ip;
+  unsigned long resolvedAt;
+  bool valid;
+};
+
+#define DNS_CACHE_TTL_MS 600000UL // 10 minutes
+
+static DnsCacheEntry dnsCache[] = {
+    {STOCKFISH_API_URL, IPAddress(), 0, false},
+    {LICHESS_API_HOST, IPAddress(), 0, false},
+};
+
+bool WiFiManagerESP32::resolveHost(const char* host, IPAddress& ip) {
+  for (auto& entry : dnsCache) {
+    if (strcmp(entry.host, host) != 0)
+      continue;
+    if (entry.valid && millis() - entry.resolvedAt < DNS_CACHE_TTL_MS) {
+      ip = entry.ip;
+      return true;
+    }
+    if (WiFi.hostByName(host, entry.ip) == 1) {
+      entry.resolvedAt = millis();
+      entry.valid = true;
+      ip = entry.ip;
+      return true;
+    }
+    if (entry.valid) {
+      // DNS is down right now — a stale address beats no address
+      ip = entry.ip;
+      return true;
+    }
+    return false;
+  }
+  return WiFi.hostByName(host, ip) == 1; // Host we don't cache
+}
+
+bool WiFiManagerESP32::connectWithDnsCache(WiFiClientSecure& client, const char* host, uint16_t port) {
+  // Warm the cache so the lookup inside connect() is served locally
+  IPAddress ip;
+  bool haveIp = resolveHost(host, ip);
+  // Connect by name — the TLS layer needs the hostname for SNI
+  if (client.connect(host, port))
+    return true;
+  // Name connect failed (often a DNS hiccup) — try the cached address
+  // directly. No SNI that way, but a tolerant server beats a failed move.
+  return haveIp && client.connect(ip, port);
+}
+
+void WiFiManagerESP32::startDnsRefreshTask() {
+  static bool started = false;
+  if (started)
+    return;
+  started = true;
+  xTaskCreatePinnedToCore(
+      [](void*) {
+        for (;;) {
+          if (WiFi.status() == WL_CONNECTED) {
+            for (auto& entry : dnsCache) {
+              IPAddress ip;
+              if (WiFi.hostByName(entry.host, ip) == 1) {
+                entry.ip = ip;
+                entry.resolvedAt = millis();
+                entry.valid = true;
+              }
+            }
+          }
+          vTaskDelay(pdMS_TO_TICKS(DNS_CACHE_TTL_MS / 2));
+        }
+      },
+      "dns_refresh", 4096, nullptr, 1, nullptr, CORE_APP);
+}
+
 bool WiFiManagerESP32::connectToWiFi(const String& ssid, const String& password, bool fromWeb) {
   if (!fromWeb && WiFi.status() == WL_CONNECTED) {
     Serial.println("Already connected to WiFi");
@@ -509,25 +763,67 @@ bool WiFiManagerESP32::connectToWiFi(const String& ssid, const String& password,
   Serial.println("=== Connecting to WiFi Network" + String(fromWeb ? "(from web)" : "") + " ===");
   Serial.printf("SSID: %s\nPassword: %s\n", ssid.c_str(), password.c_str());
 
+  // Any kept-alive API socket is dead once the interface reassociates
+  StockfishAPI::closeConnection();
+  LichessAPI::closeConnection();
+
   // ESP32 can run both AP and Station modes simultaneously
   WiFi.mode(WIFI_AP_STA);
-  if (scanAllChannels) {
-    WiFi.setScanMethod(WIFI_ALL_CHANNEL_SCAN);
-    WiFi.setSortMethod(WIFI_CONNECT_AP_BY_SIGNAL);
-  }
-  WiFi.begin(ssid.c_str(), password.c_str());
-
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-    boardDriver->showConnectingAnimation();
-    attempts++;
-    Serial.printf("Connection attempt %d/10 - Status: %d\n", attempts, WiFi.status());
-    // Give the WiFi stack time to make progress between attempts
-    delay(500);
+
+  // Fast path first: a directed connect to the last good BSSID/channel
+  // skips scanning entirely. The full multi-channel scan costs ~10
+  // seconds; after an AP blip the board should rejoin a live game in a
+  // couple of seconds, not sit out of it for 15.
+  {
+    LastApNV lastAp = SettingsCache::getLastAp();
+
+    if (lastAp.valid && lastAp.channel > 0 && lastAp.ssid == ssid) {
+      Serial.printf("Fast reconnect: trying saved AP on channel %d...\n", lastAp.channel);
+      WiFi.begin(ssid.c_str(), password.c_str(), lastAp.channel, lastAp.bssid);
+      int fastAttempts = 0;
+      while (WiFi.status() != WL_CONNECTED && fastAttempts < 4) {
+        boardDriver->showConnectingAnimation();
+        fastAttempts++;
+        delay(500);
+      }
+      if (WiFi.status() != WL_CONNECTED) {
+        // AP moved channels, rebooted, or a stronger sibling took over —
+        // clear the attempt and fall back to the full scan below
+        Serial.println("Fast reconnect failed, falling back to full scan");
+        WiFi.disconnect();
+        delay(100);
+      }
+    }
+  }
+
+  if (WiFi.status() != WL_CONNECTED) {
+    if (scanAllChannels) {
+      WiFi.setScanMethod(WIFI_ALL_CHANNEL_SCAN);
+      WiFi.setSortMethod(WIFI_CONNECT_AP_BY_SIGNAL);
+    }
+    WiFi.begin(ssid.c_str(), password.c_str());
+
+    int attempts = 0;
+    while (WiFi.status() != WL_CONNECTED && attempts < 10) {
+      boardDriver->showConnectingAnimation();
+      attempts++;
+      Serial.printf("Connection attempt %d/10 - Status: %d\n", attempts, WiFi.status());
+      // Give the WiFi stack time to make progress between attempts
+      delay(500);
+    }
   }
 
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("Connected to WiFi!");
+    // Remember this AP so the next connect can go straight to it
+    {
+      LastApNV lastAp = SettingsCache::getLastAp();
+      if (!lastAp.valid || memcmp(lastAp.bssid, WiFi.BSSID(), 6) != 0 || lastAp.channel != WiFi.channel() || lastAp.ssid != ssid) {
+        SettingsCache::setLastAp(WiFi.BSSID(), WiFi.channel(), ssid);
+        Serial.printf("Saved AP for fast reconnect (channel %d)\n", WiFi.channel());
+      }
+    }
+    startDnsRefreshTask();
     return true;
   } else {
     Serial.println("Failed to connect to WiFi");
@@ -535,6 +831,333 @@ bool WiFiManagerESP32::connectToWiFi(const String& ssid, const String& password,
   }
 }
 
+// ========== PGN Export ==========
+
+namespace {
+
+// Carries decode progress across chunked-response callbacks so a game is
+// never materialized in RAM: entries are read from flash and decoded in
+// small batches as the TCP window drains. The position is replayed in step
+// with the entry stream (one board + engine, updated per move) so each move
+// can be rendered as the SAN the PGN spec requires — still O(1) memory
+// regardless of game length.
+struct PgnStreamState {
+  File file;
+  GameHeader hdr;
+  uint32_t entryIdx = 0;   // Next 2-byte entry to decode
+  uint32_t moveNumber = 1; // PGN fullmove number
+  bool whiteToMove = true;
+  bool tagsEmitted = false;
+  bool resultEmitted = false;
+  char board[8][8]; // Position before the next entry to decode
+  ChessEngine engine;
+  String startFen = INITIAL_FEN; // FEN entry 0; non-standard starts get SetUp/FEN tags
+  bool movetextStarted = false;  // First token of a black-to-move start needs "N..."
+  String pending;                // Generated text not yet handed to the TCP stack
+  size_t pendingPos = 0;
+
+  PgnStreamState() {
+    seedFromFen(INITIAL_FEN);
+  }
+
+  void seedFromFen(const char* fen) {
+    startFen = fen;
+    char turn;
+    ChessUtils::fenToBoard(fen, board, turn, &engine);
+    whiteToMove = (turn == 'w');
+    moveNumber = (uint32_t)engine.getFullmoveClock();
+  }
+};
+
+String pgnResultString(const GameHeader& hdr) {
+  switch (hdr.result) {
+    case RESULT_CHECKMATE:
+    case RESULT_RESIGNATION:
+      return hdr.winnerColor == 'w' ? "1-0" : "0-1";
+    case RESULT_IN_PROGRESS:
+      return "*";
+    default:
+      return "1/2-1/2"; // All draw variants
+  }
+}
+
+// Build the tag pair section from the header
+void pgnEmitTags(PgnStreamState& st, int id) {
+  String date = "????.??.??";
+  if (st.hdr.timestamp > 0) {
+    time_t t = st.hdr.timestamp;
+    struct tm tmInfo;
+    gmtime_r(&t, &tmInfo);
+    char dateBuf[11];
+    snprintf(dateBuf, sizeof(dateBuf), "%04d.%02d.%02d", tmInfo.tm_year + 1900, tmInfo.tm_mon + 1, tmInfo.tm_mday);
+    date = dateBuf;
+  }
+
+  String white = "?";
+  String black = "?";
+  if (st.hdr.mode == GAME_MODE_BOT) {
+    String bot = "OpenChessMate (depth " + String(st.hdr.botDepth) + ")";
+    if (st.hdr.playerColor == 'b') {
+      white = bot;
+      black = "Player";
+    } else {
+      white = "Player";
+      black = bot;
+    }
+  }
+
+  st.pending = "[Event \"OpenChessMate game " + String(id) + "\"]\n";
+  st.pending += "[Site \"OpenChessMate\"]\n";
+  st.pending += "[Date \"" + date + "\"]\n";
+  st.pending += "[Round \"-\"]\n";
+  st.pending += "[White \"" + white + "\"]\n";
+  st.pending += "[Black \"" + black + "\"]\n";
+  st.pending += "[Result \"" + pgnResultString(st.hdr) + "\"]\n";
+  // Games started from an edited position need SetUp/FEN or importers
+  // would replay the movetext against the standard start
+  if (st.startFen != INITIAL_FEN) {
+    st.pending += "[SetUp \"1\"]\n";
+    st.pending += "[FEN \"" + st.startFen + "\"]\n";
+  }
+  st.pending += "\n";
+}
+
+// ChessGame::updateCastlingRightsAfterMove isn't reachable from here (it's a
+// non-static member and a full ChessGame drags in board hardware), so the
+// rights rule is restated against the replay engine
+void pgnUpdateCastlingRights(ChessEngine& engine, char piece, int fromRow, int fromCol, int toRow, int toCol, char captured) {
+  uint8_t rights = engine.getCastlingRights();
+  if (piece == 'K') rights &= ~(0x01 | 0x02);
+  if (piece == 'k') rights &= ~(0x04 | 0x08);
+  if ((piece == 'R' && fromRow == 7) || (captured == 'R' && toRow == 7)) {
+    int col = (piece == 'R') ? fromCol : toCol;
+    if (col == 7) rights &= ~0x01;
+    if (col == 0) rights &= ~0x02;
+  }
+  if ((piece == 'r' && fromRow == 0) || (captured == 'r' && toRow == 0)) {
+    int col = (piece == 'r') ? fromCol : toCol;
+    if (col == 7) rights &= ~0x04;
+    if (col == 0) rights &= ~0x08;
+  }
+  engine.setCastlingRights(rights);
+}
+
+// Advance the replayed position by one move, keeping the engine's castling
+// and en-passant state in step (both feed the legal-move list SAN
+// disambiguation depends on)
+void pgnApplyMove(PgnStreamState& st, int fromRow, int fromCol, int toRow, int toCol, char promotion) {
+  char piece = st.board[fromRow][fromCol];
+  char captured = st.board[toRow][toCol];
+
+  if (ChessUtils::isEnPassantMove(fromRow, fromCol, toRow, toCol, piece, captured)) {
+    int capRow = ChessUtils::getEnPassantCapturedPawnRow(toRow, piece);
+    captured = st.board[capRow][toCol];
+    st.board[capRow][toCol] = ' ';
+  }
+
+  if ((piece == 'P' || piece == 'p') && (fromRow - toRow == 2 || toRow - fromRow == 2))
+    st.engine.setEnPassantTarget((fromRow + toRow) / 2, fromCol);
+  else
+    st.engine.clearEnPassantTarget();
+
+  st.board[toRow][toCol] = piece;
+  st.board[fromRow][fromCol] = ' ';
+
+  if (ChessUtils::isCastlingMove(fromRow, fromCol, toRow, toCol, piece)) {
+    int rookFromCol = (toCol > fromCol) ? 7 : 0;
+    int rookToCol = (toCol > fromCol) ? 5 : 3;
+    st.board[toRow][rookToCol] = (piece == 'k') ? 'r' : 'R';
+    st.board[toRow][rookFromCol] = ' ';
+  }
+
+  pgnUpdateCastlingRights(st.engine, piece, fromRow, fromCol, toRow, toCol, captured);
+
+  if (st.engine.isPawnPromotion(piece, toRow)) {
+    // Same queen fallback as the SAN renderer, so board and movetext agree
+    // even on a legacy entry recorded without a promotion code
+    char promo = (promotion != ' ') ? promotion : 'q';
+    st.board[toRow][toCol] = (piece == 'P') ? (char)toupper(promo) : (char)tolower(promo);
+  }
+}
+
+// Render the move as SAN against the position BEFORE it is played, then
+// advance the position and append the check/checkmate suffix
+String pgnMoveToSAN(PgnStreamState& st, int fromRow, int fromCol, int toRow, int toCol, char promotion) {
+  char piece = st.board[fromRow][fromCol];
+  char mover = ChessUtils::getPieceColor(piece);
+  String san;
+
+  if (ChessUtils::isCastlingMove(fromRow, fromCol, toRow, toCol, piece)) {
+    san = (toCol > fromCol) ? "O-O" : "O-O-O";
+  } else if (piece == 'P' || piece == 'p') {
+    // Pawn captures (including en passant) carry the origin file
+    if (fromCol != toCol) {
+      san += (char)('a' + fromCol);
+      san += 'x';
+    }
+    san += (char)('a' + toCol);
+    san += (char)('8' - toRow);
+    if (st.engine.isPawnPromotion(piece, toRow)) {
+      san += '=';
+      san += (char)toupper(promotion != ' ' ? promotion : 'q');
+    }
+  } else {
+    san += (char)toupper(piece);
+    // Disambiguate when another piece of the same type can also legally
+    // reach the target square: file if that settles it, else rank, else both
+    MoveList legal;
+    st.engine.getAllLegalMoves(st.board, mover, legal);
+    bool ambiguous = false, fileClash = false, rankClash = false;
+    for (int i = 0; i < legal.count; i++) {
+      const EngineMove& m = legal.moves[i];
+      if (m.toRow != toRow || m.toCol != toCol) continue;
+      if (m.fromRow == fromRow && m.fromCol == fromCol) continue;
+      if (st.board[m.fromRow][m.fromCol] != piece) continue;
+      ambiguous = true;
+      if (m.fromCol == fromCol) fileClash = true;
+      if (m.fromRow == fromRow) rankClash = true;
+    }
+    if (ambiguous) {
+      if (!fileClash) {
+        san += (char)('a' + fromCol);
+      } else if (!rankClash) {
+        san += (char)('8' - fromRow);
+      } else {
+        san += (char)('a' + fromCol);
+        san += (char)('8' - fromRow);
+      }
+    }
+    if (st.board[toRow][toCol] != ' ') san += 'x';
+    san += (char)('a' + toCol);
+    san += (char)('8' - toRow);
+  }
+
+  pgnApplyMove(st, fromRow, fromCol, toRow, toCol, promotion);
+
+  char opponent = (mover == 'w') ? 'b' : 'w';
+  if (st.engine.isKingInCheck(st.board, opponent))
+    san += st.engine.isCheckmate(st.board, opponent) ? '#' : '+';
+  return san;
+}
+
+// Decode the next batch of entries into movetext; may produce nothing when a
+// batch is all FEN markers, so the caller loops until text appears or the
+// entry stream is exhausted
+void pgnEmitMoves(PgnStreamState& st) {
+  const uint32_t BATCH = 32;
+  uint16_t entries[BATCH];
+  st.file.seek(sizeof(GameHeader) + (size_t)st.entryIdx * 2);
+  uint32_t want = min(BATCH, (uint32_t)st.hdr.moveCount - st.entryIdx);
+  uint32_t got = st.file.read((uint8_t*)entries, want * 2) / 2;
+  if (got == 0) {
+    st.entryIdx = st.hdr.moveCount; // Truncated file — stop decoding
+    return;
+  }
+
+  for (uint32_t i = 0; i < got; i++) {
+    st.entryIdx++;
+    if (entries[i] == MoveHistory::FEN_MARKER) {
+      // The first marker is the start position, already seeded into the
+      // replay board. Any later marker is a mid-game board edit, which PGN
+      // movetext cannot express — truncate there instead of rendering the
+      // remaining moves against the wrong position.
+      if (st.entryIdx > 1) {
+        st.entryIdx = st.hdr.moveCount;
+        return;
+      }
+      continue;
+    }
+
+    int fromRow, fromCol, toRow, toCol;
+    char promotion;
+    MoveHistory::decodeMove(entries[i], fromRow, fromCol, toRow, toCol, promotion);
+    if (st.whiteToMove) {
+      st.pending += String(st.moveNumber) + ". ";
+    } else if (!st.movetextStarted) {
+      // Black to move in the start FEN: continuation-style first token
+      st.pending += String(st.moveNumber) + "... ";
+    }
+    st.movetextStarted = true;
+    st.pending += pgnMoveToSAN(st, fromRow, fromCol, toRow, toCol, promotion);
+    if (!st.whiteToMove) {
+      st.moveNumber++;
+      // Wrap the movetext periodically so lines stay import-friendly
+      st.pending += (st.moveNumber % 8 == 1) ? '\n' : ' ';
+    } else {
+      st.pending += ' ';
+    }
+    st.whiteToMove = !st.whiteToMove;
+  }
+}
+
+} // namespace
+
+void WiFiManagerESP32::handleGamePgnRequest(AsyncWebServerRequest* request) {
+  if (!request->hasArg("id")) {
+    request->send(400, "text/plain", "Missing id parameter");
+    return;
+  }
+
+  int id = request->arg("id").toInt();
+  if (id <= 0) {
+    request->send(400, "text/plain", "Invalid game id");
+    return;
+  }
+
+  String path = MoveHistory::gamePath(id);
+  if (!MoveHistory::quietExists(path.c_str())) {
+    request->send(404, "text/plain", "Game not found");
+    return;
+  }
+
+  auto st = std::make_shared<PgnStreamState>();
+  st->file = LittleFS.open(path, "r");
+  if (!st->file || st->file.size() < sizeof(GameHeader)) {
+    request->send(500, "text/plain", "Corrupt game file");
+    return;
+  }
+  st->file.read((uint8_t*)&st->hdr, sizeof(GameHeader));
+
+  // Reseed the replay from the recorded start position (FEN entry 0, right
+  // after the move entries). A length byte past FEN_MAX_LEN means a tag or
+  // corrupt table — keep the standard-start default in that case.
+  if (st->hdr.fenEntryCnt > 0) {
+    st->file.seek(sizeof(GameHeader) + (size_t)st->hdr.moveCount * 2);
+    uint8_t fenLen = 0;
+    char fen[ChessUtils::FEN_MAX_LEN];
+    if (st->file.read(&fenLen, 1) == 1 && fenLen > 0 && fenLen < sizeof(fen) &&
+        st->file.read((uint8_t*)fen, fenLen) == fenLen) {
+      fen[fenLen] = '\0';
+      st->seedFromFen(fen);
+    }
+  }
+
+  // The shared state lives as long as the response holds this lambda
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/x-chess-pgn", [st, id](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+    while (st->pendingPos >= (size_t)st->pending.length()) {
+      st->pending = "";
+      st->pendingPos = 0;
+      if (!st->tagsEmitted) {
+        pgnEmitTags(*st, id);
+        st->tagsEmitted = true;
+      } else if (st->entryIdx < st->hdr.moveCount) {
+        pgnEmitMoves(*st);
+      } else if (!st->resultEmitted) {
+        st->pending = pgnResultString(st->hdr) + "\n";
+        st->resultEmitted = true;
+      } else {
+        return 0; // Ends the chunked response
+      }
+    }
+    size_t n = min(maxLen, (size_t)st->pending.length() - st->pendingPos);
+    memcpy(buffer, st->pending.c_str() + st->pendingPos, n);
+    st->pendingPos += n;
+    return n;
+  });
+  response->addHeader("Content-Disposition", "attachment; filename=game" + String(id) + ".pgn");
+  request->send(response);
+}
+
 void WiFiManagerESP32::handleGamesRequest(AsyncWebServerRequest* request) {
   if (request->hasArg("id")) {
     String idStr = request->arg("id");
@@ -578,7 +1201,11 @@ void WiFiManagerESP32::handleGamesRequest(AsyncWebServerRequest* request) {
     request->send(response);
   } else {
     // GET /games — return JSON list of all saved games
-    request->send(200, "application/json", moveHistory->getGameListJSON());
+    JsonDocument doc;
+    moveHistory->fillGameListJSON(doc);
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    serializeJson(doc, *response);
+    request->send(response);
   }
 }
 
@@ -622,12 +1249,7 @@ void WiFiManagerESP32::handleOtaStatus(AsyncWebServerRequest* request) {
 void WiFiManagerESP32::handleOtaSettings(AsyncWebServerRequest* request) {
   if (request->hasArg("autoUpdate")) {
     autoOtaEnabled = request->arg("autoUpdate") == "1";
-    if (ChessUtils::ensureNvsInitialized()) {
-      Preferences p;
-      p.begin("ota", false);
-      p.putBool("autoUpdate", autoOtaEnabled);
-      p.end();
-    }
+    SettingsCache::setAutoOta(autoOtaEnabled);
     Serial.printf("OTA: Auto-update %s\n", autoOtaEnabled ? "enabled" : "disabled");
     request->send(200, "text/plain", "OK");
   } else {
@@ -654,7 +1276,7 @@ void WiFiManagerESP32::handleOtaApply(AsyncWebServerRequest* request) {
   auto* params = new OtaApplyParams{lastUpdateInfo, &otaUpdater};
   lastUpdateInfo.available = false; // Prevent concurrent apply requests
 
-  xTaskCreate(
+  xTaskCreatePinnedToCore(
       [](void* param) {
         auto* p = static_cast<OtaApplyParams*>(param);
         delay(500); // Give time for the HTTP response to be sent
@@ -662,7 +1284,7 @@ void WiFiManagerESP32::handleOtaApply(AsyncWebServerRequest* request) {
         delete p;
         vTaskDelete(NULL);
       },
-      "ota_apply", 8192, params, 1, NULL);
+      "ota_apply", 8192, params, 1, NULL, CORE_APP);
 }
 
 void WiFiManagerESP32::onFirmwareUploadBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
@@ -731,10 +1353,12 @@ void WiFiManagerESP32::onWebAssetsUploadBody(AsyncWebServerRequest* request, uin
         bool success = otaUpdater.applyWebAssetsFromStream(tarFile, tarSize);
         tarFile.close();
         LittleFS.remove("/ota_temp.tar");
-        if (success)
+        if (success) {
+          loadAssetCache(); // The RAM copies are stale now
           request->send(200, "text/plain", "Web assets updated successfully!");
-        else
+        } else {
           request->send(500, "text/plain", "Web assets update failed");
+        }
       } else {
         request->send(500, "text/plain", "Failed to read temp file");
       }
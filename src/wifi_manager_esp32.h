@@ -5,15 +5,16 @@
 #include "ota_updater.h"
 #include "stockfish_settings.h"
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include <LittleFS.h>
-#include <Preferences.h>
 #include <WiFi.h>
 
 // Forward declarations
 struct LichessConfig;
 class MoveHistory;
+class WiFiClientSecure;
 
 // ---------------------------
 // WiFi Configuration
@@ -36,13 +37,23 @@ class WiFiManagerESP32 {
  private:
   AsyncWebServer server;
 
-  Preferences prefs;
+  // WebSocket push channel: connected /ws clients receive a board-state
+  // message only when the game actually changes, so server load scales with
+  // moves played instead of clients × poll rate. GET /board-update remains
+  // as the polling fallback.
+  AsyncWebSocket ws;
+  String lastPushedState;
+  unsigned long lastWsCleanup;
+  void fillBoardStateJSON(JsonDocument& doc);
+  String buildBoardStateJSON();
+  void pushBoardUpdate();
+
   String wifiSSID;
   String wifiPassword;
   String gameMode;
   String lichessToken;
 
-  BotConfig botConfig = {StockfishSettings::medium(), true};
+  BotConfig botConfig = {StockfishSettings::medium(), true, false};
   bool scanAllChannels;
 
   MoveHistory* moveHistory;
@@ -59,6 +70,12 @@ class WiFiManagerESP32 {
   volatile bool hasPendingDraw;
   char pendingResignColor; // 'w' or 'b' — the side resigning
 
+  // Lichess multi-game: games list pushed by ChessLichess, switch request
+  // from the web UI consumed by it
+  String lichessGamesJSON;
+  String pendingLichessSwitchId;
+  volatile bool hasPendingLichessSwitch;
+
   // Promotion state for web-based piece selection
   struct PromotionState {
     volatile bool pending; // True while waiting for web client to choose a piece
@@ -80,16 +97,19 @@ class WiFiManagerESP32 {
   String pendingWiFiPassword;
   volatile bool hasPendingWiFi;
 
-  // Web interface methods
-  String getWiFiInfoJSON();
-  String getBoardUpdateJSON();
+  // Web interface methods (JSON GETs serialize straight into the response
+  // stream, never buffering the payload in a String)
+  void getWiFiInfoJSON(AsyncWebServerRequest* request);
+  void getBoardUpdateJSON(AsyncWebServerRequest* request);
   String getLichessInfoJSON();
-  String getBoardSettingsJSON();
+  void getPerfStatsJSON(AsyncWebServerRequest* request);
+  void getBoardSettingsJSON(AsyncWebServerRequest* request);
   void handleBoardEditSuccess(AsyncWebServerRequest* request);
   void handlePromotion(AsyncWebServerRequest* request);
   void handleConnectWiFi(AsyncWebServerRequest* request);
   void handleGameSelection(AsyncWebServerRequest* request);
   void handleSaveLichessToken(AsyncWebServerRequest* request);
+  void handleLichessSwitch(AsyncWebServerRequest* request);
   void handleBoardSettings(AsyncWebServerRequest* request);
   void handleBoardCalibration(AsyncWebServerRequest* request);
   void handleResign(AsyncWebServerRequest* request);
@@ -97,6 +117,7 @@ class WiFiManagerESP32 {
   void getHardwareConfigJSON(AsyncWebServerRequest* request);
   void handleHardwareConfig(AsyncWebServerRequest* request);
   void handleGamesRequest(AsyncWebServerRequest* request);
+  void handleGamePgnRequest(AsyncWebServerRequest* request);
   void handleDeleteGame(AsyncWebServerRequest* request);
   // OTA update handlers
   void handleOtaStatus(AsyncWebServerRequest* request);
@@ -121,6 +142,12 @@ class WiFiManagerESP32 {
   WiFiManagerESP32(BoardDriver* boardDriver, MoveHistory* moveHistory);
   void begin();
 
+  // DNS cache for API endpoints (TTL'd, refreshed by a background task).
+  // Static so the API clients can use them without a manager pointer.
+  static bool resolveHost(const char* host, IPAddress& ip);
+  static bool connectWithDnsCache(WiFiClientSecure& client, const char* host, uint16_t port);
+  static void startDnsRefreshTask();
+
   // OTA update support
   OtaUpdater& getOtaUpdater() { return otaUpdater; }
   bool isAutoOtaEnabled() const { return autoOtaEnabled; }
@@ -137,7 +164,10 @@ class WiFiManagerESP32 {
   LichessConfig getLichessConfig();
   String getLichessToken() { return lichessToken; }
   // Board state management (FEN-based)
-  void updateBoardState(const String& fen, float evaluation = 0.0f);
+  // char* overload is the hot path: String assignment reuses currentFen's
+  // existing capacity instead of constructing a temporary per move
+  void updateBoardState(const char* fen, float evaluation = 0.0f);
+  void updateBoardState(const String& fen, float evaluation = 0.0f) { updateBoardState(fen.c_str(), evaluation); }
   String getCurrentFen() const { return currentFen; }
   float getEvaluation() const { return boardEvaluation; }
   // Board edit management (FEN-based)
@@ -148,6 +178,11 @@ class WiFiManagerESP32 {
   bool getPendingDraw();
   void clearPendingResign();
   void clearPendingDraw();
+  // Lichess multi-game: ChessLichess pushes the games list, the web UI
+  // requests switches through /lichess/switch
+  void updateLichessGames(const String& gamesJson);
+  bool getPendingLichessSwitch(String& gameIdOut);
+  void clearPendingLichessSwitch();
   // Promotion management (from web interface)
   void startPromotionWait(char color);
   bool isPromotionPending() const { return promotion.pending; }
@@ -159,6 +194,8 @@ class WiFiManagerESP32 {
   bool connectToWiFi(const String& ssid, const String& password, bool fromWeb = false);
   // Call from main loop to process deferred WiFi reconnection
   void checkPendingWiFi();
+  // Call from main loop: drops dead WebSocket clients periodically
+  void update();
 };
 
 #endif // WIFI_MANAGER_ESP32_H
@@ -0,0 +1,201 @@
+// Host-side opening book generator.
+//
+// Reads opening lines (one line of space-separated UCI moves per text line,
+// '#' starts a comment) and writes a Polyglot-format .bin book: 16-byte
+// big-endian entries (key, move, weight, learn), sorted by key. Keys are the
+// firmware's own Zobrist hashes — the file is NOT compatible with books made
+// by standard Polyglot tools, and castling is stored as the actual king move
+// (e1g1), not the Polyglot king-takes-rook encoding.
+//
+// Entry weight is the number of input lines passing through that
+// (position, move) pair, so mainstream moves outrank sidelines.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=gnu++17 -I src/perft_native/shim -I src \
+//       -o book_gen tools/book_gen/book_gen.cpp \
+//       src/chess_engine.cpp src/chess_utils.cpp src/bitboards.cpp
+//   ./book_gen tools/book_gen/openings.txt src/book/book.bin
+//
+// Every move is validated against ChessEngine before being recorded; a typo
+// in openings.txt fails the run instead of producing a corrupt book.
+
+#include <Arduino.h>
+#include "chess_engine.h"
+#include "chess_utils.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+SerialShim Serial;
+
+static const char INITIAL_BOARD[8][8] = {
+    {'r', 'n', 'b', 'q', 'k', 'b', 'n', 'r'},
+    {'p', 'p', 'p', 'p', 'p', 'p', 'p', 'p'},
+    {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '},
+    {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '},
+    {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '},
+    {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '},
+    {'P', 'P', 'P', 'P', 'P', 'P', 'P', 'P'},
+    {'R', 'N', 'B', 'Q', 'K', 'B', 'N', 'R'}};
+
+// Mirror of ChessGame::updateCastlingRightsAfterMove (the game-level rule
+// lives in chess_game.cpp, which doesn't compile on the host)
+static void updateCastlingRights(ChessEngine& engine, char piece, int fromRow, int fromCol, int toRow, int toCol, char captured) {
+  uint8_t rights = engine.getCastlingRights();
+  if (piece == 'K')
+    rights &= ~(0x01 | 0x02);
+  else if (piece == 'k')
+    rights &= ~(0x04 | 0x08);
+  if (piece == 'R') {
+    if (fromRow == 7 && fromCol == 7) rights &= ~0x01;
+    if (fromRow == 7 && fromCol == 0) rights &= ~0x02;
+  } else if (piece == 'r') {
+    if (fromRow == 0 && fromCol == 7) rights &= ~0x04;
+    if (fromRow == 0 && fromCol == 0) rights &= ~0x08;
+  }
+  if (captured == 'R') {
+    if (toRow == 7 && toCol == 7) rights &= ~0x01;
+    if (toRow == 7 && toCol == 0) rights &= ~0x02;
+  } else if (captured == 'r') {
+    if (toRow == 0 && toCol == 7) rights &= ~0x04;
+    if (toRow == 0 && toCol == 0) rights &= ~0x08;
+  }
+  engine.setCastlingRights(rights);
+}
+
+// Mirror of ChessGame::applyMove board/state mutations (no promotions needed
+// in opening lines, but handled for completeness)
+static void applyMove(ChessEngine& engine, char board[8][8], int fromRow, int fromCol, int toRow, int toCol, char promotion) {
+  char piece = board[fromRow][fromCol];
+  char captured = board[toRow][toCol];
+
+  bool isEnPassant = false;
+  int epRow, epCol;
+  engine.getEnPassantTarget(epRow, epCol);
+  if ((piece == 'P' || piece == 'p') && captured == ' ' && fromCol != toCol && toRow == epRow && toCol == epCol) {
+    isEnPassant = true;
+    int capRow = ChessUtils::getEnPassantCapturedPawnRow(toRow, piece);
+    captured = board[capRow][toCol];
+    board[capRow][toCol] = ' ';
+  }
+
+  if ((piece == 'P' || piece == 'p') && (fromRow - toRow == 2 || toRow - fromRow == 2))
+    engine.setEnPassantTarget((fromRow + toRow) / 2, fromCol);
+  else
+    engine.clearEnPassantTarget();
+
+  engine.updateHalfmoveClock(piece, captured);
+
+  board[toRow][toCol] = piece;
+  board[fromRow][fromCol] = ' ';
+
+  if ((piece == 'K' || piece == 'k') && (toCol - fromCol == 2 || toCol - fromCol == -2)) {
+    int rookFromCol = (toCol > fromCol) ? 7 : 0;
+    int rookToCol = (toCol > fromCol) ? 5 : 3;
+    char rookPiece = (piece == 'k') ? 'r' : 'R';
+    board[toRow][rookToCol] = rookPiece;
+    board[toRow][rookFromCol] = ' ';
+  }
+
+  updateCastlingRights(engine, piece, fromRow, fromCol, toRow, toCol, isEnPassant ? ' ' : captured);
+
+  if (engine.isPawnPromotion(piece, toRow) && promotion != ' ')
+    board[toRow][toCol] = (piece == 'P') ? (char)toupper(promotion) : (char)tolower(promotion);
+}
+
+// Polyglot move encoding: to-file | to-rank<<3 | from-file<<6 | from-rank<<9
+// | promotion<<12 (rank 0 = rank 1, i.e. row 7)
+static uint16_t encodeMove(int fromRow, int fromCol, int toRow, int toCol, char promotion) {
+  uint16_t move = (uint16_t)(toCol | ((7 - toRow) << 3) | (fromCol << 6) | ((7 - fromRow) << 9));
+  switch (tolower(promotion)) {
+    case 'n': move |= 1 << 12; break;
+    case 'b': move |= 2 << 12; break;
+    case 'r': move |= 3 << 12; break;
+    case 'q': move |= 4 << 12; break;
+  }
+  return move;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <openings.txt> <book.bin>\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream in(argv[1]);
+  if (!in) {
+    fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  // key -> (encoded move -> weight)
+  std::map<uint64_t, std::map<uint16_t, uint16_t>> book;
+
+  std::string line;
+  int lineNo = 0, lineCount = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos)
+      line.erase(hash);
+    std::istringstream tokens(line);
+    std::string uci;
+    if (!(tokens >> uci))
+      continue; // Blank/comment line
+    tokens.clear();
+    tokens.seekg(0);
+
+    ChessEngine engine;
+    engine.reset();
+    char board[8][8];
+    memcpy(board, INITIAL_BOARD, sizeof(board));
+    char turn = 'w';
+
+    while (tokens >> uci) {
+      int fromRow, fromCol, toRow, toCol;
+      char promotion;
+      if (!ChessUtils::parseUCIMove(String(uci.c_str()), fromRow, fromCol, toRow, toCol, promotion)) {
+        fprintf(stderr, "line %d: bad UCI move '%s'\n", lineNo, uci.c_str());
+        return 1;
+      }
+      char piece = board[fromRow][fromCol];
+      if (piece == ' ' || ChessUtils::getPieceColor(piece) != turn || !engine.isValidMove(board, fromRow, fromCol, toRow, toCol)) {
+        fprintf(stderr, "line %d: illegal move '%s' for %c\n", lineNo, uci.c_str(), turn);
+        return 1;
+      }
+
+      uint64_t key = engine.computeZobristHash(board, turn);
+      book[key][encodeMove(fromRow, fromCol, toRow, toCol, promotion)]++;
+
+      applyMove(engine, board, fromRow, fromCol, toRow, toCol, promotion);
+      turn = (turn == 'w') ? 'b' : 'w';
+    }
+    lineCount++;
+  }
+
+  std::ofstream out(argv[2], std::ios::binary);
+  if (!out) {
+    fprintf(stderr, "cannot write %s\n", argv[2]);
+    return 1;
+  }
+  size_t entries = 0;
+  for (const auto& pos : book) {
+    for (const auto& mv : pos.second) {
+      uint8_t e[16] = {0};
+      for (int i = 0; i < 8; i++)
+        e[i] = (uint8_t)(pos.first >> (56 - 8 * i));
+      e[8] = (uint8_t)(mv.first >> 8);
+      e[9] = (uint8_t)mv.first;
+      e[10] = (uint8_t)(mv.second >> 8);
+      e[11] = (uint8_t)mv.second;
+      out.write((const char*)e, sizeof(e));
+      entries++;
+    }
+  }
+
+  printf("book_gen: %d lines -> %zu positions, %zu entries (%zu bytes)\n", lineCount, book.size(), entries, entries * 16);
+  return 0;
+}
@@ -0,0 +1,194 @@
+// Host-side delta firmware patch generator.
+//
+// Diffs two firmware images and writes an "OCDP" patch that
+// OtaUpdater::applyFirmwarePatchFromUrl rebuilds on the board: a 16-byte
+// header (magic, source size, source CRC32, target size) followed by a
+// stream of ops,
+//   0x01 COPY <uint32 srcOffset> <uint32 length>  — bytes from the old image
+//   0x02 ADD  <uint32 length> <length bytes>      — literal bytes
+// with all integers little-endian. Matching is greedy over 16-byte seeds
+// hashed at every offset of the old image, so a typical point release — a
+// few changed functions in an otherwise identical image — collapses to a
+// handful of ADD runs between large COPYs.
+//
+// Build and run from the repository root:
+//   g++ -O2 -std=gnu++17 -o ota_patch_gen tools/ota_patch_gen/ota_patch_gen.cpp
+//   ./ota_patch_gen old_firmware.bin new_firmware.bin firmware-<oldversion>.patch
+//
+// The release workflow names the patch after the version it was built FROM
+// (the version a board must be running for checkForUpdate to pick it up).
+// Before writing anything the tool re-applies the patch in memory and
+// compares the result byte-for-byte with the new image; a generator bug
+// fails the run instead of bricking an OTA slot.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Same reflected CRC32 (poly 0xEDB88320) the updater uses to verify the
+// running partition against the patch header
+static uint32_t crc32Buf(const std::vector<uint8_t>& data) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (uint8_t byte : data) {
+    crc ^= byte;
+    for (int b = 0; b < 8; b++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & -(crc & 1));
+  }
+  return ~crc;
+}
+
+static const size_t SEED_LEN = 16;  // Match seed hashed at every old-image offset
+static const size_t MIN_COPY = 24;  // A COPY op costs 9 bytes; shorter matches ship as literals
+static const size_t MAX_CHAIN = 64; // Candidate offsets tried per seed hash
+
+static const uint8_t PATCH_OP_COPY = 0x01;
+static const uint8_t PATCH_OP_ADD = 0x02;
+
+static uint64_t seedHash(const uint8_t* p) {
+  // FNV-1a over the seed window
+  uint64_t h = 1469598103934665603ULL;
+  for (size_t i = 0; i < SEED_LEN; i++)
+    h = (h ^ p[i]) * 1099511628211ULL;
+  return h;
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v) {
+  out.push_back((uint8_t)(v & 0xFF));
+  out.push_back((uint8_t)((v >> 8) & 0xFF));
+  out.push_back((uint8_t)((v >> 16) & 0xFF));
+  out.push_back((uint8_t)((v >> 24) & 0xFF));
+}
+
+static void flushLiterals(std::vector<uint8_t>& out, std::vector<uint8_t>& lits) {
+  if (lits.empty()) return;
+  out.push_back(PATCH_OP_ADD);
+  putU32(out, (uint32_t)lits.size());
+  out.insert(out.end(), lits.begin(), lits.end());
+  lits.clear();
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  return true;
+}
+
+// Replay the op stream against src the way the updater does, so the patch is
+// proven to rebuild dst before it leaves this tool
+static bool applyOps(const std::vector<uint8_t>& ops, const std::vector<uint8_t>& src, std::vector<uint8_t>& rebuilt) {
+  size_t pos = 0;
+  auto getU32 = [&](uint32_t& v) {
+    if (pos + 4 > ops.size()) return false;
+    v = (uint32_t)ops[pos] | ((uint32_t)ops[pos + 1] << 8) |
+        ((uint32_t)ops[pos + 2] << 16) | ((uint32_t)ops[pos + 3] << 24);
+    pos += 4;
+    return true;
+  };
+  while (pos < ops.size()) {
+    uint8_t op = ops[pos++];
+    uint32_t a, len;
+    if (op == PATCH_OP_COPY) {
+      if (!getU32(a) || !getU32(len) || a + len > src.size()) return false;
+      rebuilt.insert(rebuilt.end(), src.begin() + a, src.begin() + a + len);
+    } else if (op == PATCH_OP_ADD) {
+      if (!getU32(len) || pos + len > ops.size()) return false;
+      rebuilt.insert(rebuilt.end(), ops.begin() + pos, ops.begin() + pos + len);
+      pos += len;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    fprintf(stderr, "Usage: %s <old_firmware.bin> <new_firmware.bin> <out.patch>\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<uint8_t> src, dst;
+  if (!readFile(argv[1], src)) {
+    fprintf(stderr, "Cannot read %s\n", argv[1]);
+    return 1;
+  }
+  if (!readFile(argv[2], dst)) {
+    fprintf(stderr, "Cannot read %s\n", argv[2]);
+    return 1;
+  }
+
+  // Index every seed-sized window of the old image
+  std::unordered_map<uint64_t, std::vector<uint32_t>> seeds;
+  if (src.size() >= SEED_LEN) {
+    seeds.reserve(src.size());
+    for (size_t off = 0; off + SEED_LEN <= src.size(); off++) {
+      std::vector<uint32_t>& chain = seeds[seedHash(&src[off])];
+      if (chain.size() < MAX_CHAIN) chain.push_back((uint32_t)off);
+    }
+  }
+
+  std::vector<uint8_t> ops;
+  std::vector<uint8_t> literals;
+  size_t pos = 0;
+  while (pos < dst.size()) {
+    size_t bestLen = 0;
+    size_t bestSrc = 0;
+    if (pos + SEED_LEN <= dst.size()) {
+      auto it = seeds.find(seedHash(&dst[pos]));
+      if (it != seeds.end()) {
+        for (uint32_t cand : it->second) {
+          size_t len = 0;
+          size_t maxLen = std::min(src.size() - cand, dst.size() - pos);
+          while (len < maxLen && src[cand + len] == dst[pos + len]) len++;
+          if (len > bestLen) {
+            bestLen = len;
+            bestSrc = cand;
+          }
+        }
+      }
+    }
+    if (bestLen >= MIN_COPY) {
+      flushLiterals(ops, literals);
+      ops.push_back(PATCH_OP_COPY);
+      putU32(ops, (uint32_t)bestSrc);
+      putU32(ops, (uint32_t)bestLen);
+      pos += bestLen;
+    } else {
+      literals.push_back(dst[pos++]);
+    }
+  }
+  flushLiterals(ops, literals);
+
+  std::vector<uint8_t> rebuilt;
+  rebuilt.reserve(dst.size());
+  if (!applyOps(ops, src, rebuilt) || rebuilt != dst) {
+    fprintf(stderr, "Self-check failed: patch does not rebuild the new image\n");
+    return 1;
+  }
+
+  std::vector<uint8_t> patch;
+  patch.reserve(16 + ops.size());
+  patch.push_back('O');
+  patch.push_back('C');
+  patch.push_back('D');
+  patch.push_back('P');
+  putU32(patch, (uint32_t)src.size());
+  putU32(patch, crc32Buf(src));
+  putU32(patch, (uint32_t)dst.size());
+  patch.insert(patch.end(), ops.begin(), ops.end());
+
+  std::ofstream out(argv[3], std::ios::binary);
+  if (!out || !out.write((const char*)patch.data(), patch.size())) {
+    fprintf(stderr, "Cannot write %s\n", argv[3]);
+    return 1;
+  }
+
+  printf("Patch: %zu bytes (full image %zu bytes, %.1f%%)\n",
+         patch.size(), dst.size(), 100.0 * patch.size() / dst.size());
+  return 0;
+}
@@ -8,6 +8,8 @@
 #include <SDL2/SDL.h>
 #include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <lvgl.h>
@@ -18,6 +20,7 @@
 #include <sys/socket.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 // Use generated C-format font from ui_slave project
 extern "C" {
@@ -103,12 +106,144 @@ static void platformSend(const char* msg) {
   std::cout << "TX: " << msg;
 }
 
+// ---------------------------------------------------------------------------
+// Benchmark mode (--bench)
+// ---------------------------------------------------------------------------
+// Drives scripted sequences through chess_ui_handle_message and reports
+// per-refresh render statistics from LVGL's display monitor callback, so
+// rendering changes (e.g. incremental square updates) can be quantified on
+// the host before flashing. Runs headless via SDL's dummy video driver:
+//
+//   ui_slave_lvgl --bench [max-px-per-refresh]
+//
+// With a pixel budget given, exits non-zero when the steady-state move
+// phase flushes more pixels per refresh than the budget — usable as a CI
+// regression gate.
+
+struct BenchStats {
+  uint64_t refreshes = 0;
+  uint64_t px = 0;
+  uint64_t ms = 0;
+  uint64_t max_px = 0;
+  uint32_t max_ms = 0;
+};
+static BenchStats g_bench;
+
+static void bench_monitor_cb(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px) {
+  (void)drv;
+  g_bench.refreshes++;
+  g_bench.px += px;
+  g_bench.ms += time_ms;
+  if (px > g_bench.max_px) g_bench.max_px = px;
+  if (time_ms > g_bench.max_ms) g_bench.max_ms = time_ms;
+}
+
+// Advance LVGL time and let pending refreshes (and timers) run
+static void bench_pump(int ms) {
+  for (int t = 0; t < ms; t += 5) {
+    lv_tick_inc(5);
+    lv_timer_handler();
+  }
+}
+
+struct BenchMark {
+  uint64_t r, p, m;
+};
+
+static BenchMark bench_begin() {
+  g_bench.max_px = 0;
+  g_bench.max_ms = 0;
+  return {g_bench.refreshes, g_bench.px, g_bench.ms};
+}
+
+static BenchStats bench_end(const char* name, const BenchMark& b) {
+  BenchStats d;
+  d.refreshes = g_bench.refreshes - b.r;
+  d.px = g_bench.px - b.p;
+  d.ms = g_bench.ms - b.m;
+  d.max_px = g_bench.max_px;
+  d.max_ms = g_bench.max_ms;
+  printf("%-22s %9llu %13llu %12llu %7.1f %7u\n", name,
+         (unsigned long long)d.refreshes, (unsigned long long)d.px,
+         (unsigned long long)(d.refreshes ? d.px / d.refreshes : 0),
+         d.refreshes ? (double)d.ms / d.refreshes : 0.0, d.max_ms);
+  return d;
+}
+
+static BenchStats bench_phase(const char* name, const std::vector<std::string>& msgs) {
+  BenchMark b = bench_begin();
+  for (const auto& m : msgs) {
+    chess_ui_handle_message(m.c_str());
+    bench_pump(40); // a few LVGL periods so the refresh lands
+  }
+  return bench_end(name, b);
+}
+
+static int run_benchmark(long px_budget) {
+  // Let the welcome screen's first full paint settle before measuring
+  bench_pump(200);
+
+  std::vector<std::string> switches = {
+      "MODE|value=1", "MODE|value=0", "MODE|value=2", "MODE|value=0", "MODE|value=1"};
+
+  // Scholar's mate — every update changes two to four squares
+  std::vector<std::string> opening = {
+      "STATE|fen=rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR;move=e2e4",
+      "STATE|fen=rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR;move=e7e5",
+      "STATE|fen=rnbqkbnr/pppp1ppp/8/4p2Q/4P3/8/PPPP1PPP/RNB1KBNR;move=d1h5",
+      "STATE|fen=r1bqkbnr/pppp1ppp/2n5/4p2Q/4P3/8/PPPP1PPP/RNB1KBNR;move=b8c6",
+      "STATE|fen=r1bqkbnr/pppp1ppp/2n5/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR;move=f1c4",
+      "STATE|fen=r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR;move=g8f6",
+      "STATE|fen=r1bqkb1r/pppp1Qpp/2n2n2/4p3/2B1P3/8/PPPP1PPP/RNB1K1NR;move=h5f7"};
+
+  // Knight shuffle: the long steady-state tail a real game settles into
+  std::vector<std::string> shuffle;
+  for (int i = 0; i < 20; i++) {
+    shuffle.push_back("STATE|fen=r1bqkbnr/pppp1ppp/2n5/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR;move=f6g8");
+    shuffle.push_back("STATE|fen=r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR;move=g8f6");
+  }
+
+  std::vector<std::string> hint = {"HINT|move=e2e4"};
+
+  printf("phase                  refreshes    px flushed   px/refresh  avg ms  max ms\n");
+  bench_phase("screen switches", switches);
+  bench_phase("opening moves", opening);
+  BenchStats moves = bench_phase("steady-state moves", shuffle);
+
+  // Clock redraws with no board traffic: 5 simulated seconds
+  BenchMark clk = bench_begin();
+  bench_pump(5000);
+  bench_end("clock ticks (5 s)", clk);
+
+  bench_phase("hint overlay", hint);
+
+  if (px_budget > 0 && moves.refreshes > 0) {
+    uint64_t per = moves.px / moves.refreshes;
+    if (per > (uint64_t)px_budget) {
+      printf("FAIL: steady-state %llu px/refresh exceeds budget %ld\n",
+             (unsigned long long)per, px_budget);
+      return 1;
+    }
+    printf("OK: steady-state %llu px/refresh within budget %ld\n",
+           (unsigned long long)per, px_budget);
+  }
+  return 0;
+}
+
 // ---------------------------------------------------------------------------
 // main
 // ---------------------------------------------------------------------------
 int main(int argc, char** argv) {
-  (void)argc;
-  (void)argv;
+  bool bench = false;
+  long bench_budget = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+      if (i + 1 < argc) bench_budget = atol(argv[i + 1]);
+    }
+  }
+  if (bench)
+    setenv("SDL_VIDEODRIVER", "dummy", 1); // headless — no window needed
 
   if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
     std::cerr << "SDL_Init fail: " << SDL_GetError() << "\n";
@@ -174,6 +309,8 @@ int main(int argc, char** argv) {
                       sw * (int)sizeof(lv_color_t));
     lv_disp_flush_ready(drv);
   };
+  if (bench)
+    disp_drv.monitor_cb = bench_monitor_cb; // per-refresh time + pixel stats
   lv_disp_drv_register(&disp_drv);
   std::cout << "LVGL display registered (" << screen_w << "x" << screen_h
             << ")\n";
@@ -195,6 +332,17 @@ int main(int argc, char** argv) {
   // ---- Create shared chess UI ----
   chess_ui_create(screen_w, screen_h, &lv_font_montserrat_14, platformSend);
 
+  // ---- Benchmark mode: run the script, report, exit ----
+  if (bench) {
+    int rc = run_benchmark(bench_budget);
+    free(buf);
+    SDL_DestroyTexture(g_texture);
+    SDL_DestroyRenderer(g_renderer);
+    SDL_DestroyWindow(g_window);
+    SDL_Quit();
+    return rc;
+  }
+
   // ---- TCP server ----
   std::thread tcp_thread(tcp_server_thread);
 
@@ -6,6 +6,7 @@
  */
 #include "chess_ui.h"
 #include "pieces/pieces.h"
+#include "ui_protocol.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -523,8 +524,93 @@ static const lv_img_dsc_t* fen_char_to_img(char ch) {
   }
 }
 
+// ---------------------------------------------------------------------------
+// Pre-scaled piece sprite cache
+// ---------------------------------------------------------------------------
+// The source sprites are 30×30 but a board cell is whatever the layout math
+// produces, so blitting with lv_img_set_zoom ran LVGL's software transform
+// over identical pixels on every repaint. Each of the 12 piece types is
+// scaled once per cell size instead (plus a 180°-rotated set of the black
+// pieces for HvH) and drawn 1:1 afterwards. Rebuilt only when the cell size
+// changes; on allocation failure the zoom path takes over.
+
+#define PIECE_CACHE_ENTRIES 12
+
+static const lv_img_dsc_t* PIECE_SRCS[PIECE_CACHE_ENTRIES] = {
+    &wK, &wQ, &wR, &wB, &wN, &wP, &bK, &bQ, &bR, &bB, &bN, &bP};
+static lv_img_dsc_t s_piece_cache[PIECE_CACHE_ENTRIES];
+static lv_img_dsc_t s_piece_cache_rot[PIECE_CACHE_ENTRIES]; // black pieces only
+static int s_piece_cache_size = 0; // cell size the cache was built for
+
+static int fen_char_to_index(char ch) {
+  const char* order = "KQRBNPkqrbnp";
+  const char* p = strchr(order, ch);
+  return (p && ch) ? (int)(p - order) : -1;
+}
+
+// Nearest-neighbor scale (optionally rotated 180°) into a fresh buffer
+static bool scale_piece(const lv_img_dsc_t* src, lv_img_dsc_t* dst, int size, bool rotate180) {
+  const int px = sizeof(lv_color_t) + 1; // true color + alpha byte
+  int sw = src->header.w, sh = src->header.h;
+  uint8_t* data = (uint8_t*)malloc((size_t)size * size * px);
+  if (!data) return false;
+  for (int y = 0; y < size; y++) {
+    int sy = y * sh / size;
+    for (int x = 0; x < size; x++) {
+      int sx = x * sw / size;
+      const uint8_t* s = src->data + (size_t)(sy * sw + sx) * px;
+      uint8_t* d = rotate180 ? data + (size_t)((size - 1 - y) * size + (size - 1 - x)) * px
+                             : data + (size_t)(y * size + x) * px;
+      memcpy(d, s, px);
+    }
+  }
+  dst->header.always_zero = 0;
+  dst->header.cf = src->header.cf;
+  dst->header.w = size;
+  dst->header.h = size;
+  dst->data_size = (uint32_t)((size_t)size * size * px);
+  dst->data = data;
+  return true;
+}
+
+static void free_piece_cache(void) {
+  for (int i = 0; i < PIECE_CACHE_ENTRIES; i++) {
+    free((void*)s_piece_cache[i].data);
+    free((void*)s_piece_cache_rot[i].data);
+    s_piece_cache[i].data = nullptr;
+    s_piece_cache_rot[i].data = nullptr;
+  }
+  s_piece_cache_size = 0;
+}
+
+static void build_piece_cache(int cell_size) {
+  if (cell_size <= 0 || s_piece_cache_size == cell_size) return;
+  free_piece_cache();
+  for (int i = 0; i < PIECE_CACHE_ENTRIES; i++) {
+    bool ok = scale_piece(PIECE_SRCS[i], &s_piece_cache[i], cell_size, false);
+    // Only black pieces ever render rotated (HvH)
+    if (ok && i >= 6)
+      ok = scale_piece(PIECE_SRCS[i], &s_piece_cache_rot[i], cell_size, true);
+    if (!ok) {
+      free_piece_cache();
+      return;
+    }
+  }
+  s_piece_cache_size = cell_size;
+}
+
+// Board model as currently drawn: piece chars, 0 = empty. Incoming positions
+// are diffed against it so a move only touches its two-to-four squares —
+// lv_img_set_src / lv_obj_add_flag invalidate just that widget's rect, so
+// LVGL repaints a couple of squares instead of flickering the whole board.
+static char s_rendered[8][8];
+static int s_rendered_mode = -1; // piece rotation depends on the mode
+
 void chess_ui_render_fen(const char* fen) {
   if (!fen) return;
+
+  char board[8][8];
+  memset(board, 0, sizeof(board));
   int r = 0, c = 0;
   for (const char* p = fen; *p && r < 8; p++) {
     char ch = *p;
@@ -534,29 +620,47 @@ void chess_ui_render_fen(const char* fen) {
       continue;
     }
     if (ch == ' ') break; // end of board part
-    if (ch >= '1' && ch <= '8') {
-      int empties = ch - '0';
-      for (int e = 0; e < empties && c < 8; e++) {
-        lv_obj_add_flag(s_labels[r][c], LV_OBJ_FLAG_HIDDEN);
-        c++;
-      }
-    } else {
-      const lv_img_dsc_t* img = fen_char_to_img(ch);
+    if (ch >= '1' && ch <= '8')
+      c += ch - '0';
+    else if (c < 8)
+      board[r][c++] = ch;
+  }
+
+  // A mode switch changes piece rotation, so it forces a full repaint
+  bool force = (s_rendered_mode != s_current_mode);
+  int changed = 0;
+  for (r = 0; r < 8; r++) {
+    for (c = 0; c < 8; c++) {
+      char ch = board[r][c];
+      if (!force && ch == s_rendered[r][c]) continue;
+      const lv_img_dsc_t* img = ch ? fen_char_to_img(ch) : nullptr;
       if (img) {
-        lv_img_set_src(s_labels[r][c], img);
-        lv_img_set_zoom(s_labels[r][c], s_piece_zoom);
-        // In HvH mode, rotate black pieces 180° so they face the black player
+        // In HvH mode, black pieces face the black player (180° rotation)
         bool is_black_piece = (ch >= 'a' && ch <= 'z');
-        int angle = (s_current_mode == 1 && is_black_piece) ? 1800 : 0;
-        lv_img_set_angle(s_labels[r][c], angle);
+        bool rotate = (s_current_mode == 1 && is_black_piece);
+        int idx = fen_char_to_index(ch);
+        if (s_piece_cache_size > 0 && idx >= 0) {
+          // Pre-scaled sprite: blits 1:1 with no per-repaint transform
+          lv_img_set_src(s_labels[r][c], rotate ? &s_piece_cache_rot[idx] : &s_piece_cache[idx]);
+          lv_img_set_zoom(s_labels[r][c], 256);
+          lv_img_set_angle(s_labels[r][c], 0);
+        } else {
+          lv_img_set_src(s_labels[r][c], img);
+          lv_img_set_zoom(s_labels[r][c], s_piece_zoom);
+          lv_img_set_angle(s_labels[r][c], rotate ? 1800 : 0);
+        }
         lv_obj_clear_flag(s_labels[r][c], LV_OBJ_FLAG_HIDDEN);
       } else {
         lv_obj_add_flag(s_labels[r][c], LV_OBJ_FLAG_HIDDEN);
       }
-      c++;
+      s_rendered[r][c] = ch;
+      changed++;
     }
   }
-  updateCapturedPieces(fen);
+  s_rendered_mode = s_current_mode;
+
+  // Captured-piece bars only move when material moves, i.e. a square changed
+  if (changed > 0) updateCapturedPieces(fen);
 }
 
 // ---------------------------------------------------------------------------
@@ -577,6 +681,110 @@ static bool parseUci(const char* uci, int* fr, int* fc, int* tr, int* tc) {
   return true;
 }
 
+// ---------------------------------------------------------------------------
+// Binary protocol (ui_protocol.h) — square cache and frame helpers
+// ---------------------------------------------------------------------------
+
+// Board rebuilt from STATE frames: piece chars, 0 = empty, row 0 = rank 8
+static char s_board_cache[8][8];
+
+// Encode and send a frame.  COBS output is zero-free and the delimiter is
+// the trailing 0x00, so the encoded frame passes through the C-string send
+// callback intact (the platform layer sends strlen + 1 bytes).
+static void send_frame(uint8_t type, const uint8_t* body, int len) {
+  uint8_t frame[UIP_MAX_ENCODED + 1];
+  uip_build_frame(type, body, (size_t)len, frame);
+  if (s_send_fn) s_send_fn((const char*)frame);
+}
+
+// The simulator's harness still speaks the legacy text protocol over TCP;
+// the real link uses binary frames.
+static void send_touch(uint8_t action, uint8_t a, uint8_t b) {
+#ifdef SIMULATOR
+  static const char* NAMES[] = {"board", "mode", "hint", "undo", "home", "new", "resign", "swap", "nextgame"};
+  char buf[64];
+  if (action == UIP_TOUCH_BOARD)
+    snprintf(buf, sizeof(buf), "TOUCH|action=board;row=%d;col=%d\n", a, b);
+  else if (action == UIP_TOUCH_MODE)
+    snprintf(buf, sizeof(buf), "TOUCH|action=mode;value=%d\n", a);
+  else
+    snprintf(buf, sizeof(buf), "TOUCH|action=%s;x=0;y=0\n", NAMES[action]);
+  if (s_send_fn) s_send_fn(buf);
+#else
+  uint8_t body[3] = {action, a, b};
+  send_frame(UIP_MSG_TOUCH, body, 3);
+#endif
+}
+
+// Rebuild the board-part FEN from the square cache and render it
+static void render_board_cache(void) {
+  char fen[80];
+  int n = 0;
+  for (int r = 0; r < 8; r++) {
+    int empty = 0;
+    for (int c = 0; c < 8; c++) {
+      char ch = s_board_cache[r][c];
+      if (!ch) {
+        empty++;
+        continue;
+      }
+      if (empty) fen[n++] = (char)('0' + empty);
+      empty = 0;
+      fen[n++] = ch;
+    }
+    if (empty) fen[n++] = (char)('0' + empty);
+    if (r < 7) fen[n++] = '/';
+  }
+  fen[n] = '\0';
+  chess_ui_render_fen(fen);
+}
+
+// Shared by the text and binary STATE paths: highlight the move, append it
+// to the history list, and drive the clock
+static void handle_state_move(int fr, int fc, int tr, int tc, const char* move_buf) {
+  chess_ui_set_move(fr, fc, tr, tc, move_buf);
+  // Track move in history (HvH)
+  if (s_move_count < MAX_MOVE_HISTORY) {
+    strncpy(s_move_list[s_move_count], move_buf, 7);
+    s_move_list[s_move_count][7] = '\0';
+    s_move_count++;
+    updateMoveList();
+  }
+  // Hide swap button after first move
+  if (s_swap_btn && s_move_count == 1 && s_current_mode == 1)
+    lv_obj_add_flag(s_swap_btn, LV_OBJ_FLAG_HIDDEN);
+  // Clock: start on first move, add increment, switch sides
+  if (!s_no_clock) {
+    if (!s_clock_started) {
+      s_clock_started = true;
+      s_clock_running = true;
+    } else if (s_clock_increment_sec > 0) {
+      // Add increment to the player who just moved
+      if (s_white_active)
+        s_white_time_sec += s_clock_increment_sec;
+      else
+        s_black_time_sec += s_clock_increment_sec;
+    }
+    s_white_active = !s_white_active;
+    updateClockDisplay();
+  }
+}
+
+// Decode the from/to/promo trailer of a STATE frame and apply it
+static void apply_move_meta(const uint8_t* m) {
+  if (m[0] >= 64 || m[1] >= 64) return; // UIP_SQ_NONE — nothing to show
+  int fr = m[0] / 8, fc = m[0] % 8, tr = m[1] / 8, tc = m[1] % 8;
+  char move_buf[8];
+  int n = 0;
+  move_buf[n++] = (char)('a' + fc);
+  move_buf[n++] = (char)('8' - fr);
+  move_buf[n++] = (char)('a' + tc);
+  move_buf[n++] = (char)('8' - tr);
+  if (m[2]) move_buf[n++] = (char)m[2];
+  move_buf[n] = '\0';
+  handle_state_move(fr, fc, tr, tc, move_buf);
+}
+
 void chess_ui_handle_message(const char* line) {
   if (!line) return;
 
@@ -612,34 +820,8 @@ void chess_ui_handle_message(const char* line) {
         strncpy(move_buf, move_start, move_len);
         move_buf[move_len] = '\0';
         int fr, fc, tr, tc;
-        if (parseUci(move_buf, &fr, &fc, &tr, &tc)) {
-          chess_ui_set_move(fr, fc, tr, tc, move_buf);
-          // Track move in history (HvH)
-          if (s_move_count < MAX_MOVE_HISTORY) {
-            strncpy(s_move_list[s_move_count], move_buf, 7);
-            s_move_list[s_move_count][7] = '\0';
-            s_move_count++;
-            updateMoveList();
-          }
-          // Hide swap button after first move
-          if (s_swap_btn && s_move_count == 1 && s_current_mode == 1)
-            lv_obj_add_flag(s_swap_btn, LV_OBJ_FLAG_HIDDEN);
-          // Clock: start on first move, add increment, switch sides
-          if (!s_no_clock) {
-            if (!s_clock_started) {
-              s_clock_started = true;
-              s_clock_running = true;
-            } else if (s_clock_increment_sec > 0) {
-              // Add increment to the player who just moved
-              if (s_white_active)
-                s_white_time_sec += s_clock_increment_sec;
-              else
-                s_black_time_sec += s_clock_increment_sec;
-            }
-            s_white_active = !s_white_active;
-            updateClockDisplay();
-          }
-        }
+        if (parseUci(move_buf, &fr, &fc, &tr, &tc))
+          handle_state_move(fr, fc, tr, tc, move_buf);
       }
     }
   } else if (type_len == 4 && strncmp(line, "HINT", 4) == 0) {
@@ -683,6 +865,61 @@ void chess_ui_handle_message(const char* line) {
   }
 }
 
+void chess_ui_request_resync(void) {
+  send_frame(UIP_MSG_RESYNC, nullptr, 0);
+}
+
+void chess_ui_handle_frame(const uint8_t* payload, int len) {
+  if (!payload || len < 1) return;
+
+  switch (payload[0]) {
+    case UIP_MSG_STATE_FULL: {
+      if (len < 1 + 64 + 3) return;
+      memcpy(s_board_cache, payload + 1, 64);
+      render_board_cache();
+      apply_move_meta(payload + 1 + 64);
+      break;
+    }
+    case UIP_MSG_STATE_DELTA: {
+      int n = (len >= 2) ? payload[1] : 0;
+      if (len < 2 + n * 2 + 3) {
+        // Truncated delta — the square cache can no longer be trusted
+        chess_ui_request_resync();
+        return;
+      }
+      const uint8_t* sq = payload + 2;
+      for (int i = 0; i < n; i++, sq += 2)
+        if (sq[0] < 64) s_board_cache[sq[0] / 8][sq[0] % 8] = (char)sq[1];
+      render_board_cache();
+      apply_move_meta(sq);
+      break;
+    }
+    case UIP_MSG_HINT: {
+      if (len < 3 || payload[1] >= 64 || payload[2] >= 64) return;
+      int fr = payload[1] / 8, fc = payload[1] % 8;
+      int tr = payload[2] / 8, tc = payload[2] % 8;
+      char hint_text[32];
+      snprintf(hint_text, sizeof(hint_text), "Hint: %c%c%c%c",
+               'a' + fc, '8' - fr, 'a' + tc, '8' - tr);
+      chess_ui_set_move(fr, fc, tr, tc, hint_text);
+      break;
+    }
+    case UIP_MSG_MODE: {
+      if (len < 2) return;
+      int mode = payload[1];
+      s_current_mode = mode;
+      if (mode == 0)
+        chess_ui_show_welcome();
+      else if (mode >= 1 && mode <= 4)
+        chess_ui_show_game(MODE_NAMES[mode]);
+      break;
+    }
+    case UIP_MSG_ERROR:
+      lv_label_set_text(s_status_label, "Error");
+      break;
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Cell click callback
 // ---------------------------------------------------------------------------
@@ -691,9 +928,7 @@ static void cell_event_cb(lv_event_t* e) {
   intptr_t id = (intptr_t)lv_event_get_user_data(e);
   int r = (id >> 8) & 0xFF;
   int c = id & 0xFF;
-  char buf[64];
-  snprintf(buf, sizeof(buf), "TOUCH|action=board;row=%d;col=%d\n", r, c);
-  if (s_send_fn) s_send_fn(buf);
+  send_touch(UIP_TOUCH_BOARD, (uint8_t)r, (uint8_t)c);
 }
 
 // ---------------------------------------------------------------------------
@@ -702,12 +937,12 @@ static void cell_event_cb(lv_event_t* e) {
 
 static void btn_hint_cb(lv_event_t* e) {
   (void)e;
-  if (s_send_fn) s_send_fn("TOUCH|action=hint;x=0;y=0\n");
+  send_touch(UIP_TOUCH_HINT, 0, 0);
   lv_label_set_text(s_status_label, "Requesting hint...");
 }
 static void btn_back_cb(lv_event_t* e) {
   (void)e;
-  if (s_send_fn) s_send_fn("TOUCH|action=undo;x=0;y=0\n");
+  send_touch(UIP_TOUCH_UNDO, 0, 0);
   lv_label_set_text(s_status_label, "Undo last move");
 }
 static void btn_new_cb(lv_event_t* e);
@@ -726,10 +961,10 @@ static void confirm_yes_cb(lv_event_t* e) {
     s_confirm_overlay = nullptr;
   }
   if (action == CONFIRM_HOME) {
-    if (s_send_fn) s_send_fn("TOUCH|action=home;x=0;y=0\n");
+    send_touch(UIP_TOUCH_HOME, 0, 0);
     chess_ui_show_welcome();
   } else if (action == CONFIRM_NEW) {
-    if (s_send_fn) s_send_fn("TOUCH|action=new;x=0;y=0\n");
+    send_touch(UIP_TOUCH_NEW, 0, 0);
     if (s_status_label) lv_label_set_text(s_status_label, "New game");
   }
 }
@@ -813,7 +1048,7 @@ static void btn_new_cb(lv_event_t* e) {
 }
 static void btn_resign_cb(lv_event_t* e) {
   (void)e;
-  if (s_send_fn) s_send_fn("TOUCH|action=resign;x=0;y=0\n");
+  send_touch(UIP_TOUCH_RESIGN, 0, 0);
   lv_label_set_text(s_status_label, "Resigned");
 }
 
@@ -881,13 +1116,13 @@ static void btn_home_cb(lv_event_t* e) {
 // Undo last move
 static void btn_undo_cb(lv_event_t* e) {
   (void)e;
-  if (s_send_fn) s_send_fn("TOUCH|action=undo;x=0;y=0\n");
+  send_touch(UIP_TOUCH_UNDO, 0, 0);
 }
 
 // Swap sides (HvH only, at game start)
 static void btn_swap_cb(lv_event_t* e) {
   (void)e;
-  if (s_send_fn) s_send_fn("TOUCH|action=swap;x=0;y=0\n");
+  send_touch(UIP_TOUCH_SWAP, 0, 0);
 }
 
 static void applyClockPreset(int time_sec, int increment_sec) {
@@ -1095,9 +1330,7 @@ void chess_ui_show_game(const char* mode_name) {
 static void mode_btn_cb(lv_event_t* e) {
   intptr_t mode = (intptr_t)lv_event_get_user_data(e);
   s_current_mode = (int)mode;
-  char buf[48];
-  snprintf(buf, sizeof(buf), "TOUCH|action=mode;value=%d\n", (int)mode);
-  if (s_send_fn) s_send_fn(buf);
+  send_touch(UIP_TOUCH_MODE, (uint8_t)mode, 0);
   // Switch to game screen right away
   const char* name = (mode >= 1 && mode <= 4) ? MODE_NAMES[mode] : "Game";
   chess_ui_show_game(name);
@@ -1749,7 +1982,9 @@ void chess_ui_create(int screen_w, int screen_h,
   int clock_panel_w = screen_w - board_side - board_x - 8;
 
   // Piece zoom: scale 30×30 source images to fill cell_size
+  // (fallback only — the pre-scaled sprite cache normally serves renders)
   s_piece_zoom = (uint16_t)(cell_size * 256 / PIECE_IMG_SIZE);
+  build_piece_cache(cell_size);
 
   int cap_bar_h = 26;  // captured pieces info bar height
   int cap_gap = 2;     // gap between captures bar and board
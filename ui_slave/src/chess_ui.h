@@ -1,5 +1,6 @@
 #pragma once
 #include <lvgl.h>
+#include <stdint.h>
 
 /*
  * Shared chess UI module — used by both the ESP32 target and the
@@ -7,10 +8,14 @@
  * board rendering, and message handling lives here.
  *
  * Platform-specific code (display driver, input driver, comms)
- * stays in each platform's main.cpp.
+ * stays in each platform's main.cpp.  The ESP32 link speaks the binary
+ * COBS-framed protocol (ui_protocol.h); the simulator keeps the legacy
+ * text protocol over TCP.
  */
 
-// Callback type for sending protocol messages to the master
+// Callback type for sending protocol messages to the master.  Binary
+// frames are zero-free with a terminating NUL as the frame delimiter, so
+// the ESP32 platform layer must transmit strlen(msg) + 1 bytes.
 typedef void (*chess_ui_send_fn_t)(const char* msg);
 
 /// Create the chess UI widgets on the current LVGL screen.
@@ -25,8 +30,17 @@ void chess_ui_create(int screen_w, int screen_h,
 
 /// Parse and handle an incoming protocol line (e.g., "STATE|fen=...",
 /// "HINT|move=e2e4", "MODE|value=1").  Accepts a plain C string.
+/// Used by the simulator; the ESP32 build uses chess_ui_handle_frame.
 void chess_ui_handle_message(const char* line);
 
+/// Handle a decoded binary protocol frame (ui_protocol.h): payload starts
+/// with the type byte, CRC already verified and stripped by the caller.
+void chess_ui_handle_frame(const uint8_t* payload, int len);
+
+/// Ask the master for a full-board STATE frame (after boot, or after the
+/// platform layer had to drop a corrupt frame).
+void chess_ui_request_resync(void);
+
 /// Render a FEN position string on the board (board part only, e.g.,
 /// "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR").
 void chess_ui_render_fen(const char* fen);
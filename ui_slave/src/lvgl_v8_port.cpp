@@ -62,15 +62,29 @@ static void flush_callback(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t
 
 #else /* LVGL_PORT_AVOID_TEARING_MODE == 0 */
 
-/* Standard partial-buffer flush */
+/*
+ * Partial-buffer flush, double buffered: drawBitmap only queues the DMA
+ * transfer, so we return without signalling flush-ready and LVGL starts
+ * rendering the next area into the other draw buffer immediately.  The
+ * ready signal comes from flush_done_callback when the panel reports the
+ * transfer finished.
+ */
+static bool flush_done_callback(void* user_data) {
+  /* Runs in the LCD driver's transfer-done interrupt — flush_ready only
+     flips a flag in the driver, which is safe from ISR context */
+  lv_disp_flush_ready((lv_disp_drv_t*)user_data);
+  return false; /* no higher-priority task woken */
+}
+
 static void flush_callback(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p) {
+  (void)drv;
   const int x_start = area->x1;
   const int y_start = area->y1;
   const int width = area->x2 - area->x1 + 1;
   const int height = area->y2 - area->y1 + 1;
 
   _lcd->drawBitmap(x_start, y_start, width, height, (const uint8_t*)color_p);
-  lv_disp_flush_ready(drv);
+  /* flush_done_callback signals LVGL once the DMA transfer completes */
 }
 
 #endif /* LVGL_PORT_AVOID_TEARING_MODE */
@@ -194,6 +208,12 @@ void lvgl_port_init(ESP_PanelLcd* lcd, ESP_PanelTouch* touch) {
 #endif
   lv_disp_drv_register(&disp_drv);
 
+#if LVGL_PORT_AVOID_TEARING_MODE == 0
+  /* Signal flush-ready from the panel's transfer-done interrupt so LVGL
+     renders into the second buffer while DMA drains the first */
+  _lcd->attachRefreshFinishCallback(flush_done_callback, &disp_drv);
+#endif
+
   /* --- Touch input driver --- */
   if (_touch) {
     static lv_indev_drv_t indev_drv;
@@ -15,18 +15,47 @@
 
 #include "chess_ui.h"
 #include "lvgl_v8_port.h"
+#include "ui_protocol.h"
 #include <Arduino.h>
 #include <ESP_Panel_Library.h>
 #include <lvgl.h>
 
 // ---------------------------------------------------------------------------
-// Serial protocol — line-buffered reader
+// Serial protocol — COBS frame reader (ui_protocol.h)
 // ---------------------------------------------------------------------------
-static String s_rx_buf;
+static uint8_t s_rx_frame[UIP_MAX_ENCODED];
+static size_t s_rx_len = 0;
 
-/// Send a protocol message to the master board via Serial (UART0).
+/// Send a protocol frame to the master board via Serial (UART0).  Encoded
+/// frames are zero-free C strings whose terminating NUL doubles as the
+/// frame delimiter, so transmit strlen + 1 bytes.
 static void platformSend(const char* msg) {
-  Serial.print(msg);
+  Serial.write((const uint8_t*)msg, strlen(msg) + 1);
+}
+
+/// Runs on the UART event task whenever received bytes are pending:
+/// accumulate 0x00-delimited COBS frames and hand complete ones to the UI
+static void onSerialRx() {
+  while (Serial.available()) {
+    uint8_t b = (uint8_t)Serial.read();
+    if (b == 0) {
+      if (s_rx_len > 0) {
+        uint8_t payload[UIP_MAX_ENCODED];
+        size_t n = uip_parse_frame(s_rx_frame, s_rx_len, payload);
+        s_rx_len = 0;
+        lvgl_port_lock(0);
+        if (n > 0)
+          chess_ui_handle_frame(payload, (int)n);
+        else
+          chess_ui_request_resync(); // CRC failure — don't show a stale board
+        lvgl_port_unlock();
+      }
+    } else if (s_rx_len < sizeof(s_rx_frame)) {
+      s_rx_frame[s_rx_len++] = b;
+    } else {
+      s_rx_len = 0; // Oversized garbage — resync on the next delimiter
+    }
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -34,8 +63,10 @@ static void platformSend(const char* msg) {
 // ---------------------------------------------------------------------------
 
 void setup() {
-  // UART0 on IO43(TX) / IO44(RX) — shared between CH340C USB-C and UART header
-  Serial.begin(115200);
+  // UART0 on IO43(TX) / IO44(RX) — shared between CH340C USB-C and UART header.
+  // 921600 matches the master's UIComm link (set your serial monitor to match).
+  Serial.setRxBufferSize(1024);
+  Serial.begin(921600);
   delay(200);
   Serial.println("UI Slave (VIEWE 4.3\") starting...");
 
@@ -54,26 +85,19 @@ void setup() {
   chess_ui_create(480, 800, &lv_font_montserrat_14, platformSend);
   lvgl_port_unlock();
 
+  // Event-driven RX: the UART interrupt fills the driver's ring buffer and
+  // the serial event task calls onSerialRx — frames render within one LVGL
+  // tick of arriving instead of waiting on this loop
+  Serial.onReceive(onSerialRx);
+
   Serial.println("UI ready");
+
+  // Ask the master for the current board in case we rebooted mid-game
+  chess_ui_request_resync();
 }
 
 void loop() {
-  // Poll serial for newline-terminated messages from the master
-  while (Serial.available()) {
-    char c = (char)Serial.read();
-    if (c == '\r') continue;
-    if (c == '\n') {
-      if (s_rx_buf.length() > 0) {
-        lvgl_port_lock(0);
-        chess_ui_handle_message(s_rx_buf.c_str());
-        lvgl_port_unlock();
-        s_rx_buf = "";
-      }
-    } else {
-      s_rx_buf += c;
-      if (s_rx_buf.length() > 1024)
-        s_rx_buf = s_rx_buf.substring(s_rx_buf.length() - 1024);
-    }
-  }
-  delay(5);
+  // All protocol handling is event-driven (onSerialRx); LVGL runs on its
+  // own task via lvgl_v8_port — nothing left to poll here
+  delay(100);
 }
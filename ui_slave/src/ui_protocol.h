@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * ui_protocol.h — Binary UART protocol between the master board and the
+ * UI slave display.
+ *
+ * !!! Two identical copies exist (src/ui_protocol.h and
+ * !!! ui_slave/src/ui_protocol.h) because master and slave are separate
+ * !!! PlatformIO projects. Keep them in sync.
+ *
+ * Framing: each message is COBS-encoded and terminated with a single 0x00
+ * byte, so the receiver resynchronizes on the next delimiter after line
+ * noise instead of silently corrupting a text line. The encoded stream
+ * contains no zero bytes, which also lets frames pass through C-string
+ * plumbing (the terminating NUL doubles as the frame delimiter).
+ *
+ * Before encoding, a message is:
+ *
+ *     [type:1][body...][crc16:2 little-endian]
+ *
+ * with a CRC-16/CCITT (poly 0x1021, init 0xFFFF) over type + body.
+ * Corrupt frames fail the CRC and are dropped; the slave then requests a
+ * full-board resync rather than showing a stale position.
+ *
+ * Board squares are indexed row*8 + col with row 0 = rank 8 (the same
+ * layout as the master's board[8][8]). Piece bytes are FEN characters,
+ * 0 = empty square.
+ */
+
+// Message types: master → slave
+#define UIP_MSG_STATE_FULL 0x01  // body: 64 board bytes, from, to, promo
+#define UIP_MSG_STATE_DELTA 0x02 // body: n, n × {square, piece}, from, to, promo
+#define UIP_MSG_HINT 0x03        // body: from, to
+#define UIP_MSG_MODE 0x04        // body: mode (0 = welcome screen)
+#define UIP_MSG_ERROR 0x05       // body: code (UIP_ERR_*)
+// Message types: slave → master
+#define UIP_MSG_TOUCH 0x10  // body: action (UIP_TOUCH_*), a, b
+#define UIP_MSG_RESYNC 0x11 // empty body — request a STATE_FULL
+
+// from/to square value when there is no move to show
+#define UIP_SQ_NONE 0xFF
+
+#define UIP_ERR_NO_FEN 1
+#define UIP_ERR_ENGINE 2
+
+#define UIP_TOUCH_BOARD 0 // a = row, b = col
+#define UIP_TOUCH_MODE 1  // a = selected mode
+#define UIP_TOUCH_HINT 2
+#define UIP_TOUCH_UNDO 3
+#define UIP_TOUCH_HOME 4
+#define UIP_TOUCH_NEW 5
+#define UIP_TOUCH_RESIGN 6
+#define UIP_TOUCH_SWAP 7
+#define UIP_TOUCH_NEXT_GAME 8 // Lichess: rotate the board to the next ongoing game
+
+// Largest unencoded message: STATE_FULL (1 type + 64 board + 3 move + 2 CRC)
+#define UIP_MAX_PAYLOAD 80
+// COBS adds one byte per 254 payload bytes plus the leading code byte
+#define UIP_MAX_ENCODED (UIP_MAX_PAYLOAD + UIP_MAX_PAYLOAD / 254 + 2)
+
+static inline uint16_t uip_crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+// COBS-encode len bytes of in into out (needs room for len + len/254 + 1).
+// Returns the encoded length; the 0x00 frame delimiter is NOT appended.
+static inline size_t uip_cobs_encode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t outPos = 1, codePos = 0;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      out[codePos] = code;
+      codePos = outPos++;
+      code = 1;
+    } else {
+      out[outPos++] = in[i];
+      if (++code == 0xFF) {
+        out[codePos] = code;
+        codePos = outPos++;
+        code = 1;
+      }
+    }
+  }
+  out[codePos] = code;
+  return outPos;
+}
+
+// Decode a COBS frame (without its 0x00 delimiter). Returns the decoded
+// length, or 0 if the frame is malformed.
+static inline size_t uip_cobs_decode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t inPos = 0, outPos = 0;
+  while (inPos < len) {
+    uint8_t code = in[inPos++];
+    if (code == 0 || inPos + (size_t)(code - 1) > len) return 0;
+    for (uint8_t i = 1; i < code; i++) out[outPos++] = in[inPos++];
+    if (code != 0xFF && inPos < len) out[outPos++] = 0;
+  }
+  return outPos;
+}
+
+// Build a complete frame (COBS + CRC + 0x00 delimiter) from type + body.
+// out must hold UIP_MAX_ENCODED + 1 bytes. Returns the frame length.
+static inline size_t uip_build_frame(uint8_t type, const uint8_t* body, size_t bodyLen, uint8_t* out) {
+  uint8_t payload[UIP_MAX_PAYLOAD];
+  payload[0] = type;
+  if (bodyLen) memcpy(payload + 1, body, bodyLen);
+  uint16_t crc = uip_crc16(payload, bodyLen + 1);
+  payload[bodyLen + 1] = (uint8_t)(crc & 0xFF);
+  payload[bodyLen + 2] = (uint8_t)(crc >> 8);
+  size_t n = uip_cobs_encode(payload, bodyLen + 3, out);
+  out[n++] = 0;
+  return n;
+}
+
+// Decode and CRC-check a received frame (delimiter already stripped). On
+// success returns the payload length (≥ 1, type byte first) written to out;
+// returns 0 on a corrupt frame. out must hold UIP_MAX_ENCODED bytes.
+static inline size_t uip_parse_frame(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t n = uip_cobs_decode(in, len, out);
+  if (n < 3) return 0;
+  uint16_t crc = (uint16_t)(out[n - 2] | ((uint16_t)out[n - 1] << 8));
+  if (crc != uip_crc16(out, n - 2)) return 0;
+  return n - 2;
+}